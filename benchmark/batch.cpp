@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+// Row-at-a-time Evaluator over std::vector<Key> records vs BatchEvaluator over
+// the same data laid out as columns. Items/sec is rows/sec in both cases.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "bytes",
+               static_cast<int64_t>(1024))),
+         SE(UE(ComparisonOperations::LESS_THAN, "latency_ms", 250.0),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::NOT_EQUAL, "user_id",
+               static_cast<int64_t>(7)),
+            LogicalOperations::AND)}};
+  }
+
+  struct Columns {
+    std::vector<int64_t> user_id, bytes;
+    std::vector<double> latency_ms;
+
+    explicit Columns(int64_t n) {
+      for (int64_t i = 0; i < n; ++i) {
+        user_id.push_back(i);
+        bytes.push_back((i * 37) % 4096);
+        latency_ms.push_back(static_cast<double>(i % 500));
+      }
+    }
+
+    ColumnBatch batch() const {
+      const auto n = static_cast<int64_t>(user_id.size());
+      ColumnBatch b;
+      b.addColumn("user_id", ColumnView::ofInt64(user_id.data(), n));
+      b.addColumn("bytes", ColumnView::ofInt64(bytes.data(), n));
+      b.addColumn("latency_ms", ColumnView::ofDouble(latency_ms.data(), n));
+      return b;
+    }
+  };
+
+  // Bench 1: Evaluator::evaluate per row
+  // ---------------------------------------
+  static void BM_RowAtATime(benchmark::State & state) {
+    const Columns cols(state.range(0));
+    std::vector<std::vector<Key>> rows;
+    for (std::size_t i = 0; i < cols.user_id.size(); ++i) {
+      rows.push_back({Key("user_id", cols.user_id[i]),
+                      Key("bytes", cols.bytes[i]),
+                      Key("latency_ms", cols.latency_ms[i])});
+    }
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    for (auto _ : state) {
+      for (const auto &keys : rows) {
+        benchmark::DoNotOptimize(evaluator.evaluate(keys));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_RowAtATime)->Arg(1 << 10)->Arg(1 << 16);
+
+  // Bench 2: BatchEvaluator byte mask over the whole batch
+  // ---------------------------------------
+  static void BM_ColumnBatch(benchmark::State & state) {
+    const Columns cols(state.range(0));
+    const ColumnBatch batch = cols.batch();
+    BatchEvaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+  BENCHMARK(BM_ColumnBatch)->Arg(1 << 10)->Arg(1 << 16);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+// Packed feature flags. Records carry 16 flags either as one int64 key or as
+// 16 bool keys; the condition requires 4 of them. Arg 0 is the number of
+// flags tested. Items/sec is records (rows) per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(BitmaskExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  constexpr int kFlags = 16;
+  constexpr std::size_t kRecords = 1024;
+  constexpr std::size_t kRows = 1 << 16;
+
+  std::vector<int64_t> MakeFlags(std::size_t n) {
+    std::vector<int64_t> flags;
+    uint32_t x = 12345;
+    for (std::size_t i = 0; i < n; ++i) {
+      x = x * 1103515245u + 12345u;
+      // Each flag set with probability 3/4, so chained clauses rarely stop early
+      flags.push_back(static_cast<int64_t>(((x >> 8) | (x >> 16)) & 0xffff));
+    }
+    return flags;
+  }
+
+  std::string FlagName(int bit) { return "f" + std::to_string(bit); }
+
+  // Flags 0, 2, 4, ... up to `count` of them
+  int64_t MaskOf(int64_t count) {
+    int64_t mask = 0;
+    for (int64_t i = 0; i < count; ++i) mask |= int64_t{1} << (2 * i);
+    return mask;
+  }
+
+  FilterCondition UnpackedCondition(int64_t count) {
+    FilterCondition cond;
+    for (int64_t i = 0; i < count; ++i) {
+      cond.sub_expressions.push_back(SE(UnaryExpression{ComparisonOperations::EQUAL, FlagName(2 * i), true},
+                                        i == 0 ? LogicalOperations::NONE : LogicalOperations::AND));
+    }
+    return cond;
+  }
+
+  FilterCondition MaskCondition(int64_t count) {
+    return FilterCondition{{SE(BitmaskExpression{BitTest::ALL, "flags", MaskOf(count)})}};
+  }
+
+  // Bench 1: row path, one bool key per flag vs a packed int64 key
+  // ---------------------------------------
+  static void BM_FlagsUnpackedRow(benchmark::State & state) {
+    std::vector<std::vector<Key>> records;
+    for (int64_t packed : MakeFlags(kRecords)) {
+      std::vector<Key> keys;
+      for (int bit = 0; bit < kFlags; ++bit) keys.emplace_back(FlagName(bit), ((packed >> bit) & 1) != 0);
+      records.push_back(std::move(keys));
+    }
+    Evaluator evaluator;
+    evaluator.initialize(UnpackedCondition(state.range(0)));
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_FlagsUnpackedRow)->Arg(1)->Arg(4)->Arg(8);
+
+  static void BM_FlagsMaskRow(benchmark::State & state) {
+    std::vector<std::vector<Key>> records;
+    for (int64_t packed : MakeFlags(kRecords)) records.push_back({Key("flags", packed)});
+    Evaluator evaluator;
+    evaluator.initialize(MaskCondition(state.range(0)));
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_FlagsMaskRow)->Arg(1)->Arg(4)->Arg(8);
+
+  // Bench 2: BatchEvaluator, one bool bitmap column per flag vs an int64 column
+  // ---------------------------------------
+  static void BM_FlagsUnpackedBatch(benchmark::State & state) {
+    const auto flags = MakeFlags(kRows);
+    std::vector<std::vector<uint8_t>> bitmaps(kFlags, std::vector<uint8_t>(kRows / 8));
+    for (std::size_t i = 0; i < kRows; ++i) {
+      for (int bit = 0; bit < kFlags; ++bit) {
+        bitmaps[bit][i / 8] |= static_cast<uint8_t>(((flags[i] >> bit) & 1) << (i % 8));
+      }
+    }
+    ColumnBatch batch;
+    for (int bit = 0; bit < kFlags; ++bit) {
+      batch.addColumn(FlagName(bit), ColumnView::ofBoolBitmap(bitmaps[bit].data(), static_cast<int64_t>(kRows)));
+    }
+    BatchEvaluator evaluator;
+    evaluator.initialize(UnpackedCondition(state.range(0)));
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+  BENCHMARK(BM_FlagsUnpackedBatch)->Arg(1)->Arg(4)->Arg(8);
+
+  static void BM_FlagsMaskBatch(benchmark::State & state) {
+    const auto flags = MakeFlags(kRows);
+    ColumnBatch batch;
+    batch.addColumn("flags", ColumnView::ofInt64(flags.data(), static_cast<int64_t>(kRows)));
+    BatchEvaluator evaluator;
+    evaluator.initialize(MaskCondition(state.range(0)));
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+  BENCHMARK(BM_FlagsMaskBatch)->Arg(1)->Arg(4)->Arg(8);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -29,14 +29,12 @@ namespace {
 
   SubExpression SE(UnaryExpression ue,
                    LogicalOperations prev = LogicalOperations::NONE) {
-    return SubExpression{
-        std::variant<UnaryExpression, BinaryExpression>{std::move(ue)}, prev};
+    return SubExpression{Expression{std::move(ue)}, prev};
   }
 
   SubExpression SE(BinaryExpression be,
                    LogicalOperations prev = LogicalOperations::NONE) {
-    return SubExpression{
-        std::variant<UnaryExpression, BinaryExpression>{std::move(be)}, prev};
+    return SubExpression{Expression{std::move(be)}, prev};
   }
 
   std::vector<Key> MakeSequentialIntKeys(std::size_t n) {
@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "geo.h"
+#include "key.h"
+
+// Geospatial predicates. The box bench compares a GeoBox clause against the
+// same box spelled as four chained comparisons. Polygon benches take the ring
+// count as Arg 0; above 4 rings a grid index narrows the rings each point
+// visits. Items/sec is points/sec.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(GeoExpression ge,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ge)}, prev};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition Within(GeoRegionSpec region) {
+    return FilterCondition{{SE(GeoExpression{"lat", "lon", std::move(region)})}};
+  }
+
+  // Points spread over Europe and its surroundings
+  void MakePoints(std::size_t n, std::vector<double> &lat, std::vector<double> &lon) {
+    uint32_t x = 12345;
+    for (std::size_t i = 0; i < n; ++i) {
+      x = x * 1103515245u + 12345u;
+      lat.push_back(30.0 + (x >> 8) % 30000 / 1000.0);
+      x = x * 1103515245u + 12345u;
+      lon.push_back(-20.0 + (x >> 8) % 60000 / 1000.0);
+    }
+  }
+
+  // n small squares tiled over the same area
+  GeoPolygons MakePolygons(int64_t n) {
+    GeoPolygons polygons;
+    for (int64_t i = 0; i < n; ++i) {
+      const double lat = 30.0 + (i * 7 % 28);
+      const double lon = -20.0 + (i * 13 % 58);
+      polygons.rings.push_back({{lat, lon}, {lat, lon + 1.5}, {lat + 1.0, lon + 2.0}, {lat + 1.5, lon + 0.5}});
+    }
+    return polygons;
+  }
+
+  const GeoBox kBox{{41.0, -5.0}, {51.0, 9.5}};
+  const GeoCircle kCircle{{48.8566, 2.3522}, 500000.0};
+
+  constexpr std::size_t kRecords = 1024;
+  constexpr std::size_t kRows = 1 << 16;
+
+  std::vector<std::vector<Key>> MakeRecords() {
+    std::vector<double> lat, lon;
+    MakePoints(kRecords, lat, lon);
+    std::vector<std::vector<Key>> records;
+    for (std::size_t i = 0; i < kRecords; ++i) records.push_back({Key("lat", lat[i]), Key("lon", lon[i])});
+    return records;
+  }
+
+  void RunRow(benchmark::State &state, const FilterCondition &condition) {
+    const auto records = MakeRecords();
+    Evaluator evaluator;
+    evaluator.initialize(condition);
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+
+  void RunBatch(benchmark::State &state, const FilterCondition &condition) {
+    std::vector<double> lat, lon;
+    MakePoints(kRows, lat, lon);
+    ColumnBatch batch;
+    batch.addColumn("lat", ColumnView::ofDouble(lat.data(), static_cast<int64_t>(kRows)));
+    batch.addColumn("lon", ColumnView::ofDouble(lon.data(), static_cast<int64_t>(kRows)));
+    BatchEvaluator evaluator;
+    evaluator.initialize(condition);
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+
+  // Bench 1: box as four comparisons vs one GeoBox clause, row path
+  // ---------------------------------------
+  static void BM_GeoBoxAsComparisons(benchmark::State & state) {
+    RunRow(state, FilterCondition{{
+        SE(UnaryExpression{ComparisonOperations::GREATER_EQUAL, "lat", kBox.south_west.lat}),
+        SE(UnaryExpression{ComparisonOperations::LESS_EQUAL, "lat", kBox.north_east.lat},
+           LogicalOperations::AND),
+        SE(UnaryExpression{ComparisonOperations::GREATER_EQUAL, "lon", kBox.south_west.lon},
+           LogicalOperations::AND),
+        SE(UnaryExpression{ComparisonOperations::LESS_EQUAL, "lon", kBox.north_east.lon},
+           LogicalOperations::AND),
+    }});
+  }
+  BENCHMARK(BM_GeoBoxAsComparisons);
+
+  static void BM_GeoBoxRow(benchmark::State & state) { RunRow(state, Within(kBox)); }
+  BENCHMARK(BM_GeoBoxRow);
+
+  static void BM_GeoBoxBatch(benchmark::State & state) { RunBatch(state, Within(kBox)); }
+  BENCHMARK(BM_GeoBoxBatch);
+
+  // Bench 2: 500 km around Paris
+  // ---------------------------------------
+  static void BM_GeoCircleRow(benchmark::State & state) { RunRow(state, Within(kCircle)); }
+  BENCHMARK(BM_GeoCircleRow);
+
+  static void BM_GeoCircleBatch(benchmark::State & state) { RunBatch(state, Within(kCircle)); }
+  BENCHMARK(BM_GeoCircleBatch);
+
+  // Bench 3: polygon sets
+  // ---------------------------------------
+  static void BM_GeoPolygonsRow(benchmark::State & state) {
+    RunRow(state, Within(MakePolygons(state.range(0))));
+  }
+  BENCHMARK(BM_GeoPolygonsRow)->Arg(1)->Arg(4)->Arg(5)->Arg(64);
+
+  static void BM_GeoPolygonsBatch(benchmark::State & state) {
+    RunBatch(state, Within(MakePolygons(state.range(0))));
+  }
+  BENCHMARK(BM_GeoPolygonsBatch)->Arg(1)->Arg(4)->Arg(5)->Arg(64)->Arg(1024);
+
+} // namespace
+
+BENCHMARK_MAIN();
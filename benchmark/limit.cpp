@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+#include "scan.h"
+
+// First K matches of a 1%-selective condition over 256k records / rows: a full
+// scan vs scans that stop at the limit. Arg 0 is the limit (0: no limit), arg 1
+// the number of threads. Items/sec is records (rows) of the whole set per
+// second, so stopping early shows up as a higher rate.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr std::size_t kRecords = 1 << 18;
+
+  FilterCondition Selective() {
+    return {{SE(UnaryExpression{ComparisonOperations::LESS_THAN, "v", int64_t{1}}),
+             SE(UnaryExpression{ComparisonOperations::GREATER_EQUAL, "w", int64_t{0}}, LogicalOperations::AND)}};
+  }
+
+  std::vector<int64_t> MakeValues() {
+    std::vector<int64_t> v(kRecords);
+    uint32_t x = 12345;
+    for (auto &value : v) {
+      x = x * 1103515245u + 12345u;
+      value = (x >> 16) % 100;
+    }
+    return v;
+  }
+
+  std::size_t Limit(int64_t arg) { return arg == 0 ? ScanOptions::kNoLimit : static_cast<std::size_t>(arg); }
+
+  // Bench 1: record scans
+  // ---------------------------------------
+  void RunScan(benchmark::State &state, bool ordered) {
+    const auto v = MakeValues();
+    std::vector<std::vector<Key>> records(kRecords);
+    for (std::size_t r = 0; r < kRecords; ++r) records[r] = {Key("v", v[r]), Key("w", v[r])};
+    const auto predicate = LanguageParser::parse(Selective());
+    ScanOptions options;
+    options.limit = Limit(state.range(0));
+    options.threads = static_cast<unsigned>(state.range(1));
+    options.ordered = ordered;
+    for (auto _ : state) benchmark::DoNotOptimize(scanMatches(predicate, records, options));
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+
+  static void BM_ScanOrdered(benchmark::State & state) { RunScan(state, true); }
+  BENCHMARK(BM_ScanOrdered)->Args({0, 1})->Args({10, 1})->Args({0, 4})->Args({10, 4})->Args({1000, 4})->UseRealTime();
+
+  static void BM_ScanUnordered(benchmark::State & state) { RunScan(state, false); }
+  BENCHMARK(BM_ScanUnordered)->Args({10, 4})->Args({1000, 4})->UseRealTime();
+
+  // Bench 2: BatchEvaluator select
+  // ---------------------------------------
+  static void BM_BatchSelect(benchmark::State & state) {
+    const auto v = MakeValues();
+    ColumnBatch batch;
+    batch.addColumn("v", ColumnView::ofInt64(v.data(), kRecords));
+    batch.addColumn("w", ColumnView::ofInt64(v.data(), kRecords));
+    BatchEvaluator evaluator;
+    evaluator.initialize(Selective());
+    const std::size_t limit = Limit(state.range(0));
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(limit == ScanOptions::kNoLimit ? evaluator.select(batch)
+                                                              : evaluator.select(batch, limit));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_BatchSelect)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+// List predicates vs the numbered-key OR chains they replace. Arg 0 is the
+// list length, arg 1 the number of constants; constant sets above 8 values
+// are hashed, smaller ones scanned once per constant. Items/sec is
+// elements/sec.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(ListExpression le,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(le)}, prev};
+  }
+
+  // Constants never present in the list, so every element is examined
+  std::vector<ValueType> IntConstants(int64_t m) {
+    std::vector<ValueType> values;
+    for (int64_t i = 0; i < m; ++i) values.emplace_back(-1 - i);
+    return values;
+  }
+
+  std::vector<ValueType> StringConstants(int64_t m) {
+    std::vector<ValueType> values;
+    for (int64_t i = 0; i < m; ++i) values.emplace_back("missing-" + std::to_string(i));
+    return values;
+  }
+
+  void Run(benchmark::State &state, const FilterCondition &cond,
+           const std::vector<Key> &keys) {
+    Evaluator evaluator;
+    evaluator.initialize(cond);
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  // Bench 1: numbered keys "id_0".."id_n" OR-chained per constant (baseline)
+  // ---------------------------------------
+  static void BM_IntOrChain(benchmark::State & state) {
+    std::vector<Key> keys;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      keys.emplace_back("id_" + std::to_string(i), i);
+    }
+    FilterCondition cond;
+    for (const auto &v : IntConstants(state.range(1))) {
+      for (int64_t i = 0; i < state.range(0); ++i) {
+        cond.sub_expressions.push_back(
+            SE(UE(ComparisonOperations::EQUAL, "id_" + std::to_string(i), v),
+               cond.sub_expressions.empty() ? LogicalOperations::NONE
+                                            : LogicalOperations::OR));
+      }
+    }
+    Run(state, cond, keys);
+  }
+  BENCHMARK(BM_IntOrChain)->Args({16, 4})->Args({64, 4});
+
+  // Bench 2: ANY over a packed int64 array
+  // ---------------------------------------
+  static void BM_IntArrayAny(benchmark::State & state) {
+    std::vector<int64_t> ids;
+    for (int64_t i = 0; i < state.range(0); ++i) ids.push_back(i);
+    const FilterCondition cond{{SE(ListExpression{
+        ListQuantifier::ANY, "ids", ComparisonOperations::EQUAL,
+        IntConstants(state.range(1))})}};
+    Run(state, cond, {Key::array("ids", ids)});
+  }
+  BENCHMARK(BM_IntArrayAny)
+      ->Args({16, 4})
+      ->Args({64, 4})
+      ->Args({1024, 4})
+      ->Args({1024, 8})
+      ->Args({1024, 12})
+      ->Args({1024, 64});
+
+  // Bench 3: ALL with an ordered comparison (branch-free chunks)
+  // ---------------------------------------
+  static void BM_IntArrayAllGreater(benchmark::State & state) {
+    std::vector<int64_t> ids;
+    for (int64_t i = 0; i < state.range(0); ++i) ids.push_back(i);
+    const FilterCondition cond{{SE(ListExpression{
+        ListQuantifier::ALL, "ids", ComparisonOperations::GREATER_EQUAL,
+        {static_cast<int64_t>(0)}})}};
+    Run(state, cond, {Key::array("ids", ids)});
+  }
+  BENCHMARK(BM_IntArrayAllGreater)->Args({1024, 1});
+
+  // Bench 4: the same ANY over a generic Key::list
+  // ---------------------------------------
+  static void BM_IntGenericListAny(benchmark::State & state) {
+    std::vector<ValueType> ids;
+    for (int64_t i = 0; i < state.range(0); ++i) ids.emplace_back(i);
+    const FilterCondition cond{{SE(ListExpression{
+        ListQuantifier::ANY, "ids", ComparisonOperations::EQUAL,
+        IntConstants(state.range(1))})}};
+    Run(state, cond, {Key::list("ids", ids)});
+  }
+  BENCHMARK(BM_IntGenericListAny)->Args({1024, 4});
+
+  // Bench 5: string tags, scanned (<= 8 constants) vs hashed
+  // ---------------------------------------
+  static void BM_StringArrayAny(benchmark::State & state) {
+    std::vector<std::string> tags;
+    for (int64_t i = 0; i < state.range(0); ++i) tags.push_back("tag-" + std::to_string(i));
+    const FilterCondition cond{{SE(ListExpression{
+        ListQuantifier::ANY, "tags", ComparisonOperations::EQUAL,
+        StringConstants(state.range(1))})}};
+    Run(state, cond, {Key::array("tags", tags)});
+  }
+  BENCHMARK(BM_StringArrayAny)
+      ->Args({16, 2})
+      ->Args({16, 4})
+      ->Args({16, 8})
+      ->Args({16, 12})
+      ->Args({16, 32});
+
+  // Bench 6: CONTAINS, scanned per value vs one pass probing the hashed set
+  // ---------------------------------------
+  static void BM_IntArrayContains(benchmark::State & state) {
+    std::vector<int64_t> ids;
+    for (int64_t i = 0; i < state.range(0); ++i) ids.push_back(i);
+    std::vector<ValueType> wanted;
+    for (int64_t i = 0; i < state.range(1); ++i) wanted.emplace_back(state.range(0) - 1 - i);
+    const FilterCondition cond{{SE(ListExpression{
+        ListQuantifier::CONTAINS, "ids", ComparisonOperations::EQUAL, wanted})}};
+    Run(state, cond, {Key::array("ids", ids)});
+  }
+  BENCHMARK(BM_IntArrayContains)
+      ->Args({32, 16})
+      ->Args({1024, 4})
+      ->Args({1024, 16});
+
+} // namespace
+
+BENCHMARK_MAIN();
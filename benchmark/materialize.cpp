@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "key_path.h"
+#include "match_view.h"
+#include "parser.h"
+
+// Filter 64k records of 8 keys on "v < p" and sum one key of the matches:
+// copying matches into a new container vs a RecordMatches view projecting the
+// key vs partitioning the records in place. Then the column form: gathering
+// every column of the matching rows vs only the one that is read. Arg 0 is p
+// (percent of records that match). Items/sec is records (rows) per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr std::size_t kRecords = 1 << 16;
+  constexpr int kColumns = 8;
+
+  std::string Name(int c) { return "k" + std::to_string(c); }
+
+  FilterCondition Below(int64_t percent) {
+    return {{SE(UnaryExpression{ComparisonOperations::LESS_THAN, "v", percent})}};
+  }
+
+  // Column 0 is "v" (0-99), the others carry payload (k1 is a string in records)
+  std::vector<std::vector<int64_t>> MakeColumns() {
+    std::vector<std::vector<int64_t>> columns(kColumns, std::vector<int64_t>(kRecords));
+    uint32_t x = 12345;
+    for (std::size_t r = 0; r < kRecords; ++r) {
+      for (int c = 0; c < kColumns; ++c) {
+        x = x * 1103515245u + 12345u;
+        columns[c][r] = c == 0 ? (x >> 16) % 100 : (x >> 8) & 0xffff;
+      }
+    }
+    return columns;
+  }
+
+  std::vector<std::vector<Key>> MakeRecords() {
+    const auto columns = MakeColumns();
+    std::vector<std::vector<Key>> records(kRecords);
+    for (std::size_t r = 0; r < kRecords; ++r) {
+      records[r].emplace_back("v", columns[0][r]);
+      records[r].emplace_back(Name(1), "payload-" + std::to_string(columns[1][r]));
+      for (int c = 2; c < kColumns; ++c) records[r].emplace_back(Name(c), columns[c][r]);
+    }
+    return records;
+  }
+
+  int64_t IntValue(const Key *key) { return std::get<int64_t>(key->getValue()); }
+
+  // Bench 1: matches copied out
+  // ---------------------------------------
+  static void BM_CopyMatches(benchmark::State & state) {
+    const auto records = MakeRecords();
+    const auto predicate = LanguageParser::parse(Below(state.range(0)));
+    const KeyPath amount(Name(5));
+    for (auto _ : state) {
+      std::vector<std::vector<Key>> matches;
+      for (const auto &keys : records) {
+        if (predicate(keys)) matches.push_back(keys);
+      }
+      int64_t sum = 0;
+      for (const auto &keys : matches) sum += IntValue(amount.find(keys));
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_CopyMatches)->Arg(10)->Arg(50)->Arg(90);
+
+  // Bench 2: views into the source
+  // ---------------------------------------
+  static void BM_MatchView(benchmark::State & state) {
+    const auto records = MakeRecords();
+    const auto predicate = LanguageParser::parse(Below(state.range(0)));
+    for (auto _ : state) {
+      const RecordMatches matches = matchRecords(predicate, records);
+      int64_t sum = 0;
+      for (const Key *key : matches.project(Name(5))) sum += IntValue(key);
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_MatchView)->Arg(10)->Arg(50)->Arg(90);
+
+  // Bench 3: in-place partition (records are restored outside the timing)
+  // ---------------------------------------
+  static void BM_Partition(benchmark::State & state) {
+    const auto source = MakeRecords();
+    const auto predicate = LanguageParser::parse(Below(state.range(0)));
+    const KeyPath amount(Name(5));
+    std::vector<std::vector<Key>> records;
+    for (auto _ : state) {
+      state.PauseTiming();
+      records = source;
+      state.ResumeTiming();
+      const std::size_t kept = partitionMatches(predicate, records);
+      int64_t sum = 0;
+      for (std::size_t i = 0; i < kept; ++i) sum += IntValue(amount.find(records[i]));
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_Partition)->Arg(10)->Arg(50)->Arg(90);
+
+  // Bench 4: column batch, gather every column vs the one that is read
+  // ---------------------------------------
+  void RunGather(benchmark::State &state, bool all) {
+    const auto columns = MakeColumns();
+    ColumnBatch batch;
+    batch.addColumn("v", ColumnView::ofInt64(columns[0].data(), kRecords));
+    for (int c = 1; c < kColumns; ++c) batch.addColumn(Name(c), ColumnView::ofInt64(columns[c].data(), kRecords));
+    BatchEvaluator evaluator;
+    evaluator.initialize(Below(state.range(0)));
+    std::vector<ProjectedColumn> gathered(kColumns);
+    for (auto _ : state) {
+      const BatchMatches matches = matchRows(evaluator, batch);
+      if (all) {
+        for (int c = 1; c < kColumns; ++c) matches.gather(Name(c), gathered[c]);
+      } else {
+        matches.gather(Name(5), gathered[5]);
+      }
+      int64_t sum = 0;
+      for (int64_t value : gathered[5].ints) sum += value;
+      benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+
+  static void BM_GatherAllColumns(benchmark::State & state) { RunGather(state, true); }
+  BENCHMARK(BM_GatherAllColumns)->Arg(10)->Arg(50)->Arg(90);
+
+  static void BM_GatherOneColumn(benchmark::State & state) { RunGather(state, false); }
+  BENCHMARK(BM_GatherOneColumn)->Arg(10)->Arg(50)->Arg(90);
+
+} // namespace
+
+BENCHMARK_MAIN();
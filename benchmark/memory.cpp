@@ -0,0 +1,337 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+// Memory footprint and allocation counts. This executable replaces the global
+// allocator so every operator new in the process (library and STL included)
+// is counted; counters are reported per compiled condition, per record and
+// per evaluate call.
+
+namespace {
+
+  // Counting allocator
+  // ------------------------------------
+  struct AllocStats {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<int64_t> live_bytes{0};
+  };
+  AllocStats g_alloc;
+
+  struct AllocSnapshot {
+    uint64_t allocations;
+    uint64_t bytes;
+    int64_t live_bytes;
+
+    static AllocSnapshot Take() {
+      return {g_alloc.allocations.load(std::memory_order_relaxed),
+              g_alloc.bytes.load(std::memory_order_relaxed),
+              g_alloc.live_bytes.load(std::memory_order_relaxed)};
+    }
+  };
+
+  // Every block carries a 16-byte (or `align`-byte) header in front of the
+  // user pointer; its last 16 bytes hold the requested size and header size
+  // so deallocation can update the live byte count without sized delete.
+  constexpr std::size_t kHeader = 16;
+
+  void *CountedAlloc(std::size_t size, std::size_t align) {
+    const std::size_t header = std::max(kHeader, align);
+    void *raw = nullptr;
+    if (align > kHeader) {
+      const std::size_t total = (header + size + align - 1) / align * align;
+      raw = std::aligned_alloc(align, total);
+    } else {
+      raw = std::malloc(header + size);
+    }
+    if (!raw) {
+      return nullptr;
+    }
+    auto *user = static_cast<char *>(raw) + header;
+    auto *meta = reinterpret_cast<std::size_t *>(user - kHeader);
+    meta[0] = size;
+    meta[1] = header;
+    g_alloc.allocations.fetch_add(1, std::memory_order_relaxed);
+    g_alloc.bytes.fetch_add(size, std::memory_order_relaxed);
+    g_alloc.live_bytes.fetch_add(static_cast<int64_t>(size),
+                                 std::memory_order_relaxed);
+    return user;
+  }
+
+  void CountedFree(void *p) noexcept {
+    if (!p) {
+      return;
+    }
+    auto *user = static_cast<char *>(p);
+    const auto *meta = reinterpret_cast<const std::size_t *>(user - kHeader);
+    g_alloc.live_bytes.fetch_sub(static_cast<int64_t>(meta[0]),
+                                 std::memory_order_relaxed);
+    std::free(user - meta[1]);
+  }
+
+  void *CountedNew(std::size_t size, std::size_t align) {
+    void *p = CountedAlloc(size ? size : 1, align);
+    if (!p) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+
+  // Resident set size of the process, in bytes (0 when unavailable).
+  int64_t ResidentBytes() {
+#if defined(__unix__)
+    std::ifstream statm("/proc/self/statm");
+    int64_t pages = 0;
+    int64_t resident = 0;
+    if (statm >> pages >> resident) {
+      return resident * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+  }
+
+} // namespace
+
+void *operator new(std::size_t size) { return CountedNew(size, kHeader); }
+void *operator new[](std::size_t size) { return CountedNew(size, kHeader); }
+void *operator new(std::size_t size, std::align_val_t align) {
+  return CountedNew(size, static_cast<std::size_t>(align));
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return CountedNew(size, static_cast<std::size_t>(align));
+}
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return CountedAlloc(size ? size : 1, kHeader);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return CountedAlloc(size ? size : 1, kHeader);
+}
+void operator delete(void *p) noexcept { CountedFree(p); }
+void operator delete[](void *p) noexcept { CountedFree(p); }
+void operator delete(void *p, std::size_t) noexcept { CountedFree(p); }
+void operator delete[](void *p, std::size_t) noexcept { CountedFree(p); }
+void operator delete(void *p, std::align_val_t) noexcept { CountedFree(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { CountedFree(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  CountedFree(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  CountedFree(p);
+}
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  CountedFree(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  CountedFree(p);
+}
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  // Same layout as chatgpt.cpp: keys cycle through int, double, string, bool.
+  std::vector<Key> MakeMixedKeys(std::size_t n) {
+    std::vector<Key> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      switch (i % 4) {
+      case 0:
+        keys.emplace_back("k" + std::to_string(i), static_cast<int64_t>(i));
+        break;
+      case 1:
+        keys.emplace_back("k" + std::to_string(i),
+                          static_cast<double>(i) + 0.5);
+        break;
+      case 2:
+        keys.emplace_back("k" + std::to_string(i),
+                          std::string("str") + std::to_string(i));
+        break;
+      case 3:
+        keys.emplace_back("k" + std::to_string(i), (i % 2) == 0);
+        break;
+      }
+    }
+    return keys;
+  }
+
+  // Clause i compares key (i % key_count) against a constant of the matching
+  // MakeMixedKeys type; every fourth int clause becomes a BinaryExpression.
+  FilterCondition MakeMixedCondition(std::size_t clauses, std::size_t key_count) {
+    FilterCondition cond;
+    cond.sub_expressions.reserve(clauses);
+    for (std::size_t i = 0; i < clauses; ++i) {
+      const auto prev = i == 0 ? LogicalOperations::NONE : LogicalOperations::AND;
+      const std::size_t k = i % key_count;
+      const std::string key = "k" + std::to_string(k);
+      switch (k % 4) {
+      case 0:
+        if (i % 8 == 4 && key_count > 4) {
+          cond.sub_expressions.push_back(
+              SE(BE(key, ArithmeticOperations::ADD, "k" + std::to_string(k + 4 < key_count ? k + 4 : 0),
+                    ComparisonOperations::GREATER_EQUAL, static_cast<int64_t>(0)),
+                 prev));
+        } else {
+          cond.sub_expressions.push_back(SE(
+              UE(ComparisonOperations::GREATER_EQUAL, key, static_cast<int64_t>(0)),
+              prev));
+        }
+        break;
+      case 1:
+        cond.sub_expressions.push_back(
+            SE(UE(ComparisonOperations::GREATER_THAN, key, 0.0), prev));
+        break;
+      case 2:
+        cond.sub_expressions.push_back(
+            SE(UE(ComparisonOperations::NOT_EQUAL, key,
+                  std::string("a string constant past SSO")),
+               prev));
+        break;
+      case 3:
+        cond.sub_expressions.push_back(
+            SE(UE(ComparisonOperations::NOT_EQUAL, key, (k % 2) != 0), prev));
+        break;
+      }
+    }
+    return cond;
+  }
+
+  void ReportPer(benchmark::State & state, const char *suffix,
+                 const AllocSnapshot &before, const AllocSnapshot &after,
+                 int64_t rss_before, int64_t rss_after, double units) {
+    const std::string s(suffix);
+    state.counters["allocs/" + s] =
+        static_cast<double>(after.allocations - before.allocations) / units;
+    state.counters["bytes/" + s] =
+        static_cast<double>(after.bytes - before.bytes) / units;
+    state.counters["live_bytes/" + s] =
+        static_cast<double>(after.live_bytes - before.live_bytes) / units;
+    state.counters["rss_bytes/" + s] =
+        static_cast<double>(rss_after - rss_before) / units;
+  }
+
+  // Bench 1: footprint of compiled conditions
+  // ---------------------------------------
+  // Builds `kBatch` Evaluators from prebuilt conditions and keeps them alive
+  // so live and resident bytes reflect what a loaded rule set retains.
+  static void BM_ConditionFootprint(benchmark::State & state) {
+    constexpr std::size_t kBatch = 4096;
+    const auto clauses = static_cast<std::size_t>(state.range(0));
+    const auto key_count = static_cast<std::size_t>(state.range(1));
+    const FilterCondition cond = MakeMixedCondition(clauses, key_count);
+
+    for (auto _ : state) {
+      std::vector<Evaluator> evaluators(kBatch);
+      const auto before = AllocSnapshot::Take();
+      const auto rss_before = ResidentBytes();
+      for (auto &e : evaluators) {
+        e.initialize(cond);
+      }
+      const auto after = AllocSnapshot::Take();
+      const auto rss_after = ResidentBytes();
+      benchmark::DoNotOptimize(evaluators.data());
+      ReportPer(state, "condition", before, after, rss_before, rss_after,
+                static_cast<double>(kBatch));
+    }
+  }
+  BENCHMARK(BM_ConditionFootprint)
+      ->ArgNames({"clauses", "keys"})
+      ->ArgsProduct({{1, 4, 16, 64}, {4, 16, 64}})
+      ->Iterations(1);
+
+  // Bench 2: footprint of MakeMixedKeys records
+  // ---------------------------------------
+  static void BM_RecordFootprint(benchmark::State & state) {
+    constexpr std::size_t kBatch = 4096;
+    const auto key_count = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+      std::vector<std::vector<Key>> records;
+      records.reserve(kBatch);
+      const auto before = AllocSnapshot::Take();
+      const auto rss_before = ResidentBytes();
+      for (std::size_t i = 0; i < kBatch; ++i) {
+        records.push_back(MakeMixedKeys(key_count));
+      }
+      const auto after = AllocSnapshot::Take();
+      const auto rss_after = ResidentBytes();
+      benchmark::DoNotOptimize(records.data());
+      ReportPer(state, "record", before, after, rss_before, rss_after,
+                static_cast<double>(kBatch));
+    }
+  }
+  BENCHMARK(BM_RecordFootprint)
+      ->ArgNames({"keys"})
+      ->Arg(4)
+      ->Arg(16)
+      ->Arg(64)
+      ->Arg(256)
+      ->Iterations(1);
+
+  // Bench 3: allocations per evaluate
+  // ---------------------------------------
+  // The numbers to watch for regressions: a steady-state evaluate should not
+  // allocate at all, so allocs/eval creeping up means a hot-path copy.
+  static void BM_EvaluateAllocations(benchmark::State & state) {
+    const auto clauses = static_cast<std::size_t>(state.range(0));
+    const auto key_count = static_cast<std::size_t>(state.range(1));
+    const auto keys = MakeMixedKeys(key_count);
+    Evaluator evaluator;
+    evaluator.initialize(MakeMixedCondition(clauses, key_count));
+
+    const auto before = AllocSnapshot::Take();
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    const auto after = AllocSnapshot::Take();
+    state.counters["allocs/eval"] = benchmark::Counter(
+        static_cast<double>(after.allocations - before.allocations),
+        benchmark::Counter::kAvgIterations);
+    state.counters["bytes/eval"] =
+        benchmark::Counter(static_cast<double>(after.bytes - before.bytes),
+                           benchmark::Counter::kAvgIterations);
+  }
+  BENCHMARK(BM_EvaluateAllocations)
+      ->ArgNames({"clauses", "keys"})
+      ->ArgsProduct({{1, 4, 16, 64}, {4, 16, 64}});
+
+} // namespace
+
+BENCHMARK_MAIN();
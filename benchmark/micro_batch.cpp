@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "micro_batcher.h"
+
+// Many threads evaluating one record at a time against a shared plan:
+// each calling Evaluator::evaluate directly vs going through
+// MicroBatchEvaluator, which coalesces their calls into batches.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "bytes",
+               static_cast<int64_t>(1024))),
+         SE(UE(ComparisonOperations::LESS_THAN, "latency_ms", 250.0),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::EQUAL, "region",
+               std::string("eu-west-1")),
+            LogicalOperations::AND)}};
+  }
+
+  std::vector<Key> MakeRecord(int64_t i) {
+    return {Key("bytes", (i * 37) % 4096),
+            Key("latency_ms", static_cast<double>(i % 500)),
+            Key("region", std::string(i % 2 ? "eu-west-1" : "us-east-1"))};
+  }
+
+  Evaluator &SharedEvaluator() {
+    static Evaluator evaluator = [] {
+      Evaluator e;
+      e.initialize(MakeCondition());
+      return e;
+    }();
+    return evaluator;
+  }
+
+  MicroBatchOptions MakeOptions() {
+    MicroBatchOptions options;
+    options.max_wait = std::chrono::microseconds(10);
+    options.max_batch = 64;
+    return options;
+  }
+
+  MicroBatchEvaluator &SharedBatcher() {
+    static MicroBatchEvaluator batcher(MakeOptions());
+    static const bool initialized = (batcher.initialize(MakeCondition()), true);
+    (void)initialized;
+    return batcher;
+  }
+
+  // Bench 1: each thread calls Evaluator::evaluate itself
+  // ---------------------------------------
+  static void BM_DirectEvaluate(benchmark::State & state) {
+    Evaluator &evaluator = SharedEvaluator();
+    const auto record = MakeRecord(state.thread_index());
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(evaluator.evaluate(record));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_DirectEvaluate)->ThreadRange(1, 16)->UseRealTime();
+
+  // Bench 2: the same calls coalesced by MicroBatchEvaluator
+  // ---------------------------------------
+  static void BM_MicroBatchEvaluate(benchmark::State & state) {
+    MicroBatchEvaluator &batcher = SharedBatcher();
+    const auto record = MakeRecord(state.thread_index());
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(batcher.evaluate(record));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+      const auto stats = batcher.stats();
+      state.counters["records_per_batch"] =
+          stats.batches ? static_cast<double>(stats.records) / stats.batches : 0.0;
+    }
+  }
+  BENCHMARK(BM_MicroBatchEvaluate)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
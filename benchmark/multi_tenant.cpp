@@ -0,0 +1,234 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+// Cache-cold, multi-plan workload. Instead of one tiny condition on one tiny
+// record, every iteration picks a (plan, record) pair from a shuffled schedule
+// over thousands of distinct Evaluators and a record set whose combined
+// footprint is a multiple of the last-level cache.
+
+namespace {
+
+  constexpr std::size_t kKeysPerRecord = 24;
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  std::string FieldName(std::size_t i) {
+    // Long enough to defeat the small-string buffer, like real field names.
+    return "tenant_field_name_" + std::to_string(i);
+  }
+
+  std::size_t LastLevelCacheBytes() {
+    std::size_t llc = 0;
+    for (const auto &cache : benchmark::CPUInfo::Get().caches) {
+      llc = std::max<std::size_t>(llc, static_cast<std::size_t>(cache.size));
+    }
+    return llc ? llc : (32u << 20); // assume 32 MiB when unknown
+  }
+
+  // Rough heap footprint of one record: vector storage, out-of-line names and
+  // string values.
+  std::size_t RecordBytes(const std::vector<Key> &record) {
+    std::size_t bytes = record.capacity() * sizeof(Key);
+    for (const auto &key : record) {
+      bytes += key.getName().capacity() + 1;
+      if (const auto *s = std::get_if<std::string>(&key.getValue())) {
+        bytes += s->capacity() + 1;
+      }
+    }
+    return bytes;
+  }
+
+  // Plan p touches a tenant-specific subset of fields with its own constants.
+  FilterCondition MakeTenantCondition(std::size_t p) {
+    const std::size_t a = p % kKeysPerRecord;
+    const std::size_t b = (p / 3 + 5) % kKeysPerRecord;
+    const std::size_t c = (p / 7 + 11) % kKeysPerRecord;
+    const auto ia = a - a % 3; // int fields are 0, 3, 6, ...
+    const auto ib = b - b % 3;
+    const auto sc = c - c % 3 + 2; // string fields are 2, 5, 8, ...
+    FilterCondition cond;
+    cond.sub_expressions.push_back(
+        SE(UE(ComparisonOperations::GREATER_EQUAL, FieldName(ia),
+              static_cast<int64_t>(p % 1000))));
+    cond.sub_expressions.push_back(
+        SE(BE(FieldName(ia), ArithmeticOperations::ADD, FieldName(ib),
+              ComparisonOperations::LESS_THAN, static_cast<int64_t>(1500)),
+           LogicalOperations::AND));
+    cond.sub_expressions.push_back(
+        SE(UE(ComparisonOperations::NOT_EQUAL, FieldName(sc),
+              std::string("value_") + std::to_string(p % 97)),
+           LogicalOperations::OR));
+    return cond;
+  }
+
+  // Fields cycle int, double, string.
+  std::vector<Key> MakeRecord(std::mt19937_64 & rng) {
+    std::uniform_int_distribution<int64_t> ints(0, 999);
+    std::vector<Key> record;
+    record.reserve(kKeysPerRecord);
+    for (std::size_t i = 0; i < kKeysPerRecord; ++i) {
+      switch (i % 3) {
+      case 0:
+        record.emplace_back(FieldName(i), ints(rng));
+        break;
+      case 1:
+        record.emplace_back(FieldName(i), static_cast<double>(ints(rng)) / 7.0);
+        break;
+      default:
+        record.emplace_back(FieldName(i), std::string("value_") +
+                                              std::to_string(ints(rng) % 97) +
+                                              "_padding_to_heap");
+        break;
+      }
+    }
+    return record;
+  }
+
+  struct Workload {
+    std::vector<Evaluator> plans;
+    std::vector<std::vector<Key>> records;
+    std::vector<std::pair<uint32_t, uint32_t>> schedule;
+    std::size_t footprint = 0;
+  };
+
+  // Built once per (plans, llc multiple) and reused across repetitions;
+  // building a few hundred MB of records is much slower than the benchmark.
+  Workload &GetWorkload(std::size_t plan_count, std::size_t llc_multiple) {
+    static std::vector<std::pair<std::pair<std::size_t, std::size_t>, Workload>>
+        cache;
+    for (auto &entry : cache) {
+      if (entry.first == std::make_pair(plan_count, llc_multiple)) {
+        return entry.second;
+      }
+    }
+    // Only one workload is resident at a time so the machine is not swamped.
+    cache.clear();
+    cache.emplace_back(std::make_pair(plan_count, llc_multiple), Workload{});
+    Workload &w = cache.back().second;
+
+    std::mt19937_64 rng(plan_count * 31 + llc_multiple);
+    w.plans.resize(plan_count);
+    for (std::size_t p = 0; p < plan_count; ++p) {
+      w.plans[p].initialize(MakeTenantCondition(p));
+    }
+
+    const std::size_t target = LastLevelCacheBytes() * llc_multiple;
+    while (w.footprint < target) {
+      w.records.push_back(MakeRecord(rng));
+      w.footprint += RecordBytes(w.records.back());
+    }
+
+    // Enough pairs that the schedule never repeats within a short run and
+    // every record is visited.
+    const std::size_t pairs = std::max<std::size_t>(w.records.size(), 1u << 20);
+    std::uniform_int_distribution<uint32_t> pick_plan(
+        0, static_cast<uint32_t>(plan_count - 1));
+    std::uniform_int_distribution<uint32_t> pick_record(
+        0, static_cast<uint32_t>(w.records.size() - 1));
+    w.schedule.reserve(pairs);
+    for (std::size_t i = 0; i < pairs; ++i) {
+      w.schedule.emplace_back(pick_plan(rng), pick_record(rng));
+    }
+    return w;
+  }
+
+  // Bench 1: rotate through plans and records larger than the LLC
+  // ---------------------------------------
+  static void BM_MultiTenantCacheCold(benchmark::State & state) {
+    const auto plan_count = static_cast<std::size_t>(state.range(0));
+    const auto llc_multiple = static_cast<std::size_t>(state.range(1));
+    Workload &w = GetWorkload(plan_count, llc_multiple);
+
+    std::size_t i = 0;
+    std::size_t matches = 0;
+    for (auto _ : state) {
+      const auto &pick = w.schedule[i];
+      matches += w.plans[pick.first].evaluate(w.records[pick.second]);
+      if (++i == w.schedule.size()) {
+        i = 0;
+      }
+    }
+    benchmark::DoNotOptimize(matches);
+    state.counters["records"] = static_cast<double>(w.records.size());
+    state.counters["footprint_MiB"] =
+        static_cast<double>(w.footprint) / (1024.0 * 1024.0);
+    state.counters["llc_MiB"] =
+        static_cast<double>(LastLevelCacheBytes()) / (1024.0 * 1024.0);
+  }
+  BENCHMARK(BM_MultiTenantCacheCold)
+      ->ArgNames({"plans", "llc_x"})
+      ->Args({1024, 2})
+      ->Args({8192, 2})
+      ->Args({65536, 2})
+      ->Args({8192, 4});
+
+  // Bench 2: same plans, same schedule shape, but one hot record
+  // ---------------------------------------
+  // Baseline for Bench 1: only the plan rotates and the record stays in L1,
+  // which isolates the cost of cold data from the cost of cold plans.
+  static void BM_MultiTenantHotRecord(benchmark::State & state) {
+    const auto plan_count = static_cast<std::size_t>(state.range(0));
+    std::vector<Evaluator> plans(plan_count);
+    for (std::size_t p = 0; p < plan_count; ++p) {
+      plans[p].initialize(MakeTenantCondition(p));
+    }
+    std::mt19937_64 rng(7);
+    const auto record = MakeRecord(rng);
+    std::vector<uint32_t> order(1u << 16);
+    std::uniform_int_distribution<uint32_t> pick_plan(
+        0, static_cast<uint32_t>(plan_count - 1));
+    for (auto &o : order) {
+      o = pick_plan(rng);
+    }
+
+    std::size_t i = 0;
+    std::size_t matches = 0;
+    for (auto _ : state) {
+      matches += plans[order[i]].evaluate(record);
+      i = (i + 1) & (order.size() - 1);
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  BENCHMARK(BM_MultiTenantHotRecord)
+      ->ArgNames({"plans"})
+      ->Arg(1)
+      ->Arg(1024)
+      ->Arg(8192)
+      ->Arg(65536);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+// A hierarchical event (3 groups x 12 fields) evaluated as a flattened list of
+// dotted keys vs as nested objects addressed by dotted paths.
+
+namespace {
+
+  constexpr int kGroups = 3;
+  constexpr int kFields = 12;
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  std::string FieldName(int g, int f) {
+    return "g" + std::to_string(g) + ".f" + std::to_string(f);
+  }
+
+  // Touches the last field of every group, the worst case for a flat scan
+  FilterCondition MakeCondition() {
+    FilterCondition cond;
+    for (int g = 0; g < kGroups; ++g) {
+      cond.sub_expressions.push_back(
+          SE(UE(ComparisonOperations::GREATER_EQUAL, FieldName(g, kFields - 1),
+                static_cast<int64_t>(0)),
+             g == 0 ? LogicalOperations::NONE : LogicalOperations::AND));
+    }
+    return cond;
+  }
+
+  std::vector<Key> MakeFlat() {
+    std::vector<Key> keys;
+    for (int g = 0; g < kGroups; ++g) {
+      for (int f = 0; f < kFields; ++f) {
+        keys.emplace_back(FieldName(g, f), static_cast<int64_t>(f));
+      }
+    }
+    return keys;
+  }
+
+  std::vector<Key> MakeNested() {
+    std::vector<Key> keys;
+    for (int g = 0; g < kGroups; ++g) {
+      std::vector<Key> fields;
+      for (int f = 0; f < kFields; ++f) {
+        fields.emplace_back("f" + std::to_string(f), static_cast<int64_t>(f));
+      }
+      keys.push_back(Key::object("g" + std::to_string(g), std::move(fields)));
+    }
+    return keys;
+  }
+
+  // Bench 1: flattened dotted names
+  // ---------------------------------------
+  static void BM_FlattenedKeys(benchmark::State & state) {
+    const auto keys = MakeFlat();
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+  }
+  BENCHMARK(BM_FlattenedKeys);
+
+  // Bench 2: nested objects, paths resolved with position hints
+  // ---------------------------------------
+  static void BM_NestedKeys(benchmark::State & state) {
+    const auto keys = MakeNested();
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+  }
+  BENCHMARK(BM_NestedKeys);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "key_schema.h"
+#include "parser.h"
+
+// Records with optional fields against "a > 0 AND b > 0 AND c > 0". Arg 0 is
+// the percentage of records missing one of the three keys. Incomplete records
+// are either rejected by the "Key not found" exception or by a PresenceRule
+// before evaluation. Items/sec is records per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  SubExpression Positive(std::string key, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::GREATER_THAN, std::move(key), int64_t{0}}, prev);
+  }
+
+  constexpr std::size_t kRecords = 1024;
+  const std::vector<std::string> kFields{"a", "b", "c", "d", "e"};
+
+  FilterCondition AllPositive() {
+    return {{Positive("a"), Positive("b", LogicalOperations::AND), Positive("c", LogicalOperations::AND)}};
+  }
+
+  // `missing_pct` percent of records lack one of a, b, c
+  std::vector<std::vector<Key>> MakeRecords(int64_t missing_pct) {
+    std::vector<std::vector<Key>> records(kRecords);
+    uint32_t x = 12345;
+    for (auto &keys : records) {
+      x = x * 1103515245u + 12345u;
+      const bool incomplete = (x >> 16) % 100 < static_cast<uint32_t>(missing_pct);
+      const std::size_t skip = incomplete ? (x >> 8) % 3 : kFields.size();
+      for (std::size_t i = 0; i < kFields.size(); ++i) {
+        if (i != skip) keys.emplace_back(kFields[i], static_cast<int64_t>(1 + i));
+      }
+    }
+    return records;
+  }
+
+  // Bench 1: exception on a missing key
+  // ---------------------------------------
+  static void BM_CatchMissing(benchmark::State & state) {
+    const auto records = MakeRecords(state.range(0));
+    Evaluator evaluator;
+    evaluator.initialize(AllPositive());
+    for (auto _ : state) {
+      for (const auto &keys : records) {
+        bool match = false;
+        try {
+          match = evaluator.evaluate(keys);
+        } catch (const ParseException &) {
+        }
+        benchmark::DoNotOptimize(match);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_CatchMissing)->Arg(0)->Arg(10)->Arg(50);
+
+  // Bench 2: presence rule computed per record, then evaluation
+  // ---------------------------------------
+  static void BM_PresenceRule(benchmark::State & state) {
+    const auto records = MakeRecords(state.range(0));
+    const KeySchema schema(kFields);
+    const PresenceRule rule = schema.rule(AllPositive());
+    Evaluator evaluator;
+    evaluator.initialize(AllPositive());
+    for (auto _ : state) {
+      for (const auto &keys : records) {
+        benchmark::DoNotOptimize(rule.admits(schema.presence(keys)) && evaluator.evaluate(keys));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_PresenceRule)->Arg(0)->Arg(10)->Arg(50);
+
+  // Bench 3: presence masks supplied by the producer
+  // ---------------------------------------
+  static void BM_PresenceKnown(benchmark::State & state) {
+    const auto records = MakeRecords(state.range(0));
+    const KeySchema schema(kFields);
+    std::vector<uint64_t> presence;
+    for (const auto &keys : records) presence.push_back(schema.presence(keys));
+    const PresenceRule rule = schema.rule(AllPositive());
+    Evaluator evaluator;
+    evaluator.initialize(AllPositive());
+    for (auto _ : state) {
+      for (std::size_t r = 0; r < kRecords; ++r) {
+        benchmark::DoNotOptimize(rule.admits(presence[r]) && evaluator.evaluate(records[r]));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_PresenceKnown)->Arg(0)->Arg(10)->Arg(50);
+
+  // Bench 4: EXISTS guards inside the condition
+  // ---------------------------------------
+  static void BM_ExistsGuards(benchmark::State & state) {
+    const auto records = MakeRecords(state.range(0));
+    const auto AND = LogicalOperations::AND;
+    const FilterCondition guarded{{SE(ExistsExpression{"a"}), SE(ExistsExpression{"b"}, AND),
+                                   SE(ExistsExpression{"c"}, AND), Positive("a", AND), Positive("b", AND),
+                                   Positive("c", AND)}};
+    Evaluator evaluator;
+    evaluator.initialize(guarded);
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_ExistsGuards)->Arg(0)->Arg(10)->Arg(50);
+
+} // namespace
+
+BENCHMARK_MAIN();
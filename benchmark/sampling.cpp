@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+// Sampling 1% of records by user ID. "After" evaluates the filter and then
+// samples its matches; "Last" puts the sample at the end of the AND chain as
+// written; "Hoisted" lets Evaluator move it to the front. Items/sec is
+// records/sec.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(SampleExpression se,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(se)}, prev};
+  }
+
+  constexpr double kRate = 0.01;
+  constexpr std::size_t kRecords = 1024;
+  constexpr std::size_t kRows = 1 << 16;
+
+  // Passes for most records, so sampling afterwards pays for all of it
+  FilterCondition Filter() {
+    return FilterCondition{{
+        SE(UnaryExpression{ComparisonOperations::EQUAL, "country", std::string("DE")}),
+        SE(UnaryExpression{ComparisonOperations::NOT_EQUAL, "agent", std::string("bot")}, LogicalOperations::AND),
+        SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "latency", 0.0}, LogicalOperations::AND),
+        SE(UnaryExpression{ComparisonOperations::LESS_THAN, "status", int64_t{500}}, LogicalOperations::AND),
+    }};
+  }
+
+  FilterCondition FilterThenSample() {
+    FilterCondition cond = Filter();
+    cond.sub_expressions.push_back(SE(SampleExpression{"user_id", kRate, 1}, LogicalOperations::AND));
+    return cond;
+  }
+
+  std::vector<std::vector<Key>> MakeRecords() {
+    std::vector<std::vector<Key>> records;
+    for (std::size_t i = 0; i < kRecords; ++i) {
+      records.push_back({Key("user_id", static_cast<int64_t>(i * 2654435761u)), Key("country", std::string("DE")),
+                         Key("agent", std::string("browser")), Key("latency", 12.5 + i % 7),
+                         Key("status", static_cast<int64_t>(200 + i % 100))});
+    }
+    return records;
+  }
+
+  // Bench 1: row path
+  // ---------------------------------------
+  static void BM_SampleAfterFilter(benchmark::State & state) {
+    const auto records = MakeRecords();
+    const auto filter = LanguageParser::parse(Filter());
+    const auto sample = LanguageParser::parse(FilterCondition{{SE(SampleExpression{"user_id", kRate, 1})}});
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(filter(keys) && sample(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_SampleAfterFilter);
+
+  static void BM_SampleLast(benchmark::State & state) {
+    const auto records = MakeRecords();
+    const auto predicate = LanguageParser::parse(FilterThenSample());
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(predicate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_SampleLast);
+
+  static void BM_SampleHoisted(benchmark::State & state) {
+    const auto records = MakeRecords();
+    Evaluator evaluator;
+    evaluator.initialize(FilterThenSample());
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_SampleHoisted);
+
+  // Bench 2: BatchEvaluator, sampling alone over integer and string IDs
+  // ---------------------------------------
+  static void BM_SampleBatchInt(benchmark::State & state) {
+    std::vector<int64_t> ids;
+    for (std::size_t i = 0; i < kRows; ++i) ids.push_back(static_cast<int64_t>(i * 2654435761u));
+    ColumnBatch batch;
+    batch.addColumn("user_id", ColumnView::ofInt64(ids.data(), static_cast<int64_t>(kRows)));
+    BatchEvaluator evaluator;
+    evaluator.initialize(FilterCondition{{SE(SampleExpression{"user_id", kRate, 1})}});
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+  BENCHMARK(BM_SampleBatchInt);
+
+  static void BM_SampleBatchString(benchmark::State & state) {
+    std::vector<int32_t> offsets{0};
+    std::string chars;
+    for (std::size_t i = 0; i < kRows; ++i) {
+      chars += "user-" + std::to_string(i * 2654435761u);
+      offsets.push_back(static_cast<int32_t>(chars.size()));
+    }
+    ColumnBatch batch;
+    batch.addColumn("user_id", ColumnView::ofStrings(offsets.data(), chars.data(), static_cast<int64_t>(kRows)));
+    BatchEvaluator evaluator;
+    evaluator.initialize(FilterCondition{{SE(SampleExpression{"user_id", kRate, 1})}});
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+  BENCHMARK(BM_SampleBatchString);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "geo.h"
+
+// "v < p AND s == 'k7' AND price * qty > 500 AND (lat, lon) in box" over 64k
+// rows, where the first clause keeps p% of rows. Later clauses run on whole
+// columns (density 0), on a selection vector of the survivors (density 1),
+// or switch per clause (the default). Arg 0 is p. Items/sec is rows per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr int64_t kRows = 1 << 16;
+
+  FilterCondition Chain(int64_t percent) {
+    const auto AND = LogicalOperations::AND;
+    return {{SE(UnaryExpression{ComparisonOperations::LESS_THAN, "v", percent}),
+             SE(UnaryExpression{ComparisonOperations::NOT_EQUAL, "s", std::string("k7")}, AND),
+             SE(BinaryExpression{"price", ArithmeticOperations::MULTIPLY, "qty", ComparisonOperations::GREATER_THAN,
+                                 int64_t{50}},
+                AND),
+             SE(GeoExpression{"lat", "lon", GeoBox{{-60.0, -150.0}, {60.0, 150.0}}}, AND)}};
+  }
+
+  void Run(benchmark::State &state, int64_t density) {
+    std::vector<int64_t> v(kRows), price(kRows), qty(kRows);
+    std::vector<double> lat(kRows), lon(kRows);
+    std::vector<int32_t> offsets{0};
+    std::string data;
+    uint32_t x = 12345;
+    auto next = [&x] { return (x = x * 1103515245u + 12345u) >> 16; };
+    for (int64_t i = 0; i < kRows; ++i) {
+      v[i] = next() % 100;
+      price[i] = next() % 100;
+      qty[i] = next() % 10;
+      lat[i] = (next() % 180) - 90.0;
+      lon[i] = (next() % 360) - 180.0;
+      data += "k" + std::to_string(next() % 30);
+      offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+    ColumnBatch batch;
+    batch.addColumn("v", ColumnView::ofInt64(v.data(), kRows));
+    batch.addColumn("s", ColumnView::ofStrings(offsets.data(), data.data(), kRows));
+    batch.addColumn("price", ColumnView::ofInt64(price.data(), kRows));
+    batch.addColumn("qty", ColumnView::ofInt64(qty.data(), kRows));
+    batch.addColumn("lat", ColumnView::ofDouble(lat.data(), kRows));
+    batch.addColumn("lon", ColumnView::ofDouble(lon.data(), kRows));
+
+    BatchEvaluator evaluator;
+    evaluator.initialize(Chain(state.range(0)));
+    evaluator.setSelectionDensity(density);
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+
+  // Bench 1: whole columns
+  // ---------------------------------------
+  static void BM_WholeColumns(benchmark::State & state) { Run(state, 0); }
+  BENCHMARK(BM_WholeColumns)->Arg(1)->Arg(5)->Arg(12)->Arg(25)->Arg(50);
+
+  // Bench 2: selection vectors only
+  // ---------------------------------------
+  static void BM_SelectionVectors(benchmark::State & state) { Run(state, 1); }
+  BENCHMARK(BM_SelectionVectors)->Arg(1)->Arg(5)->Arg(12)->Arg(25)->Arg(50);
+
+  // Bench 3: per-clause switch (default density)
+  // ---------------------------------------
+  static void BM_Adaptive(benchmark::State & state) { Run(state, BatchEvaluator::kSelectionDensity); }
+  BENCHMARK(BM_Adaptive)->Arg(1)->Arg(5)->Arg(12)->Arg(25)->Arg(50);
+
+} // namespace
+
+BENCHMARK_MAIN();
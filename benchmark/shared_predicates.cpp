@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "predicate_registry.h"
+
+// N conditions of the form "region == R AND age > A AND tier == T OR score > S"
+// drawn from 8 regions, 16 ages, 4 tiers and 16 scores (44 distinct clauses),
+// each record checked against all of them: one Evaluator per condition vs a
+// PredicateRegistry sharing equal clauses. Arg 0 is N. Items/sec is records
+// per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr std::size_t kRecords = 256;
+  const char *const kRegions[] = {"eu", "us", "apac", "latam", "mena", "ca", "uk", "anz"};
+
+  uint32_t Next(uint32_t &x) {
+    x = x * 1103515245u + 12345u;
+    return x >> 16;
+  }
+
+  std::vector<FilterCondition> MakeConditions(int64_t n) {
+    std::vector<FilterCondition> conditions;
+    uint32_t x = 12345;
+    for (int64_t i = 0; i < n; ++i) {
+      conditions.push_back(FilterCondition{
+          {SE(UnaryExpression{ComparisonOperations::EQUAL, "region", std::string(kRegions[Next(x) % 8])}),
+           SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "age", int64_t{Next(x) % 16 * 5}},
+              LogicalOperations::AND),
+           SE(UnaryExpression{ComparisonOperations::EQUAL, "tier", int64_t{Next(x) % 4}}, LogicalOperations::AND),
+           SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "score", static_cast<double>(Next(x) % 16)},
+              LogicalOperations::OR)}});
+    }
+    return conditions;
+  }
+
+  std::vector<std::vector<Key>> MakeRecords() {
+    std::vector<std::vector<Key>> records;
+    uint32_t x = 777;
+    for (std::size_t r = 0; r < kRecords; ++r) {
+      records.push_back({Key("region", std::string(kRegions[Next(x) % 8])), Key("age", int64_t{Next(x) % 80}),
+                         Key("tier", int64_t{Next(x) % 4}), Key("score", static_cast<double>(Next(x) % 20))});
+    }
+    return records;
+  }
+
+  // Bench 1: one Evaluator per condition
+  // ---------------------------------------
+  static void BM_Evaluators(benchmark::State & state) {
+    const auto records = MakeRecords();
+    std::vector<Evaluator> evaluators(static_cast<std::size_t>(state.range(0)));
+    const auto conditions = MakeConditions(state.range(0));
+    for (std::size_t c = 0; c < conditions.size(); ++c) evaluators[c].initialize(conditions[c]);
+    std::vector<uint8_t> matches(conditions.size());
+    for (auto _ : state) {
+      for (const auto &keys : records) {
+        for (std::size_t c = 0; c < evaluators.size(); ++c) matches[c] = evaluators[c].evaluate(keys);
+        benchmark::DoNotOptimize(matches.data());
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+  BENCHMARK(BM_Evaluators)->Arg(100)->Arg(1000)->Arg(10000);
+
+  // Bench 2: PredicateRegistry
+  // ---------------------------------------
+  static void BM_Registry(benchmark::State & state) {
+    const auto records = MakeRecords();
+    PredicateRegistry registry;
+    for (const auto &condition : MakeConditions(state.range(0))) registry.add(condition);
+    std::vector<uint8_t> matches;
+    for (auto _ : state) {
+      for (const auto &keys : records) {
+        registry.evaluate(keys, matches);
+        benchmark::DoNotOptimize(matches.data());
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+    state.counters["predicates"] = static_cast<double>(registry.predicates());
+  }
+  BENCHMARK(BM_Registry)->Arg(100)->Arg(1000)->Arg(10000);
+
+} // namespace
+
+BENCHMARK_MAIN();
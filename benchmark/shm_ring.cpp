@@ -0,0 +1,227 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "shm_ring.h"
+#include "struct_binding.h"
+
+// Producer process -> filtering consumer process -> match results back.
+// Baseline: records written to a socket and rebuilt as std::vector<Key> on
+// the consumer side. Shared memory: records written into an SpscRing and
+// evaluated in place by RingFilterConsumer. Each benchmark forks its own
+// consumer; items/sec is records/sec end to end.
+
+struct Flow {
+  int64_t bytes;
+  int64_t packets;
+  double rtt_ms;
+  bool tcp;
+  char host[24];
+};
+EXPR_EVAL_STRUCT(Flow, EXPR_EVAL_FIELD(bytes), EXPR_EVAL_FIELD(packets),
+                 EXPR_EVAL_FIELD(rtt_ms), EXPR_EVAL_FIELD(tcp),
+                 EXPR_EVAL_FIELD(host));
+
+namespace {
+
+  constexpr std::size_t kRingCapacity = 4096;
+  constexpr std::size_t kBatch = 256;
+
+  using Channel = RingChannel<Flow, kRingCapacity>;
+
+  struct Shared {
+    Channel channel;
+    std::atomic<uint32_t> stop{0};
+  };
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "bytes",
+               static_cast<int64_t>(1024))),
+         SE(UE(ComparisonOperations::LESS_THAN, "rtt_ms", 50.0),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::EQUAL, "host",
+               std::string("db-primary-1")),
+            LogicalOperations::AND)}};
+  }
+
+  Flow MakeFlow(int64_t i) {
+    Flow f{(i * 37) % 4096, i % 100, static_cast<double>(i % 90), i % 2 == 0, {}};
+    std::strncpy(f.host, i % 3 ? "db-primary-1" : "web-edge-7", sizeof(f.host));
+    return f;
+  }
+
+  // Spin briefly, then give the core away (matters on small machines)
+  void Backoff(unsigned &spins) {
+    if (++spins > 64) {
+      std::this_thread::yield();
+      spins = 0;
+    }
+  }
+
+  // Runs the ring consumer in a child process until `stop` is set
+  pid_t ForkRingConsumer(const std::string &name) {
+    const pid_t pid = fork();
+    if (pid != 0) {
+      return pid;
+    }
+    SharedMemory shm =
+        SharedMemory::open(name, SharedMemory::bytesFor<Shared>());
+    Shared *shared = shm.attach<Shared>(); // constructed before the fork
+    RingFilterConsumer<Flow, kRingCapacity> consumer;
+    consumer.initialize(MakeCondition());
+    unsigned spins = 0;
+    while (true) {
+      if (consumer.poll(shared->channel) != 0) {
+        spins = 0;
+      } else if (shared->stop.load(std::memory_order_acquire)) {
+        _exit(0);
+      } else {
+        Backoff(spins);
+      }
+    }
+  }
+
+  struct RingSession {
+    std::string name = "/expr_eval_bench_" + std::to_string(getpid());
+    SharedMemory shm =
+        SharedMemory::create(name, SharedMemory::bytesFor<Shared>());
+    Shared *shared = shm.construct<Shared>();
+    pid_t consumer = ForkRingConsumer(name);
+
+    ~RingSession() {
+      shared->stop.store(1, std::memory_order_release);
+      waitpid(consumer, nullptr, 0);
+    }
+  };
+
+  // Bench 1: socket + std::vector<Key> rebuild per record (baseline)
+  // ---------------------------------------
+  static void BM_SocketKeyRebuild(benchmark::State & state) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      state.SkipWithError("socketpair failed");
+      return;
+    }
+    const pid_t pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      Evaluator evaluator;
+      evaluator.initialize(MakeCondition());
+      std::vector<Flow> in(kBatch);
+      std::vector<uint8_t> out(kBatch);
+      while (true) {
+        std::size_t got = 0;
+        while (got < sizeof(Flow) * kBatch) {
+          const ssize_t r = read(fds[1], reinterpret_cast<char *>(in.data()) + got,
+                                 sizeof(Flow) * kBatch - got);
+          if (r <= 0) _exit(0);
+          got += static_cast<std::size_t>(r);
+        }
+        for (std::size_t i = 0; i < kBatch; ++i) {
+          const Flow &f = in[i];
+          std::vector<Key> keys{Key("bytes", f.bytes), Key("packets", f.packets),
+                                Key("rtt_ms", f.rtt_ms), Key("tcp", f.tcp),
+                                Key("host", std::string(f.host))};
+          out[i] = evaluator.evaluate(keys);
+        }
+        if (write(fds[1], out.data(), kBatch) != static_cast<ssize_t>(kBatch)) _exit(1);
+      }
+    }
+    close(fds[1]);
+
+    std::vector<Flow> batch(kBatch);
+    for (std::size_t i = 0; i < kBatch; ++i) batch[i] = MakeFlow(static_cast<int64_t>(i));
+    std::vector<uint8_t> results(kBatch);
+    for (auto _ : state) {
+      if (write(fds[0], batch.data(), sizeof(Flow) * kBatch) < 0) break;
+      std::size_t got = 0;
+      while (got < kBatch) {
+        const ssize_t r = read(fds[0], results.data() + got, kBatch - got);
+        if (r <= 0) break;
+        got += static_cast<std::size_t>(r);
+      }
+      benchmark::DoNotOptimize(results.data());
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    state.SetItemsProcessed(state.iterations() * kBatch);
+  }
+  BENCHMARK(BM_SocketKeyRebuild)->UseRealTime();
+
+  // Bench 2: pipelined throughput through the shared-memory rings
+  // ---------------------------------------
+  static void BM_ShmRingThroughput(benchmark::State & state) {
+    RingSession session;
+    Channel &channel = session.shared->channel;
+    int64_t next = 0;
+    for (auto _ : state) {
+      std::size_t sent = 0, received = 0;
+      unsigned spins = 0;
+      while (received < kBatch) {
+        const std::size_t room = channel.records.writable(kBatch - sent);
+        const std::size_t n = room < kBatch - sent ? room : kBatch - sent;
+        for (std::size_t i = 0; i < n; ++i) channel.records.writeSlot(i) = MakeFlow(next++);
+        channel.records.publish(n);
+        sent += n;
+
+        const std::size_t ready = channel.results.readable();
+        for (std::size_t i = 0; i < ready; ++i) {
+          benchmark::DoNotOptimize(channel.results.readSlot(i).matched);
+        }
+        channel.results.release(ready);
+        received += ready;
+        if (n == 0 && ready == 0) Backoff(spins);
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+  }
+  BENCHMARK(BM_ShmRingThroughput)->UseRealTime();
+
+  // Bench 3: one record at a time, producer waits for its result (latency)
+  // ---------------------------------------
+  static void BM_ShmRingRoundTrip(benchmark::State & state) {
+    RingSession session;
+    Channel &channel = session.shared->channel;
+    int64_t next = 0;
+    MatchResult result{};
+    for (auto _ : state) {
+      while (!channel.records.tryPush(MakeFlow(next))) {
+      }
+      unsigned spins = 0;
+      while (!channel.results.tryPop(result)) Backoff(spins);
+      benchmark::DoNotOptimize(result);
+      ++next;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+  BENCHMARK(BM_ShmRingRoundTrip)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+
+// Time-window filter "ts >= start AND ts < end AND level > 2" over 1M rows of
+// ascending timestamps, with ts compared row by row vs marked sorted and
+// resolved by binary search. Arg 0 is the window width in rows. Items/sec is
+// rows of the whole batch per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr int64_t kRows = 1 << 20;
+
+  FilterCondition Window(int64_t width) {
+    const int64_t start = kRows / 2;
+    return {{SE(UnaryExpression{ComparisonOperations::GREATER_EQUAL, "ts", start * 10}),
+             SE(UnaryExpression{ComparisonOperations::LESS_THAN, "ts", (start + width) * 10}, LogicalOperations::AND),
+             SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "level", int64_t{2}}, LogicalOperations::AND)}};
+  }
+
+  void Run(benchmark::State &state, bool sorted) {
+    std::vector<int64_t> ts(kRows), level(kRows);
+    for (int64_t i = 0; i < kRows; ++i) {
+      ts[i] = i * 10;
+      level[i] = i % 5;
+    }
+    ColumnBatch batch;
+    batch.addColumn("ts", ColumnView::ofInt64(ts.data(), kRows));
+    batch.addColumn("level", ColumnView::ofInt64(level.data(), kRows));
+    batch.setSorted("ts", sorted);
+    BatchEvaluator evaluator;
+    evaluator.initialize(Window(state.range(0)));
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+
+  // Bench 1: every row compared
+  // ---------------------------------------
+  static void BM_WindowScan(benchmark::State & state) { Run(state, false); }
+  BENCHMARK(BM_WindowScan)->Arg(1000)->Arg(100000);
+
+  // Bench 2: sorted column, binary search
+  // ---------------------------------------
+  static void BM_WindowSorted(benchmark::State & state) { Run(state, true); }
+  BENCHMARK(BM_WindowSorted)->Arg(1000)->Arg(100000);
+
+} // namespace
+
+BENCHMARK_MAIN();
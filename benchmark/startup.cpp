@@ -0,0 +1,254 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Linux only: children are re-executed through /proc/self/exe
+#if defined(__linux__)
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#define STARTUP_BENCH_HAS_SPAWN 1
+#endif
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+// Startup / initialization costs. Every other benchmark builds its Evaluator
+// outside the timed loop; these ones time exactly that part.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  // A condition with `clauses` clauses spread over `distinct_keys` keys.
+  // Every fourth clause is a BinaryExpression so the mix resembles real rules.
+  FilterCondition MakeCondition(std::size_t clauses, std::size_t distinct_keys,
+                                int64_t salt = 0) {
+    FilterCondition cond;
+    cond.sub_expressions.reserve(clauses);
+    for (std::size_t i = 0; i < clauses; ++i) {
+      auto prev =
+          (i == 0) ? LogicalOperations::NONE
+                   : (i % 3 ? LogicalOperations::AND : LogicalOperations::OR);
+      const std::string key = "k" + std::to_string(i % distinct_keys);
+      if (i % 4 == 3) {
+        const std::string other =
+            "k" + std::to_string((i + 1) % distinct_keys);
+        cond.sub_expressions.push_back(
+            SE(BE(key, ArithmeticOperations::ADD, other,
+                  ComparisonOperations::LESS_THAN,
+                  static_cast<int64_t>(salt + static_cast<int64_t>(i))),
+               prev));
+      } else {
+        cond.sub_expressions.push_back(
+            SE(UE(ComparisonOperations::GREATER_EQUAL, key,
+                  static_cast<int64_t>(salt + static_cast<int64_t>(i))),
+               prev));
+      }
+    }
+    return cond;
+  }
+
+  std::vector<Key> MakeSequentialIntKeys(std::size_t n) {
+    std::vector<Key> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      keys.emplace_back("k" + std::to_string(i), static_cast<int64_t>(i));
+    }
+    return keys;
+  }
+
+  // Bench 1: initialize latency vs clause count
+  // ---------------------------------------
+  static void BM_InitializeByClauseCount(benchmark::State & state) {
+    const auto clauses = static_cast<std::size_t>(state.range(0));
+    const FilterCondition cond = MakeCondition(clauses, 8);
+    for (auto _ : state) {
+      Evaluator evaluator;
+      evaluator.initialize(cond);
+      benchmark::DoNotOptimize(evaluator);
+    }
+    state.counters["clauses/s"] = benchmark::Counter(
+        static_cast<double>(clauses), benchmark::Counter::kIsIterationInvariantRate);
+  }
+  BENCHMARK(BM_InitializeByClauseCount)->RangeMultiplier(4)->Range(1, 4096);
+
+  // Bench 2: initialize latency vs number of distinct keys referenced
+  // ---------------------------------------
+  static void BM_InitializeByKeyCount(benchmark::State & state) {
+    const auto distinct_keys = static_cast<std::size_t>(state.range(0));
+    const FilterCondition cond = MakeCondition(256, distinct_keys);
+    for (auto _ : state) {
+      Evaluator evaluator;
+      evaluator.initialize(cond);
+      benchmark::DoNotOptimize(evaluator);
+    }
+  }
+  BENCHMARK(BM_InitializeByKeyCount)->RangeMultiplier(4)->Range(1, 256);
+
+  // Bench 3: bulk load of many independent conditions
+  // ---------------------------------------
+  // Models process startup with a large rule set: every condition is built
+  // and initialized into its own Evaluator, and all of them stay alive.
+  static void BM_BulkLoadConditions(benchmark::State & state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<FilterCondition> conds;
+    conds.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      conds.push_back(MakeCondition(4, 8, static_cast<int64_t>(i)));
+    }
+    for (auto _ : state) {
+      std::vector<Evaluator> evaluators(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        evaluators[i].initialize(conds[i]);
+      }
+      benchmark::DoNotOptimize(evaluators.data());
+      state.PauseTiming();
+      evaluators.clear(); // teardown is not part of load time
+      state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+  }
+  BENCHMARK(BM_BulkLoadConditions)
+      ->Arg(10000)
+      ->Arg(100000)
+      ->Arg(1000000)
+      ->Unit(benchmark::kMillisecond)
+      ->Iterations(3);
+
+  // Bench 4: materializing a condition from an in-memory prototype
+  // ---------------------------------------
+  // There is no text syntax or serialized plan format yet, so the closest
+  // equivalent is building the FilterCondition itself (strings and variants
+  // included). This is the cost a loader pays before initialize.
+  static void BM_ConditionMaterialize(benchmark::State & state) {
+    const auto clauses = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+      FilterCondition cond = MakeCondition(clauses, 8);
+      benchmark::DoNotOptimize(cond.sub_expressions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(clauses));
+  }
+  BENCHMARK(BM_ConditionMaterialize)->RangeMultiplier(4)->Range(1, 4096);
+
+  // Bench 5: initialize + first evaluate in a warm process
+  // ---------------------------------------
+  static void BM_InitializeThenFirstEvaluate(benchmark::State & state) {
+    const auto clauses = static_cast<std::size_t>(state.range(0));
+    const FilterCondition cond = MakeCondition(clauses, 8);
+    const auto keys = MakeSequentialIntKeys(8);
+    for (auto _ : state) {
+      Evaluator evaluator;
+      evaluator.initialize(cond);
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+  }
+  BENCHMARK(BM_InitializeThenFirstEvaluate)->RangeMultiplier(4)->Range(1, 1024);
+
+#if defined(STARTUP_BENCH_HAS_SPAWN)
+  // Bench 6: cold-process time to first evaluation
+  // ---------------------------------------
+  // Re-executes this binary with a child flag and times spawn -> exit.
+  // The "noop" child only exits, so the difference between the two runs is
+  // the cost of getting from main() to the first evaluate() result.
+  const char *const kNoopChildFlag = "--startup-child-noop";
+  const char *const kEvalChildFlag = "--startup-child-first-eval";
+
+  int RunChild(const char *mode) {
+    if (std::strcmp(mode, kNoopChildFlag) == 0) {
+      return 0;
+    }
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition(64, 8));
+    const auto keys = MakeSequentialIntKeys(8);
+    return evaluator.evaluate(keys) ? 0 : 1;
+  }
+
+  // Runs this binary with `flag` and stores the spawn -> exit time in
+  // `seconds`. Returns an error message, or nullptr when the child ran and
+  // exited with status 0.
+  const char *SpawnAndWait(const char *flag, double &seconds) {
+    char self[] = "/proc/self/exe";
+    char *argv[] = {self, const_cast<char *>(flag), nullptr};
+    const auto start = std::chrono::steady_clock::now();
+    pid_t pid = 0;
+    if (posix_spawn(&pid, self, nullptr, nullptr, argv, environ) != 0) {
+      return "posix_spawn failed";
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid) {
+      return "waitpid failed";
+    }
+    const auto end = std::chrono::steady_clock::now();
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      return "child process failed";
+    }
+    seconds = std::chrono::duration<double>(end - start).count();
+    return nullptr;
+  }
+
+  static void BM_ColdProcess(benchmark::State & state, const char *flag) {
+    for (auto _ : state) {
+      double seconds = 0.0;
+      if (const char *error = SpawnAndWait(flag, seconds)) {
+        state.SkipWithError(error);
+        break;
+      }
+      state.SetIterationTime(seconds);
+    }
+  }
+  BENCHMARK_CAPTURE(BM_ColdProcess, noop, kNoopChildFlag)
+      ->UseManualTime()
+      ->Unit(benchmark::kMicrosecond);
+  BENCHMARK_CAPTURE(BM_ColdProcess, first_eval, kEvalChildFlag)
+      ->UseManualTime()
+      ->Unit(benchmark::kMicrosecond);
+#endif
+
+} // namespace
+
+int main(int argc, char **argv) {
+#if defined(STARTUP_BENCH_HAS_SPAWN)
+  if (argc == 2 && (std::strcmp(argv[1], kNoopChildFlag) == 0 ||
+                    std::strcmp(argv[1], kEvalChildFlag) == 0)) {
+    return RunChild(argv[1]);
+  }
+#endif
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "struct_binding.h"
+
+// Evaluating on a C++ struct: converting to std::vector<Key> per record
+// (what callers do today) vs StructEvaluator reading fields by offset.
+
+struct Event {
+  int64_t user_id;
+  int64_t bytes;
+  double latency_ms;
+  bool cached;
+  std::string region;
+};
+EXPR_EVAL_STRUCT(Event, EXPR_EVAL_FIELD(user_id), EXPR_EVAL_FIELD(bytes),
+                 EXPR_EVAL_FIELD(latency_ms), EXPR_EVAL_FIELD(cached),
+                 EXPR_EVAL_FIELD(region));
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "bytes",
+               static_cast<int64_t>(1024))),
+         SE(UE(ComparisonOperations::LESS_THAN, "latency_ms", 250.0),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::EQUAL, "region",
+               std::string("eu-west-1-primary")),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::EQUAL, "cached", false),
+            LogicalOperations::AND)}};
+  }
+
+  std::vector<Event> MakeEvents() {
+    std::vector<Event> events;
+    for (int i = 0; i < 1024; ++i) {
+      events.push_back(Event{i, (i * 37) % 4096, (i % 500) * 1.0, i % 3 == 0,
+                             i % 2 ? "eu-west-1-primary" : "us-east-1-primary"});
+    }
+    return events;
+  }
+
+  // Bench 1: struct -> std::vector<Key> -> Evaluator (today's hot path)
+  // ---------------------------------------
+  static void BM_ConvertThenEvaluate(benchmark::State & state) {
+    const auto events = MakeEvents();
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const Event &e = events[i++ & 1023];
+      std::vector<Key> keys{Key("user_id", e.user_id), Key("bytes", e.bytes),
+                            Key("latency_ms", e.latency_ms),
+                            Key("cached", e.cached), Key("region", e.region)};
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+  }
+  BENCHMARK(BM_ConvertThenEvaluate);
+
+  // Bench 2: StructEvaluator on the struct in place
+  // ---------------------------------------
+  static void BM_StructEvaluate(benchmark::State & state) {
+    const auto events = MakeEvents();
+    StructEvaluator<Event> evaluator;
+    evaluator.initialize(MakeCondition());
+    std::size_t i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(evaluator.evaluate(events[i++ & 1023]));
+    }
+  }
+  BENCHMARK(BM_StructEvaluate);
+
+} // namespace
+
+BENCHMARK_MAIN();
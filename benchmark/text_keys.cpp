@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+// Records whose fields arrive as text: converting every field up front vs
+// Key::text, which parses a field only if a clause compares it numerically.
+// The condition short-circuits on the first clause for most records, so only
+// a few of the sixteen numeric fields are ever parsed.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "f0",
+               static_cast<int64_t>(900))),
+         SE(UE(ComparisonOperations::LESS_THAN, "f1", 50.5),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::NOT_EQUAL, "f2",
+               static_cast<int64_t>(0)),
+            LogicalOperations::AND)}};
+  }
+
+  constexpr int kFields = 16;
+
+  std::vector<std::vector<std::string>> MakeRows() {
+    std::vector<std::vector<std::string>> rows;
+    for (int i = 0; i < 1024; ++i) {
+      std::vector<std::string> row;
+      for (int f = 0; f < kFields; ++f) {
+        row.push_back(f % 2 ? std::to_string((i * 7 + f) % 100) + ".0625e-3"
+                            : std::to_string((i * 13 + f) % 1000));
+      }
+      rows.push_back(std::move(row));
+    }
+    return rows;
+  }
+
+  std::vector<std::string> MakeNames() {
+    std::vector<std::string> names;
+    for (int f = 0; f < kFields; ++f) names.push_back("f" + std::to_string(f));
+    return names;
+  }
+
+  ValueType ConvertEager(const std::string &text, int field) {
+    if (field % 2) {
+      double d = 0;
+      std::from_chars(text.data(), text.data() + text.size(), d);
+      return d;
+    }
+    int64_t v = 0;
+    std::from_chars(text.data(), text.data() + text.size(), v);
+    return v;
+  }
+
+  // Bench 1: convert every field to a typed Key, then evaluate
+  // ---------------------------------------
+  static void BM_ConvertUpFront(benchmark::State & state) {
+    const auto rows = MakeRows();
+    const auto names = MakeNames();
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const auto &row = rows[i++ & 1023];
+      std::vector<Key> keys;
+      keys.reserve(kFields);
+      for (int f = 0; f < kFields; ++f) {
+        keys.emplace_back(names[f], ConvertEager(row[f], f));
+      }
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+  }
+  BENCHMARK(BM_ConvertUpFront);
+
+  // Bench 2: Key::text, parsed on demand
+  // ---------------------------------------
+  static void BM_LazyText(benchmark::State & state) {
+    const auto rows = MakeRows();
+    const auto names = MakeNames();
+    Evaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    std::size_t i = 0;
+    for (auto _ : state) {
+      const auto &row = rows[i++ & 1023];
+      std::vector<Key> keys;
+      keys.reserve(kFields);
+      for (int f = 0; f < kFields; ++f) {
+        keys.push_back(Key::text(names[f], row[f]));
+      }
+      benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+  }
+  BENCHMARK(BM_LazyText);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Your project headers
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+// "At least k of 8 signals": one ThresholdExpression vs the same rule expanded
+// into every k-combination of signals ANDed together (C(8, k) groups, any of
+// which suffices). Arg 0 is k. Items/sec is records (rows) per second.
+
+namespace {
+
+  // Helpers to build expressions/conditions
+  // ------------------------------------
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr int kSignals = 8;
+  constexpr std::size_t kRecords = 1024;
+  constexpr std::size_t kRows = 1 << 16;
+
+  std::string Signal(int i) { return "s" + std::to_string(i); }
+
+  SubExpression Fires(int i, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::GREATER_THAN, Signal(i), int64_t{0}}, prev);
+  }
+
+  FilterCondition Threshold(int64_t k) {
+    ThresholdExpression t{static_cast<std::size_t>(k), {}};
+    for (int i = 0; i < kSignals; ++i) t.children.push_back(FilterCondition{{Fires(i)}});
+    return FilterCondition{{SE(std::move(t))}};
+  }
+
+  // One AND group per k-subset of the signals, any of which suffices
+  FilterCondition Expanded(int64_t k) {
+    ThresholdExpression any{1, {}};
+    for (uint32_t bits = 0; bits < (1u << kSignals); ++bits) {
+      if (__builtin_popcount(bits) != k) continue;
+      FilterCondition group;
+      for (int i = 0; i < kSignals; ++i) {
+        if (bits >> i & 1) {
+          group.sub_expressions.push_back(
+              Fires(i, group.sub_expressions.empty() ? LogicalOperations::NONE : LogicalOperations::AND));
+        }
+      }
+      any.children.push_back(std::move(group));
+    }
+    return FilterCondition{{SE(std::move(any))}};
+  }
+
+  // Each signal fires for about 40% of records
+  std::vector<std::vector<int64_t>> MakeSignals(std::size_t n) {
+    std::vector<std::vector<int64_t>> signals(kSignals, std::vector<int64_t>(n));
+    uint32_t x = 12345;
+    for (std::size_t r = 0; r < n; ++r) {
+      for (int i = 0; i < kSignals; ++i) {
+        x = x * 1103515245u + 12345u;
+        signals[i][r] = (x >> 16) % 5 < 2 ? 1 : 0;
+      }
+    }
+    return signals;
+  }
+
+  void RunRow(benchmark::State &state, const FilterCondition &condition) {
+    const auto signals = MakeSignals(kRecords);
+    std::vector<std::vector<Key>> records(kRecords);
+    for (std::size_t r = 0; r < kRecords; ++r) {
+      for (int i = 0; i < kSignals; ++i) records[r].emplace_back(Signal(i), signals[i][r]);
+    }
+    Evaluator evaluator;
+    evaluator.initialize(condition);
+    for (auto _ : state) {
+      for (const auto &keys : records) benchmark::DoNotOptimize(evaluator.evaluate(keys));
+    }
+    state.SetItemsProcessed(state.iterations() * kRecords);
+  }
+
+  void RunBatch(benchmark::State &state, const FilterCondition &condition) {
+    const auto signals = MakeSignals(kRows);
+    ColumnBatch batch;
+    for (int i = 0; i < kSignals; ++i) {
+      batch.addColumn(Signal(i), ColumnView::ofInt64(signals[i].data(), static_cast<int64_t>(kRows)));
+    }
+    BatchEvaluator evaluator;
+    evaluator.initialize(condition);
+    std::vector<uint8_t> mask;
+    for (auto _ : state) {
+      evaluator.evaluate(batch, mask);
+      benchmark::DoNotOptimize(mask.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kRows);
+  }
+
+  // Bench 1: row path
+  // ---------------------------------------
+  static void BM_ThresholdRow(benchmark::State & state) { RunRow(state, Threshold(state.range(0))); }
+  BENCHMARK(BM_ThresholdRow)->Arg(1)->Arg(3)->Arg(6);
+
+  static void BM_ExpandedRow(benchmark::State & state) { RunRow(state, Expanded(state.range(0))); }
+  BENCHMARK(BM_ExpandedRow)->Arg(1)->Arg(3)->Arg(6);
+
+  // Bench 2: BatchEvaluator
+  // ---------------------------------------
+  static void BM_ThresholdBatch(benchmark::State & state) { RunBatch(state, Threshold(state.range(0))); }
+  BENCHMARK(BM_ThresholdBatch)->Arg(1)->Arg(3)->Arg(6);
+
+  static void BM_ExpandedBatch(benchmark::State & state) { RunBatch(state, Expanded(state.range(0))); }
+  BENCHMARK(BM_ExpandedBatch)->Arg(1)->Arg(3)->Arg(6);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "arrow_c_abi.h"
+#include "column_batch.h"
+#include "filter_structs.h"
+
+/**
+ * Column-at-a-time evaluation of a FilterCondition over a ColumnBatch.
+ *
+ * Each sub-expression is evaluated over a whole column into a byte mask (one
+ * 0/1 byte per row) with a tight per-operator loop the compiler vectorizes,
+ * and masks are folded with the same left-to-right AND/OR rules as the row
+ * path. A clause whose mask cannot change the running mask (nothing left to
+ * AND away, nothing left to OR in) is skipped.
+ *
+ * Type rules match LanguageParser. Null (invalid) rows never match a clause;
+ * a missing column throws ParseException("Key not found: ...").
+ *
+ * initialize() builds network sets and geo regions and checks threshold
+ * bounds once, so an invalid CIDR clause, region or k-of-n threshold throws
+ * there, as it does in LanguageParser::parse.
+ *
+ * Comparisons against a constant on a column marked sorted, in the trailing
+ * run of AND clauses (the whole condition when it has no OR), are resolved to
+ * a row interval by binary search; every clause then runs on that interval
+ * only and rows outside it are 0. Data-dependent errors outside the interval
+ * are not raised, since those rows can no longer match.
+ *
+ * Clauses after the first only need the rows they can still change (still
+ * true before AND, still false before OR). When those survivors are sparse,
+ * the clause is evaluated on a selection vector of their indices instead of
+ * the whole column; the switch is made per clause from the survivor count.
+ *
+ * Arithmetic columns are computed once per evaluate call and shared by every
+ * BinaryExpression clause and projection with the same keys and operator, so
+ *
+ *   evaluator.evaluate(batch, matches, {{"price", MULTIPLY, "qty"}}, totals);
+ *
+ * filters on "price * qty > 100" and returns the totals of matching rows in
+ * one pass over the inputs.
+ */
+
+// Values of one ArithmeticExpression over a batch: INTEGER when both columns
+// are integers, DOUBLE otherwise. Null rows (a null operand, or a row outside
+// the filter's matches) hold unspecified values.
+struct ProjectedColumn {
+  DataTypes type = DataTypes::INTEGER;
+  std::vector<int64_t> ints;     // INTEGER
+  std::vector<double> doubles;   // DOUBLE
+  std::vector<uint8_t> validity; // LSB-first bitmap, empty when no row is null
+
+  // Non-owning view, e.g. to add the values to another ColumnBatch
+  ColumnView view() const;
+};
+
+struct CompiledBatchCondition; // per-clause state built by initialize
+
+class BatchEvaluator {
+public:
+  BatchEvaluator();
+
+  void initialize(const FilterCondition &condition);
+
+  // matches[i] is 1 where row i satisfies the condition, 0 otherwise
+  void evaluate(const ColumnBatch &batch, std::vector<uint8_t> &matches) const;
+  // Also projects every matching row; out[j] holds projections[j]. Division
+  // by zero throws only in rows that match.
+  void evaluate(const ColumnBatch &batch, std::vector<uint8_t> &matches,
+                const std::vector<ArithmeticExpression> &projections,
+                std::vector<ProjectedColumn> &out) const;
+  // Ascending indices of matching rows
+  std::vector<uint32_t> select(const ColumnBatch &batch) const;
+  // The first `limit` of them. Rows are evaluated in slices that start at
+  // kLimitSliceRows and double, and evaluation stops once `limit` is reached.
+  std::vector<uint32_t> select(const ColumnBatch &batch, std::size_t limit) const;
+  // Whether any row matches, stopping at the slice that has one
+  bool any(const ColumnBatch &batch) const;
+  // Result as an Arrow boolean array ("b", no nulls). The caller owns both
+  // structs and must call their release callbacks.
+  void exportArrow(const ColumnBatch &batch, ArrowArray *out,
+                   ArrowSchema *out_schema) const;
+
+  // Projections of every row, without a filter
+  static void project(const ColumnBatch &batch,
+                      const std::vector<ArithmeticExpression> &projections,
+                      std::vector<ProjectedColumn> &out);
+
+  // Byte mask -> selection vector / Arrow boolean array
+  static std::vector<uint32_t> toSelection(const std::vector<uint8_t> &mask);
+  static void exportMask(const std::vector<uint8_t> &mask, ArrowArray *out,
+                         ArrowSchema *out_schema);
+
+  // AND / OR clauses run on a selection vector of the rows they can still
+  // change when at most 1 in `density` rows is left (1 in 4 * density before
+  // a numeric comparison), else on whole columns. 0 always evaluates whole
+  // columns.
+  void setSelectionDensity(int64_t density) { selection_density_ = density; }
+
+  static constexpr int64_t kSelectionDensity = 8;
+  static constexpr int64_t kLimitSliceRows = 1024;
+  static constexpr int64_t kMaxLimitSliceRows = 64 * 1024;
+
+private:
+  FilterCondition condition_;
+  std::shared_ptr<const CompiledBatchCondition> compiled_; // shared by copies
+  int64_t selection_density_ = kSelectionDensity;
+};
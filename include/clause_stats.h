@@ -0,0 +1,70 @@
+#pragma once
+
+#include "filter_structs.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Per-clause statistics that survive restarts.
+ *
+ * An adaptive Evaluator samples how often each sub-expression passes and how
+ * long it takes, and flushes those counts into a ClauseStatsStore keyed by the
+ * condition's structural fingerprint. The store is saved to / loaded from a
+ * compact binary file; on initialize, commutable clauses are reordered from
+ * the loaded statistics before the first record is evaluated.
+ */
+
+struct ClauseStats {
+  uint64_t evaluations = 0;
+  uint64_t passes = 0;
+  uint64_t cost_ns = 0; // summed over sampled evaluations
+
+  double passRate() const {
+    return evaluations ? static_cast<double>(passes) / evaluations : 0.0;
+  }
+  double costPerEvaluation() const {
+    return evaluations ? static_cast<double>(cost_ns) / evaluations : 0.0;
+  }
+};
+
+// Stable 64-bit hash of a condition's structure: operators, keys and
+// constants of every sub-expression, in order. Equal across processes.
+uint64_t conditionFingerprint(const FilterCondition &condition);
+
+// Evaluation order for `condition` given per-clause `stats` (indexed like
+// sub_expressions). Only clauses inside one commutable group move: a run of
+// clauses joined by the same AND/OR, plus the NONE clause that starts it.
+// Groups where any clause has fewer than `min_evaluations` samples keep
+// their written order, except that SampleExpression clauses of an AND group
+// move to its front, lowest rate first: their pass rate is known without
+// statistics. Returns original indices in evaluation order.
+std::vector<std::size_t> planClauseOrder(const FilterCondition &condition,
+                                         const std::vector<ClauseStats> &stats,
+                                         uint64_t min_evaluations = 32);
+
+// Rebuilds `condition` with sub-expressions in `order`. The logical operator
+// at each position is kept, so reordering inside commutable groups preserves
+// the result.
+FilterCondition reorderClauses(const FilterCondition &condition,
+                               const std::vector<std::size_t> &order);
+
+class ClauseStatsStore {
+public:
+  // Adds `stats` to the entry for `fingerprint`.
+  void merge(uint64_t fingerprint, const std::vector<ClauseStats> &stats);
+  // Copy of the entry for `fingerprint`, empty when unknown.
+  std::vector<ClauseStats> lookup(uint64_t fingerprint) const;
+  std::size_t size() const;
+
+  // Binary snapshot. load() merges the file's entries into the store. Both
+  // return false on I/O or format errors; a failed load changes nothing.
+  bool save(const std::string &path) const;
+  bool load(const std::string &path);
+
+private:
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, std::vector<ClauseStats>> entries_;
+};
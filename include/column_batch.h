@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arrow_c_abi.h"
+#include "enums.h"
+#include "ip_address.h"
+
+/**
+ * Columnar record batches for BatchEvaluator.
+ *
+ * A ColumnView is a non-owning view over one column laid out the Arrow way:
+ * contiguous int64/double values, LSB-first bitmaps for booleans and
+ * validity, int32 offsets + character data for strings, fixed-width
+ * network-order bytes (4 or 16 per row) for IP addresses. Views can wrap plain
+ * arrays or Arrow buffers imported through the C Data Interface; either way
+ * nothing is copied and the underlying memory must outlive the batch.
+ *
+ * A column marked `sorted` promises ascending values (no nulls, no NaN). Range
+ * and equality clauses on it that every match must pass are resolved by binary
+ * search, and the rest of the condition only runs inside that row interval.
+ */
+
+struct ColumnView {
+  DataTypes type = DataTypes::INTEGER;
+  int64_t length = 0;
+  int64_t offset = 0;                // element offset into the buffers
+  const uint8_t *validity = nullptr; // nullptr: every row is valid
+  const void *values = nullptr;      // int64_t / double / bool bitmap
+  const int32_t *offsets = nullptr;  // STRING only
+  const char *data = nullptr;        // STRING only
+  int32_t byte_width = 0;            // IP_ADDRESS only: 4 (IPv4) or 16 (IPv6)
+  bool sorted = false;               // ascending; ignored when validity is set
+
+  static ColumnView ofInt64(const int64_t *values, int64_t length);
+  static ColumnView ofDouble(const double *values, int64_t length);
+  static ColumnView ofBoolBitmap(const uint8_t *bitmap, int64_t length);
+  static ColumnView ofStrings(const int32_t *offsets, const char *data,
+                              int64_t length);
+  // 4 (IPv4) or 16 (IPv6) bytes per row in network byte order
+  static ColumnView ofIpv4(const uint8_t *bytes, int64_t length);
+  static ColumnView ofIpv6(const uint8_t *bytes, int64_t length);
+
+  bool isValid(int64_t row) const {
+    return !validity || bit(validity, offset + row);
+  }
+  int64_t int64At(int64_t row) const {
+    return static_cast<const int64_t *>(values)[offset + row];
+  }
+  double doubleAt(int64_t row) const {
+    return static_cast<const double *>(values)[offset + row];
+  }
+  bool boolAt(int64_t row) const {
+    return bit(static_cast<const uint8_t *>(values), offset + row);
+  }
+  std::string_view stringAt(int64_t row) const {
+    const int32_t begin = offsets[offset + row];
+    return std::string_view(data + begin,
+                            static_cast<std::size_t>(offsets[offset + row + 1] - begin));
+  }
+
+  uint32_t ipv4At(int64_t row) const {
+    return loadBigEndian32(static_cast<const uint8_t *>(values) + 4 * (offset + row));
+  }
+  IpAddress ipAt(int64_t row) const {
+    const auto *p = static_cast<const uint8_t *>(values) + byte_width * (offset + row);
+    if (byte_width == 4) {
+      return IpAddress::v4(loadBigEndian32(p));
+    }
+    return IpAddress::v6(uint64_t{loadBigEndian32(p)} << 32 | loadBigEndian32(p + 4),
+                         uint64_t{loadBigEndian32(p + 8)} << 32 | loadBigEndian32(p + 12));
+  }
+
+  static uint32_t loadBigEndian32(const uint8_t *p) {
+    return uint32_t{p[0]} << 24 | uint32_t{p[1]} << 16 | uint32_t{p[2]} << 8 | p[3];
+  }
+
+  static bool bit(const uint8_t *bitmap, int64_t i) {
+    return (bitmap[i >> 3] >> (i & 7)) & 1;
+  }
+};
+
+class ColumnBatch {
+public:
+  // Throws ParseException if the length differs from earlier columns.
+  void addColumn(const std::string &name, const ColumnView &column);
+  // nullptr when the batch has no such column
+  const ColumnView *find(const std::string &name) const;
+  // Marks a column as sorted ascending, e.g. after Arrow import. Throws
+  // ParseException for an unknown name.
+  void setSorted(const std::string &name, bool sorted = true);
+  int64_t numRows() const { return rows_; }
+  // Rows [offset, offset + length) of every column, still zero-copy
+  ColumnBatch slice(int64_t offset, int64_t length) const;
+  const std::vector<std::string> &names() const { return names_; }
+
+  // Zero-copy import of one Arrow array. Supported formats: "l" (int64),
+  // "g" (double), "u" (utf8), "b" (bool), "w:4" / "w:16" (IPv4 / IPv6
+  // addresses as fixed-size binary). Throws ParseException otherwise,
+  // including for dictionary-encoded arrays.
+  void addArrowColumn(const std::string &name, const ArrowArray &array,
+                      const ArrowSchema &schema);
+  // Zero-copy import of a struct array ("+s", e.g. an exported record batch):
+  // every child becomes a column named after its schema field. The batch
+  // does not take ownership; the producer's release callbacks stay with the
+  // caller and must not run while the batch is in use.
+  static ColumnBatch fromArrow(const ArrowArray &array, const ArrowSchema &schema);
+
+private:
+  std::vector<std::string> names_;
+  std::vector<ColumnView> columns_;
+  int64_t rows_ = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Low-overhead attribution of evaluate() cost to plan IDs.
+ *
+ * While enabled, every Evaluator::evaluate call bumps a per-thread call
+ * counter for its plan, and one call in every `sample period` is timed with
+ * the timestamp counter (rdtsc on x86). Each thread owns its own table, so the
+ * hot path never takes a lock or a contended cache line; report() merges all
+ * tables by reading their atomics, also without locks. Total cost per plan is
+ * estimated as mean sampled cycles x calls.
+ *
+ * A thread's table holds a few thousand plans. When a new plan finds no free
+ * slot, the least-called plan near its hash is evicted and its counts are
+ * reported under plan 0, so re-initialized evaluators never exhaust the table.
+ *
+ * Disabled (the default), the hot path is a single relaxed load in begin();
+ * end() only tests the token begin() returned.
+ */
+
+enum class CostOrder {
+  TOTAL,    // estimated total cycles
+  CALLS,    // number of evaluate calls
+  PER_CALL  // mean cycles per sampled call
+};
+
+struct ConditionCost {
+  uint64_t plan_id;
+  uint64_t calls;
+  uint64_t sampled_calls;
+  uint64_t sampled_cycles;
+
+  double cyclesPerCall() const {
+    return sampled_calls ? static_cast<double>(sampled_cycles) / sampled_calls
+                         : 0.0;
+  }
+  double estimatedTotalCycles() const { return cyclesPerCall() * calls; }
+};
+
+class CostProfiler {
+public:
+  static void setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Time one call in every `period` (per thread). 1 times every call.
+  static void setSamplePeriod(uint32_t period);
+
+  // Top `n` plans across all threads, ordered by `order` (descending).
+  static std::vector<ConditionCost> report(std::size_t n, CostOrder order);
+
+  // Drops every count recorded so far. Each table carries the reset epoch it
+  // was last cleared in; report() skips tables from an older epoch, and a
+  // thread clears its own table on its next call, so no thread ever writes
+  // another thread's slots.
+  static void reset();
+
+  // Hot-path hooks used by Evaluator::evaluate. begin() returns a token to
+  // pass back to end(): 0 when disabled, so end() needs no second load of
+  // the enabled flag; an odd timestamp when this call is sampled.
+  static uint64_t begin() { return isEnabled() ? beginSlow() : 0; }
+  static void end(uint64_t plan_id, uint64_t token) {
+    if (token != 0) {
+      endSlow(plan_id, token);
+    }
+  }
+
+private:
+  static uint64_t beginSlow();
+  static void endSlow(uint64_t plan_id, uint64_t token);
+
+  static inline std::atomic<bool> enabled_{false};
+};
@@ -23,9 +23,23 @@ enum class LogicalOperations {
   NONE
 };
 
+enum class ListQuantifier {
+  ANY,
+  ALL,
+  CONTAINS
+};
+
+enum class BitTest {
+  ALL,
+  ANY,
+  NONE,
+  FIELD_EQUAL
+};
+
 enum class DataTypes {
   BOOLEAN,
   INTEGER,
   DOUBLE,
-  STRING
+  STRING,
+  IP_ADDRESS
 };
\ No newline at end of file
@@ -1,14 +1,90 @@
 #pragma once
+#include "clause_stats.h"
+#include "cost_profiler.h"
 #include "parser.h"
+#include "probes.h"
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
 
 class Evaluator {
 public:
   void initialize(const FilterCondition &condition) {
-    evaluator_ = LanguageParser::parse(condition);
+    const uint64_t new_id = nextPlanId();
+    EXPR_EVAL_PROBE2(initialize_start, new_id,
+                     condition.sub_expressions.size());
+    flushStats();
+    stats_store_ = nullptr;
+    clauses_.reset();
+    clause_stats_.clear();
+    // Written order, apart from sample clauses hoisted in AND groups
+    clause_order_ = planClauseOrder(condition, {});
+    install(new_id, condition,
+            LanguageParser::parse(reorderClauses(condition, clause_order_)));
   }
-  bool evaluate(const std::vector<Key> &keys) { return evaluator_(keys); }
+  // Adaptive initialize: commutable clauses are ordered from the statistics
+  // `stats` holds for this condition, and one call in kStatsSamplePeriod
+  // records per-clause pass rate and cost until flushStats() merges them
+  // back. `stats` must outlive that use; an adaptive Evaluator must not be
+  // evaluated from several threads at once.
+  void initialize(const FilterCondition &condition, ClauseStatsStore &stats);
+
+  bool evaluate(const std::vector<Key> &keys) {
+    EXPR_EVAL_PROBE1(evaluate_entry, plan_id_);
+    const uint64_t start = CostProfiler::begin();
+    const bool result =
+        stats_store_ && --stats_countdown_ == 0 ? evaluateSampled(keys)
+                                                : evaluator_(keys);
+    CostProfiler::end(plan_id_, start);
+    EXPR_EVAL_PROBE2(evaluate_return, plan_id_, result);
+    return result;
+  }
+
+  // Merges statistics collected since the last flush into the store given
+  // to the adaptive initialize. No-op otherwise.
+  void flushStats();
+
+  // Process-unique ID of the current plan (0 before initialize). Every
+  // initialize call produces a new ID, so re-initializing is a plan swap.
+  uint64_t getPlanId() const { return plan_id_; }
+
+  // Evaluation order as indices into the initialized sub_expressions.
+  const std::vector<std::size_t> &getClauseOrder() const {
+    return clause_order_;
+  }
+
+  static constexpr uint32_t kStatsSamplePeriod = 16;
 
 private:
+  static uint64_t nextPlanId() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Swaps in a plan compiled since initialize_start fired for `new_id`
+  void install(uint64_t new_id, const FilterCondition &condition,
+               std::function<bool(const std::vector<Key> &)> compiled) {
+    const auto clauses = condition.sub_expressions.size();
+    if (plan_id_ != 0) {
+      EXPR_EVAL_PROBE2(plan_swap, plan_id_, new_id);
+    }
+    evaluator_ = std::move(compiled);
+    plan_id_ = new_id;
+    EXPR_EVAL_PROBE2(initialize_end, new_id, clauses);
+  }
+
+  bool evaluateSampled(const std::vector<Key> &keys);
+
   std::function<bool(const std::vector<Key> &)> evaluator_;
-};
\ No newline at end of file
+  uint64_t plan_id_ = 0;
+
+  // Adaptive mode only
+  ClauseStatsStore *stats_store_ = nullptr;
+  uint64_t fingerprint_ = 0;
+  // Evaluation order; shared with evaluator_
+  std::shared_ptr<const std::vector<CompiledClause>> clauses_;
+  std::vector<std::size_t> clause_order_;       // position -> original index
+  std::vector<ClauseStats> clause_stats_;       // by original index
+  uint32_t stats_countdown_ = kStatsSamplePeriod;
+};
@@ -5,6 +5,7 @@
 #include <variant>
 
 #include "enums.h"
+#include "geo.h"
 #include "key.h"
 
 // A filter condition structure is like (subexpression operator subexpression ...)
@@ -25,8 +26,91 @@ struct BinaryExpression {
   ValueType value; // could be a key or a constant
 };
 
+// The arithmetic half of a BinaryExpression, evaluated to a value instead of
+// compared: int64_t when both keys are integers, double otherwise. Used for
+// projections (LanguageParser::project, BatchEvaluator::project).
+struct ArithmeticExpression {
+  std::string left_key;
+  ArithmeticOperations arith_op;
+  std::string right_key;
+};
+
+// Predicate over a list-valued key (Key::list or Key::array). Per element,
+// EQUAL tests membership in `values`, NOT_EQUAL non-membership, and ordered
+// operators compare with the single value in `values`.
+//   ANY:      some element satisfies it     (false for an empty list)
+//   ALL:      every element satisfies it    (true for an empty list)
+//   CONTAINS: the list holds every one of `values`; `op` is ignored
+struct ListExpression {
+  ListQuantifier quantifier;
+  std::string key;
+  ComparisonOperations op;
+  std::vector<ValueType> values;
+};
+
+// Network membership of an address key: EQUAL holds when the address lies in
+// any of `networks`, NOT_EQUAL when it lies in none. Networks of both families
+// may be mixed; an address only matches networks of its own family.
+struct CidrExpression {
+  std::string key;
+  ComparisonOperations op;
+  std::vector<Cidr> networks;
+};
+
+// Whether the point (lat_key, lon_key) lies in `region`. Both keys hold
+// degrees as doubles (integers and numeric text are converted).
+struct GeoExpression {
+  std::string lat_key;
+  std::string lon_key;
+  GeoRegionSpec region;
+};
+
+// Flag test on an integer key. With bits = (key >> shift) & mask:
+//   ALL:         bits == mask   (every flag of the mask is set)
+//   ANY:         bits != 0      (some flag is set)
+//   NONE:        bits == 0      (no flag is set)
+//   FIELD_EQUAL: bits == value  (a packed field holds `value`)
+struct BitmaskExpression {
+  BitTest test;
+  std::string key;
+  int64_t mask;
+  int shift = 0;
+  int64_t value = 0; // FIELD_EQUAL only
+};
+
+// Deterministic sample by the value of `key`: passes for about `rate` (in
+// [0, 1]) of distinct values, the same values in every process for a given
+// seed. Integer keys are hashed by value, string and text keys by their bytes.
+struct SampleExpression {
+  std::string key;
+  double rate;
+  uint64_t seed = 0;
+};
+
+// Whether the record has `key` (EXISTS) or lacks it (NOT EXISTS, exists =
+// false). Never throws for a missing key. On columns a null row counts as
+// missing.
+struct ExistsExpression {
+  std::string key;
+  bool exists = true;
+};
+
+struct FilterCondition;
+
+// At least `min_count` of `children` hold ("3 of these 8 signals"), with
+// 1 <= min_count <= children.size(). Children are evaluated in order until
+// the outcome is decided, so later children may not be looked at.
+struct ThresholdExpression {
+  std::size_t min_count;
+  std::vector<FilterCondition> children;
+};
+
+using Expression = std::variant<UnaryExpression, BinaryExpression, ListExpression,
+                                CidrExpression, GeoExpression, BitmaskExpression,
+                                SampleExpression, ThresholdExpression, ExistsExpression>;
+
 struct SubExpression {
-  std::variant<UnaryExpression, BinaryExpression> expr;
+  Expression expr;
   LogicalOperations prev_logical_op; // AND, OR
 };
 
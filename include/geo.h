@@ -0,0 +1,38 @@
+#pragma once
+
+#include <variant>
+#include <vector>
+
+/**
+ * Regions for GeoExpression. Coordinates are WGS84 degrees: latitude in
+ * [-90, 90], longitude in [-180, 180].
+ */
+
+struct GeoPoint {
+  double lat;
+  double lon;
+};
+
+// Inclusive on every edge. A box whose west edge lies east of its east edge
+// crosses the antimeridian (e.g. west 170, east -170).
+struct GeoBox {
+  GeoPoint south_west;
+  GeoPoint north_east;
+};
+
+// Points within `radius_m` meters of `center` along the great circle
+// (haversine on a sphere of the mean Earth radius).
+struct GeoCircle {
+  GeoPoint center;
+  double radius_m;
+};
+
+// Points inside any of the rings (even-odd rule, each ring implicitly closed,
+// at least three vertices). Edges are straight lines in lat/lon space and
+// rings must not cross the antimeridian; points exactly on an edge may fall
+// either way.
+struct GeoPolygons {
+  std::vector<std::vector<GeoPoint>> rings;
+};
+
+using GeoRegionSpec = std::variant<GeoBox, GeoCircle, GeoPolygons>;
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+/**
+ * An IPv4 or IPv6 address held as an integer: IPv4 in the low 32 bits, IPv6
+ * as two 64-bit halves, most significant first. Addresses order by family
+ * (every IPv4 address before every IPv6 one) and then numerically, so
+ * comparisons are plain integer compares. IPv4-mapped IPv6 addresses
+ * ("::ffff:10.0.0.1") stay IPv6 and do not equal their IPv4 form.
+ */
+
+class IpAddress {
+public:
+  enum class Family : uint8_t { V4, V6 };
+
+  IpAddress() = default; // 0.0.0.0
+  static IpAddress v4(uint32_t address) { return IpAddress(Family::V4, 0, address); }
+  static IpAddress v6(uint64_t high, uint64_t low) { return IpAddress(Family::V6, high, low); }
+
+  // Dotted quad or RFC 4291 text (with "::" and a dotted IPv4 tail); false
+  // if the text is not a complete address
+  static bool parse(std::string_view text, IpAddress &out);
+  // As parse, throwing ParseException on malformed text
+  static IpAddress fromString(std::string_view text);
+
+  Family family() const { return family_; }
+  bool isV4() const { return family_ == Family::V4; }
+  uint32_t v4Bits() const { return static_cast<uint32_t>(low_); }
+  uint64_t high() const { return high_; }
+  uint64_t low() const { return low_; }
+  // Dotted quad, or lower-case IPv6 with the longest zero run compressed
+  std::string str() const;
+
+  friend bool operator==(const IpAddress &l, const IpAddress &r) { return l.tie() == r.tie(); }
+  friend bool operator!=(const IpAddress &l, const IpAddress &r) { return l.tie() != r.tie(); }
+  friend bool operator<(const IpAddress &l, const IpAddress &r) { return l.tie() < r.tie(); }
+  friend bool operator>(const IpAddress &l, const IpAddress &r) { return l.tie() > r.tie(); }
+  friend bool operator<=(const IpAddress &l, const IpAddress &r) { return l.tie() <= r.tie(); }
+  friend bool operator>=(const IpAddress &l, const IpAddress &r) { return l.tie() >= r.tie(); }
+
+private:
+  IpAddress(Family family, uint64_t high, uint64_t low)
+      : high_(high), low_(low), family_(family) {}
+
+  std::tuple<Family, uint64_t, uint64_t> tie() const { return {family_, high_, low_}; }
+
+  uint64_t high_ = 0;
+  uint64_t low_ = 0;
+  Family family_ = Family::V4;
+};
+
+/**
+ * A network: the addresses of one family sharing the first `prefix` bits of
+ * `network`. Host bits of `network` are cleared on construction.
+ */
+
+class Cidr {
+public:
+  Cidr() = default;
+  // Throws ParseException if prefix exceeds 32 (IPv4) or 128 (IPv6)
+  Cidr(IpAddress network, unsigned prefix);
+
+  // "10.0.0.0/8", "2001:db8::/32"; a bare address is a full-length prefix
+  static bool parse(std::string_view text, Cidr &out);
+  static Cidr fromString(std::string_view text);
+
+  const IpAddress &network() const { return network_; }
+  unsigned prefix() const { return prefix_; }
+  // Lowest and highest address in the network
+  IpAddress first() const { return network_; }
+  IpAddress last() const;
+  bool contains(const IpAddress &address) const;
+  std::string str() const;
+
+  // Network mask of an IPv4 prefix (0-32)
+  static uint32_t v4Mask(unsigned prefix) {
+    return prefix == 0 ? 0 : ~0u << (32 - prefix);
+  }
+  // Network mask of an IPv6 prefix within the 64-bit half that starts at bit
+  // `offset` (0 for high(), 64 for low())
+  static uint64_t v6HalfMask(unsigned prefix, unsigned offset) {
+    if (prefix <= offset) return 0;
+    if (prefix >= offset + 64) return ~0ull;
+    return ~0ull << (64 - (prefix - offset));
+  }
+
+private:
+  IpAddress network_;
+  unsigned prefix_ = 0;
+};
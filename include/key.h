@@ -1,20 +1,184 @@
 #pragma once
+#include <charconv>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <variant>
 #include <vector>
 
-using ValueType = std::variant<int64_t, double, std::string, bool>;
+#include "enums.h"
+#include "ip_address.h"
+
+using ValueType = std::variant<int64_t, double, std::string, bool, IpAddress>;
+
+// Packed homogeneous list payload of Key::array
+using ArrayValue = std::variant<std::vector<int64_t>, std::vector<double>,
+                                std::vector<std::string>>;
 
 class Key {
 public:
-  Key(const std::string &name, const ValueType &value)
-      : name_(name), value_(value) {}
+  Key(std::string name, ValueType value)
+      : name_(std::move(name)), value_(std::move(value)) {}
+
+  Key(const Key &other)
+      : name_(other.name_), value_(other.value_),
+        side_(other.side_ ? std::make_unique<Side>(*other.side_) : nullptr) {}
+  Key(Key &&) noexcept = default;
+  Key &operator=(const Key &other) {
+    if (this != &other) {
+      Key copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+  Key &operator=(Key &&) noexcept = default;
+
+  // A value that arrived as text (CSV, JSON, query strings) and may hold a
+  // number. It compares as a string against string constants; the first time
+  // a clause needs it as a number it is parsed with std::from_chars and the
+  // result is cached in the key for later clauses. The cache makes the key
+  // unsafe to evaluate from several threads at once.
+  static Key text(std::string name, std::string text) {
+    Key key(std::move(name), std::move(text));
+    key.side().text = true;
+    return key;
+  }
+
+  // Nested records. An object holds named fields; a list holds elements
+  // (their names are ignored) addressed by position. Conditions reach into
+  // them with dotted paths such as "user.geo.country" or "items.0.price".
+  // Children are immutable and shared between copies of the key.
+  static Key object(std::string name, std::vector<Key> fields) {
+    return Key(std::move(name), Kind::OBJECT, std::move(fields));
+  }
+  static Key list(std::string name, std::vector<Key> elements) {
+    return Key(std::move(name), Kind::LIST, std::move(elements));
+  }
+  static Key list(std::string name, const std::vector<ValueType> &values) {
+    std::vector<Key> elements;
+    elements.reserve(values.size());
+    for (const auto &value : values) {
+      elements.emplace_back(std::string(), value);
+    }
+    return list(std::move(name), std::move(elements));
+  }
+  // A list of int64, double or string values stored contiguously, for list
+  // predicates (ANY / ALL / CONTAINS) that scan it in bulk. Its elements are
+  // not addressable by path.
+  static Key array(std::string name, ArrayValue values) {
+    Key key(std::move(name), false);
+    key.side().kind = Kind::ARRAY;
+    key.side().payload = std::make_shared<const ArrayValue>(std::move(values));
+    return key;
+  }
 
   const std::string &getName() const { return name_; }
   const ValueType &getValue() const { return value_; }
-  void setValue(const ValueType &value) { value_ = value; }
+  void setValue(const ValueType &value) {
+    value_ = value;
+    side_.reset();
+  }
+
+  bool isObject() const { return kind() == Kind::OBJECT; }
+  bool isList() const { return kind() == Kind::LIST; }
+  bool isArray() const { return kind() == Kind::ARRAY; }
+  bool isScalar() const { return kind() == Kind::SCALAR; }
+  // Fields of an object or elements of a list; empty otherwise
+  const std::vector<Key> &children() const {
+    static const std::vector<Key> none;
+    return isObject() || isList()
+               ? *static_cast<const std::vector<Key> *>(side_->payload.get())
+               : none;
+  }
+  // Values of an array key; nullptr otherwise
+  const ArrayValue *array() const {
+    return isArray() ? static_cast<const ArrayValue *>(side_->payload.get())
+                     : nullptr;
+  }
+
+  bool isText() const { return side_ && side_->text; }
+
+  // Text keys only: parses the whole text as `type` (INTEGER or DOUBLE) into
+  // `out`. Returns false when the text is not such a number, or when the key
+  // is not text. Integer and double results are cached separately, so
+  // clauses alternating between the two types parse each at most once.
+  bool parseNumber(DataTypes type, ValueType &out) const {
+    if (!isText()) {
+      return false;
+    }
+    Side &side = *side_;
+    if (type == DataTypes::INTEGER) {
+      if (!(side.parsed & (INTEGER_OK | INTEGER_BAD))) {
+        side.parsed |=
+            parseWhole(side.integer) ? INTEGER_OK : INTEGER_BAD;
+      }
+      if (side.parsed & INTEGER_BAD) return false;
+      out = side.integer;
+      return true;
+    }
+    if (!(side.parsed & (DOUBLE_OK | DOUBLE_BAD))) {
+      side.parsed |= parseWhole(side.real) ? DOUBLE_OK : DOUBLE_BAD;
+    }
+    if (side.parsed & DOUBLE_BAD) return false;
+    out = side.real;
+    return true;
+  }
+
+  // Text keys only: the text parsed as an INTEGER, else as a DOUBLE (both
+  // cached). Returns false when it is neither.
+  bool parseAnyNumber(ValueType &out) const {
+    return parseNumber(DataTypes::INTEGER, out) ||
+           parseNumber(DataTypes::DOUBLE, out);
+  }
 
 private:
+  enum class Kind : uint8_t { SCALAR, OBJECT, LIST, ARRAY };
+
+  Key(std::string name, Kind kind, std::vector<Key> children)
+      : name_(std::move(name)), value_(false) {
+    side().kind = kind;
+    side().payload =
+        std::make_shared<const std::vector<Key>>(std::move(children));
+  }
+
+  // Which parses of a text key have run, and whether each succeeded
+  enum ParsedBits : uint8_t {
+    INTEGER_OK = 1,
+    INTEGER_BAD = 2,
+    DOUBLE_OK = 4,
+    DOUBLE_BAD = 8
+  };
+
+  template <typename T> bool parseWhole(T &value) const {
+    const std::string &text = std::get<std::string>(value_);
+    const char *end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    return ec == std::errc() && ptr == end && !text.empty();
+  }
+
+  // State of text and nested keys, kept out of line so a plain scalar key
+  // only adds a null pointer to its name and value. Copying a key copies its
+  // text cache and shares its payload.
+  struct Side {
+    Kind kind = Kind::SCALAR;
+    bool text = false;
+    uint8_t parsed = 0; // ParsedBits
+    int64_t integer = 0; // valid with INTEGER_OK
+    double real = 0.0;   // valid with DOUBLE_OK
+    // Immutable, shared by copies: std::vector<Key> for OBJECT / LIST,
+    // ArrayValue for ARRAY
+    std::shared_ptr<const void> payload;
+  };
+
+  Kind kind() const { return side_ ? side_->kind : Kind::SCALAR; }
+  Side &side() {
+    if (!side_) side_ = std::make_unique<Side>();
+    return *side_;
+  }
+
   std::string name_;
   ValueType value_;
+  std::unique_ptr<Side> side_; // null for plain scalars
 };
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "key.h"
+
+/**
+ * A key reference from a condition, resolved once when the condition is
+ * compiled.
+ *
+ * "a.b.c" is split into segments up front; all-digit segments are list
+ * positions. Each named segment remembers the position it was found at last
+ * time (a relaxed atomic, so compiled conditions stay shareable between
+ * threads), and lookup checks that position before scanning. Records with a
+ * stable field order therefore resolve every hop with one pointer step and
+ * one name check.
+ *
+ * A dotted name that is not present as a nested path is looked up as a flat
+ * key of that name, so records that flatten "user.geo.country" into a single
+ * Key keep working. The nested path always takes precedence: a record holding
+ * both forms resolves to the nested key, whatever earlier records held.
+ */
+
+class KeyPath {
+public:
+  explicit KeyPath(const std::string &path);
+
+  // nullptr when the record has no such key
+  const Key *find(const std::vector<Key> &keys) const;
+
+  const std::string &str() const { return path_; }
+  bool isNested() const { return segments_.size() > 1; }
+
+private:
+  struct Segment {
+    std::string name;
+    bool is_position = false; // list element number, stored in `position`
+    uint32_t position = 0;
+    std::unique_ptr<std::atomic<uint32_t>> hint; // named segments only
+  };
+
+  static const Key *findField(const std::vector<Key> &keys,
+                              const std::string &name,
+                              std::atomic<uint32_t> &hint);
+  const Key *findNested(const std::vector<Key> &keys) const;
+
+  std::string path_;
+  std::vector<Segment> segments_;
+  std::unique_ptr<std::atomic<uint32_t>> flat_hint_; // whole-path fallback
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "filter_structs.h"
+#include "key.h"
+
+class KeyPath;
+
+/**
+ * Presence bitmasks over a fixed list of up to 64 key names.
+ *
+ * Bit i of a presence mask says whether the record has the schema's i-th key.
+ * A producer that already knows which fields it filled can hand the mask over
+ * directly; otherwise presence() computes it from a std::vector<Key> (dotted
+ * names resolve like condition keys, with the same position hints).
+ *
+ * rule() reduces a condition to the keys it cannot match without: every key
+ * referenced by the trailing run of AND clauses (the whole condition when it
+ * has no OR), since a record only matches when all of those pass. EXISTS /
+ * NOT EXISTS clauses in that run become required / forbidden bits. Records a
+ * rule rejects would evaluate to false or throw "Key not found", so
+ *
+ *   KeySchema schema({"user_id", "country", "score"});
+ *   const PresenceRule rule = schema.rule(condition);
+ *   bool match = rule.admits(presence) && evaluator.evaluate(keys);
+ *
+ * turns incomplete records into one AND instead of an exception, or lets the
+ * caller route them elsewhere. Keys outside the schema are left to evaluation.
+ */
+
+struct PresenceRule {
+  uint64_t required = 0;  // bits that must be set
+  uint64_t forbidden = 0; // bits that must be clear (NOT EXISTS)
+
+  bool admits(uint64_t presence) const {
+    return ((presence & required) == required) & ((presence & forbidden) == 0);
+  }
+};
+
+class KeySchema {
+public:
+  static constexpr std::size_t kMaxKeys = 64;
+
+  // Throws ParseException for more than kMaxKeys names or duplicates
+  explicit KeySchema(std::vector<std::string> names);
+  ~KeySchema();
+  KeySchema(KeySchema &&) noexcept;
+  KeySchema &operator=(KeySchema &&) noexcept;
+
+  std::size_t size() const { return names_.size(); }
+  const std::vector<std::string> &names() const { return names_; }
+  // Bit of `name`, 0 when it is not in the schema
+  uint64_t bit(const std::string &name) const;
+
+  // Presence mask of `keys`
+  uint64_t presence(const std::vector<Key> &keys) const;
+
+  PresenceRule rule(const FilterCondition &condition) const;
+
+private:
+  std::vector<std::string> names_;
+  std::vector<std::unique_ptr<KeyPath>> paths_;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "key.h"
+#include "parser.h"
+#include "scan.h"
+
+/**
+ * Matching records as views into their source instead of copies.
+ *
+ * Filtering a record set usually ends with copying the matches into a new
+ * container, which touches every matching key twice. matchRecords() returns a
+ * RecordMatches instead: the indices of matching records plus a pointer to
+ * the source, and project() resolves only the keys a caller asks for, to
+ * pointers into the source records:
+ *
+ *   const RecordMatches matches = matchRecords(predicate, records);
+ *   for (const Key *user : matches.project("user.id")) ...
+ *
+ * partitionMatches() is the in-place alternative for a record set the caller
+ * owns: matching records are swapped to the front in their original order,
+ * without allocating, and the number of matches is returned.
+ *
+ * BatchMatches is the column form: matching row indices of a ColumnBatch, with
+ * columns read through them on demand, and gather() copying one numeric
+ * column's matching values into a dense ProjectedColumn.
+ *
+ * Views do not own their source; it must outlive them and stay unmodified.
+ */
+
+class RecordMatches {
+public:
+  RecordMatches(const std::vector<std::vector<Key>> &records, std::vector<std::size_t> indices)
+      : records_(&records), indices_(std::move(indices)) {}
+
+  std::size_t size() const { return indices_.size(); }
+  bool empty() const { return indices_.empty(); }
+  const std::vector<std::size_t> &indices() const { return indices_; }
+  // Index into the source of the k-th match
+  std::size_t index(std::size_t k) const { return indices_[k]; }
+  const std::vector<Key> &operator[](std::size_t k) const { return (*records_)[indices_[k]]; }
+
+  // Key `path` (dotted, like condition keys) of every match, nullptr where a
+  // record lacks it
+  std::vector<const Key *> project(const std::string &path) const;
+  // Copies of the matching records, for callers that need a container
+  std::vector<std::vector<Key>> materialize() const;
+
+private:
+  const std::vector<std::vector<Key>> *records_;
+  std::vector<std::size_t> indices_;
+};
+
+// Matches of `predicate` in `records`; options as for scanMatches
+RecordMatches matchRecords(const KeyPredicate &predicate, const std::vector<std::vector<Key>> &records,
+                           const ScanOptions &options = {});
+
+// Moves matching records to the front of `records`, keeping their relative
+// order (the order of the rest is unspecified), and returns their number. The
+// predicate runs once per record. If it throws, the records are permuted but
+// none is lost.
+std::size_t partitionMatches(const KeyPredicate &predicate, std::vector<std::vector<Key>> &records);
+
+class BatchMatches {
+public:
+  BatchMatches(const ColumnBatch &batch, std::vector<uint32_t> rows)
+      : batch_(&batch), rows_(std::move(rows)) {}
+
+  std::size_t size() const { return rows_.size(); }
+  bool empty() const { return rows_.empty(); }
+  const std::vector<uint32_t> &rows() const { return rows_; }
+  // Batch row of the k-th match, to read a column() with
+  int64_t row(std::size_t k) const { return rows_[k]; }
+
+  // Throws ParseException("Key not found: ...") for a missing column
+  const ColumnView &column(const std::string &name) const;
+  // Dense copy of an INTEGER or DOUBLE column's matching values
+  void gather(const std::string &name, ProjectedColumn &out) const;
+
+private:
+  const ColumnBatch *batch_;
+  std::vector<uint32_t> rows_;
+};
+
+// Matching rows of `batch`
+BatchMatches matchRows(const BatchEvaluator &evaluator, const ColumnBatch &batch);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "filter_structs.h"
+#include "parser.h"
+
+/**
+ * Coalesces concurrent single-record evaluate calls on one plan.
+ *
+ * MicroBatchEvaluator has Evaluator's single-record API, but instead of each
+ * caller running the compiled condition alone, calls are queued and a worker
+ * thread evaluates them together in one tight loop over the batch, keeping the
+ * plan hot in cache. A batch is closed when it reaches max_batch records or
+ * when its oldest call has waited max_wait, whichever comes first; every
+ * caller's future is then completed (with the ParseException, if its record
+ * raised one).
+ *
+ * submit() is the asynchronous form: the keys must stay alive until the
+ * future is ready. evaluate() submits and waits. initialize() may run
+ * concurrently with evaluation; batches already taken finish on the old plan.
+ */
+
+struct MicroBatchOptions {
+  std::chrono::microseconds max_wait{20};
+  std::size_t max_batch = 64;
+};
+
+class MicroBatchEvaluator {
+public:
+  // Throws ParseException if options.max_batch is 0.
+  explicit MicroBatchEvaluator(MicroBatchOptions options = {});
+  // Completes every queued call, then stops the worker.
+  ~MicroBatchEvaluator();
+  MicroBatchEvaluator(const MicroBatchEvaluator &) = delete;
+  MicroBatchEvaluator &operator=(const MicroBatchEvaluator &) = delete;
+
+  void initialize(const FilterCondition &condition);
+
+  std::future<bool> submit(const std::vector<Key> &keys);
+  bool evaluate(const std::vector<Key> &keys) { return submit(keys).get(); }
+
+  struct Stats {
+    uint64_t batches = 0;
+    uint64_t records = 0;
+  };
+  Stats stats() const;
+
+private:
+  struct Pending {
+    const std::vector<Key> *keys;
+    std::promise<bool> result;
+  };
+
+  void run();
+
+  const MicroBatchOptions options_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<Pending> queue_;
+  std::chrono::steady_clock::time_point oldest_; // arrival of queue_.front()
+  std::shared_ptr<const KeyPredicate> plan_;
+  Stats stats_;
+  bool stop_ = false;
+  std::thread worker_; // last: starts once everything above is constructed
+};
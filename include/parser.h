@@ -2,22 +2,107 @@
 
 #include "filter_structs.h"
 #include <functional>
+#include <memory>
 
 /**
  * The language takes a FilterCondition structure and converts it into a lambda function
  * That can be applied to a vector of Key objects to evaluate the condition.
+ *
+ * Sub-expressions are folded left to right. A sub-expression is skipped once it can no
+ * longer change the running result (false before AND, true before OR), so keys it
+ * references are not looked up for that record.
+ *
+ * Key names may be dotted paths into nested objects and lists ("user.geo.country",
+ * "items.0.price"); they are split once at compile time (see KeyPath).
+ *
+ * Text keys (Key::text) are parsed only when a clause compares them with a numeric
+ * constant or uses them in arithmetic, and keep the parsed number for later clauses.
+ *
+ * ListExpression clauses test list-valued keys (ANY / ALL / CONTAINS). Packed
+ * Key::array values are scanned in branch-free chunks, or probed through a hash
+ * set when the constant set or the array is large (see list_predicate.cpp).
+ *
+ * CidrExpression clauses test address keys against networks: a few networks are
+ * checked with mask-and-compare, many are merged into a sorted range table.
+ * Text keys are parsed as addresses when compared with IpAddress constants.
+ *
+ * GeoExpression clauses test a (lat, lon) key pair against a box, circle or set of
+ * polygons (see geo_region.h).
+ *
+ * BitmaskExpression clauses test packed flags in integer keys with one AND and one
+ * compare per record; a shifted field is tested by shifting the mask and value
+ * instead of the key (see bitmask.h).
+ *
+ * SampleExpression clauses keep a fixed fraction of key values by comparing a seeded
+ * hash of the value with a threshold (see sample_hash.h).
+ *
+ * ThresholdExpression clauses count passing children and stop as soon as the count
+ * reaches min_count or can no longer reach it.
+ *
+ * ExistsExpression clauses test whether a key is present. A KeySchema turns the keys a
+ * condition cannot match without into a PresenceRule, checked against a record's
+ * presence bitmask with one AND (see key_schema.h).
+ *
+ * project() compiles an ArithmeticExpression into a function returning the computed
+ * value (int64_t or double) with the same operand and type rules as BinaryExpression,
+ * for callers that need A * B of a matching record and not only A * B < C.
  */
 
+class KeyPath;
+
+using KeyPredicate = std::function<bool(const std::vector<Key>&)>;
+// Holds int64_t or double
+using KeyProjection = std::function<ValueType(const std::vector<Key>&)>;
+
+// One sub-expression compiled on its own, with the operator joining it to the result so far
+struct CompiledClause {
+    KeyPredicate predicate;
+    LogicalOperations prev_logical_op;
+};
+
 class LanguageParser {
 public:
     // Parses a FilterCondition and returns a lambda function that evaluates it
     static std::function<bool(const std::vector<Key>&)> parse(const FilterCondition& condition);
+    // Compiles every sub-expression into its own predicate, in condition order
+    static std::vector<CompiledClause> compile(const FilterCondition& condition);
+    // Short-circuit fold over already compiled clauses; parse() is
+    // fold(compile()). The clauses are shared, not copied, so a caller that
+    // keeps them (adaptive Evaluator) holds a single copy of every predicate.
+    static std::function<bool(const std::vector<Key>&)> fold(
+        std::shared_ptr<const std::vector<CompiledClause>> clauses);
+    // Compiles arithmetic over two keys into a function returning its value
+    static KeyProjection project(const ArithmeticExpression& expr);
+    // Whether a clause joined by `op` can still change `result`
+    static bool needsClause(bool result, LogicalOperations op) {
+        switch (op) {
+            case LogicalOperations::AND: return result;
+            case LogicalOperations::OR: return !result;
+            default: return true;
+        }
+    }
+    // Folds a clause result into the running result
+    static bool combine(bool result, LogicalOperations op, bool subResult);
+    // Index of the first clause every match must pass: the start of the trailing
+    // run of AND clauses, including the clause it starts from (0 without OR)
+    static std::size_t requiredClauses(const FilterCondition& condition);
 private:
     // Helper functions to evaluate expressions
     static ValueType evaluateArithmetic(const ValueType& left, ArithmeticOperations op, const ValueType& right);
     static bool evaluateComparison(const ValueType& left, ComparisonOperations op, const ValueType& right);
     static bool evaluateLogical(bool left, LogicalOperations op, bool right);
-    static ValueType getValueFromKey(const std::vector<Key>& keys, const std::string& keyName);
+    static const Key& findKey(const std::vector<Key>& keys, const KeyPath& path);
+    // Text keys (Key::text) parsed on demand for numeric clauses
+    static ValueType textAsNumber(const Key& key, DataTypes type);
+    static ValueType arithmeticOperand(const Key& key);
+    static IpAddress textAsAddress(const Key& key);
+    static KeyPredicate compileClause(const SubExpression& subExpr);
+    static KeyPredicate compileListClause(const ListExpression& expr);
+    static KeyPredicate compileCidrClause(const CidrExpression& expr);
+    static KeyPredicate compileGeoClause(const GeoExpression& expr);
+    static KeyPredicate compileBitmaskClause(const BitmaskExpression& expr);
+    static KeyPredicate compileSampleClause(const SampleExpression& expr);
+    static KeyPredicate compileThresholdClause(const ThresholdExpression& expr);
 };
 
 class ParseException : public std::exception {
@@ -26,4 +111,4 @@ public:
     const char* what() const noexcept override { return message_.c_str(); }
 private:
     std::string message_;
-};
\ No newline at end of file
+};
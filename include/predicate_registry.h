@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+/**
+ * Many conditions evaluated against the same record, with shared clauses
+ * evaluated once.
+ *
+ * Large rule sets repeat the same clauses: `region == "eu"` may appear in
+ * thousands of conditions, and one Evaluator per condition compares it again
+ * for each of them. A PredicateRegistry compiles every distinct clause once
+ * and gives each condition a list of predicate indices with their AND / OR
+ * operators. Per record, a table with one state byte per distinct predicate
+ * is cleared, each predicate is evaluated the first time a condition needs
+ * it, and every other condition reads the stored result:
+ *
+ *   PredicateRegistry registry;
+ *   for (const auto &condition : conditions) registry.add(condition);
+ *   std::vector<uint8_t> matches;
+ *   registry.evaluate(keys, matches); // matches[i]: conditions[i] matched
+ *
+ * Work per record therefore scales with the distinct predicates a record
+ * needs, not with the total number of clauses. Conditions keep the row path's
+ * short-circuiting, so a predicate no condition needs is never evaluated.
+ *
+ * UnaryExpression, BinaryExpression and ExistsExpression clauses with equal
+ * operators, keys and constants are shared; other clause kinds are compiled
+ * per condition. A condition that the row path would throw for (a missing
+ * key, a type mismatch) does not match and is reported through `failed`;
+ * the other conditions are unaffected.
+ *
+ * evaluate() writes the per-record table, so a registry must not be evaluated
+ * from several threads at once; use one per thread.
+ */
+
+class PredicateRegistry {
+public:
+  // Adds `condition` and returns its index in evaluate()'s output. Throws
+  // ParseException for a NOT operator, which conditions do not support.
+  std::size_t add(const FilterCondition &condition);
+
+  // Conditions added
+  std::size_t size() const { return offsets_.size() - 1; }
+  // Distinct predicates compiled, and clauses over all conditions
+  std::size_t predicates() const { return predicates_.size(); }
+  std::size_t clauses() const { return clauses_.size(); }
+
+  // matches[i] is 1 where condition i matches `keys`, 0 otherwise
+  void evaluate(const std::vector<Key> &keys, std::vector<uint8_t> &matches);
+  // Also lists, ascending, the conditions that failed with a ParseException
+  void evaluate(const std::vector<Key> &keys, std::vector<uint8_t> &matches,
+                std::vector<std::size_t> &failed);
+
+private:
+  struct Clause {
+    uint32_t predicate;
+    LogicalOperations prev_logical_op;
+  };
+
+  uint32_t intern(const Expression &expr);
+  void evaluateAll(const std::vector<Key> &keys, std::vector<uint8_t> &matches,
+                   std::vector<std::size_t> *failed);
+
+  std::vector<KeyPredicate> predicates_;
+  std::vector<Expression> expressions_; // for exact comparison on a fingerprint hit
+  std::unordered_map<uint64_t, std::vector<uint32_t>> by_fingerprint_;
+  std::vector<Clause> clauses_;
+  std::vector<std::size_t> offsets_{0}; // condition i: clauses_[offsets_[i], offsets_[i + 1])
+  std::vector<uint8_t> states_;         // per predicate, for the current record
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * USDT (SystemTap SDT style) static tracepoints.
+ *
+ * Each EXPR_EVAL_PROBEn(name, args...) site compiles to a single `nop` plus an
+ * ELF note in .note.stapsdt describing where the arguments live. Tools such as
+ * bpftrace, perf and SystemTap find the note and patch in a breakpoint only
+ * while attached, so an unobserved probe costs one nop. The note is emitted
+ * here directly (same layout as <sys/sdt.h>), so there is no header or library
+ * dependency at build or run time.
+ *
+ * Arguments are passed as 64-bit integers; pointers (e.g. key names) are
+ * passed as their address. Probes compile away entirely on unsupported
+ * targets or when EXPR_EVAL_DISABLE_PROBES is defined.
+ *
+ * Provider: expression_evaluator. See scripts/bpftrace/ for usage.
+ */
+
+#if !defined(EXPR_EVAL_DISABLE_PROBES) && defined(__ELF__) &&                  \
+    (defined(__x86_64__) || defined(__aarch64__)) &&                           \
+    (defined(__GNUC__) || defined(__clang__))
+#define EXPR_EVAL_PROBES_ENABLED 1
+#endif
+
+#if defined(EXPR_EVAL_PROBES_ENABLED)
+
+#define EXPR_EVAL_PROBE_STR_(x) #x
+
+// Probe site + .note.stapsdt entry; `argfmt` is the SDT argument string.
+#define EXPR_EVAL_PROBE_ASM_(name, argfmt, ...)                                \
+  __asm__ __volatile__(                                                        \
+      "990: nop\n"                                                             \
+      ".pushsection .note.stapsdt,\"?\",\"note\"\n"                            \
+      ".balign 4\n"                                                            \
+      ".4byte 992f-991f, 994f-993f, 3\n"                                       \
+      "991: .asciz \"stapsdt\"\n"                                              \
+      "992: .balign 4\n"                                                       \
+      "993: .8byte 990b\n"                                                     \
+      ".8byte _.stapsdt.base\n"                                                \
+      ".8byte 0\n"                                                             \
+      ".asciz \"expression_evaluator\"\n"                                      \
+      ".asciz \"" EXPR_EVAL_PROBE_STR_(name) "\"\n"                            \
+      ".asciz \"" argfmt "\"\n"                                                \
+      "994: .balign 4\n"                                                       \
+      ".popsection\n"                                                          \
+      ".ifndef _.stapsdt.base\n"                                               \
+      ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"  \
+      ".weak _.stapsdt.base\n"                                                 \
+      ".hidden _.stapsdt.base\n"                                               \
+      "_.stapsdt.base: .space 1\n"                                             \
+      ".size _.stapsdt.base, 1\n"                                              \
+      ".popsection\n"                                                          \
+      ".endif\n" ::__VA_ARGS__)
+
+#define EXPR_EVAL_PROBE_ARG_(x) static_cast<int64_t>(x)
+
+#define EXPR_EVAL_PROBE1(name, a1)                                             \
+  EXPR_EVAL_PROBE_ASM_(name, "-8@%[p1]", [p1] "nor"(EXPR_EVAL_PROBE_ARG_(a1)))
+#define EXPR_EVAL_PROBE2(name, a1, a2)                                         \
+  EXPR_EVAL_PROBE_ASM_(name, "-8@%[p1] -8@%[p2]",                              \
+                       [p1] "nor"(EXPR_EVAL_PROBE_ARG_(a1)),                   \
+                       [p2] "nor"(EXPR_EVAL_PROBE_ARG_(a2)))
+#define EXPR_EVAL_PROBE3(name, a1, a2, a3)                                     \
+  EXPR_EVAL_PROBE_ASM_(name, "-8@%[p1] -8@%[p2] -8@%[p3]",                     \
+                       [p1] "nor"(EXPR_EVAL_PROBE_ARG_(a1)),                   \
+                       [p2] "nor"(EXPR_EVAL_PROBE_ARG_(a2)),                   \
+                       [p3] "nor"(EXPR_EVAL_PROBE_ARG_(a3)))
+
+#else
+
+// Arguments stay unevaluated; sizeof only keeps them "used".
+#define EXPR_EVAL_PROBE1(name, a1) ((void)sizeof(a1))
+#define EXPR_EVAL_PROBE2(name, a1, a2) ((void)sizeof(a1), (void)sizeof(a2))
+#define EXPR_EVAL_PROBE3(name, a1, a2, a3)                                     \
+  ((void)sizeof(a1), (void)sizeof(a2), (void)sizeof(a3))
+
+#endif
+
+// Pointer arguments (C strings) are passed by address.
+#define EXPR_EVAL_PROBE_PTR(p) reinterpret_cast<uintptr_t>(p)
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "key.h"
+#include "parser.h"
+
+/**
+ * Scans of a record set with a limit.
+ *
+ * scanMatches() returns the indices of records a compiled condition accepts
+ * and stops as soon as `limit` of them are found; anyMatch() is the limit-1
+ * form. With several threads, workers claim fixed-size blocks of records in
+ * ascending order and are cancelled cooperatively through shared atomics:
+ *
+ *   ordered   - the result is exactly what a single-threaded scan returns
+ *               (the first `limit` matches in record order). Once the blocks
+ *               finished so far hold `limit` matches, later blocks are not
+ *               started and running ones stop.
+ *   unordered - every match bumps a shared counter and all workers stop once
+ *               it reaches `limit`. Any `limit` matches are returned (sorted,
+ *               but which ones depends on scheduling).
+ *
+ * The predicate runs concurrently, so it must be thread-safe: conditions
+ * compiled by LanguageParser::parse are, an adaptive Evaluator is not.
+ *
+ * A ParseException from the predicate propagates like in a sequential scan:
+ * ordered scans rethrow it when the failing record comes before the limit is
+ * reached; unordered scans rethrow the first one seen unless `limit` matches
+ * were found anyway.
+ */
+
+struct ScanOptions {
+  static constexpr std::size_t kNoLimit = std::numeric_limits<std::size_t>::max();
+
+  std::size_t limit = kNoLimit;
+  unsigned threads = 1; // 0: std::thread::hardware_concurrency()
+  bool ordered = true;
+  std::size_t block_size = 1024; // records a worker claims at a time
+};
+
+// Ascending indices into `records` of at most options.limit matches
+std::vector<std::size_t> scanMatches(const KeyPredicate &predicate,
+                                     const std::vector<std::vector<Key>> &records,
+                                     const ScanOptions &options = {});
+
+// Whether any record matches; stops at the first match
+bool anyMatch(const KeyPredicate &predicate, const std::vector<std::vector<Key>> &records,
+              unsigned threads = 1);
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "filter_structs.h"
+#include "struct_binding.h"
+
+/**
+ * Shared-memory single-producer / single-consumer record transport.
+ *
+ * SpscRing<T, Capacity> is a fixed-size ring of trivially copyable records
+ * meant to be placed in memory shared by two processes. The producer's head
+ * index and the consumer's tail index live on separate cache lines, each next
+ * to that side's cached copy of the other index, so the line holding an index
+ * only bounces when the cached copy runs out. Both sides can work in batches:
+ * claim/read several slots, then publish/release them with one store.
+ *
+ * RingChannel pairs a record ring with a result ring. RingFilterConsumer
+ * evaluates records in place in the ring with a StructEvaluator (the record
+ * type is bound with EXPR_EVAL_STRUCT; use char[N] for strings) and publishes
+ * one MatchResult per record back to the producer.
+ *
+ *   SharedMemory shm = SharedMemory::create("/capture",
+ *                                           SharedMemory::bytesFor<Channel>());
+ *   Channel* channel = shm.construct<Channel>();  // producer process
+ *   Channel* channel = shm.attach<Channel>();     // consumer process, nullptr
+ *                                                 // until constructed
+ */
+
+inline constexpr std::size_t kCacheLineSize = 64;
+
+template <typename T, std::size_t Capacity> class SpscRing {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "ring records are copied between processes byte-wise");
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "cross-process rings need lock-free 64-bit atomics");
+
+public:
+  // ---- Producer side ----
+
+  // Free slots the producer may fill before publishing. The consumer's tail
+  // is only re-read when the cached view has fewer than `wanted` free slots,
+  // so the result can be an underestimate.
+  std::size_t writable(std::size_t wanted = 1) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (Capacity - (head - cached_tail_) < wanted) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    return static_cast<std::size_t>(Capacity - (head - cached_tail_));
+  }
+  // i-th free slot, i < writable()
+  T &writeSlot(std::size_t i) {
+    return slots_[(head_.load(std::memory_order_relaxed) + i) & kMask];
+  }
+  // Makes the first n written slots visible to the consumer
+  void publish(std::size_t n) {
+    head_.store(head_.load(std::memory_order_relaxed) + n,
+                std::memory_order_release);
+  }
+  bool tryPush(const T &record) {
+    if (writable() == 0) {
+      return false;
+    }
+    writeSlot(0) = record;
+    publish(1);
+    return true;
+  }
+
+  // ---- Consumer side ----
+
+  // Published records not yet released (head re-read only when none are
+  // left in the cached view)
+  std::size_t readable() {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (cached_head_ == tail) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    return static_cast<std::size_t>(cached_head_ - tail);
+  }
+  // i-th unread record, i < readable(); valid until released
+  const T &readSlot(std::size_t i) const {
+    return slots_[(tail_.load(std::memory_order_relaxed) + i) & kMask];
+  }
+  // Sequence number (0, 1, 2, ... since creation) of readSlot(0)
+  uint64_t readSequence() const {
+    return tail_.load(std::memory_order_relaxed);
+  }
+  // Hands the first n read slots back to the producer
+  void release(std::size_t n) {
+    tail_.store(tail_.load(std::memory_order_relaxed) + n,
+                std::memory_order_release);
+  }
+  bool tryPop(T &record) {
+    if (readable() == 0) {
+      return false;
+    }
+    record = readSlot(0);
+    release(1);
+    return true;
+  }
+
+  static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+  static constexpr uint64_t kMask = Capacity - 1;
+
+  // Producer-owned line
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+  uint64_t cached_tail_ = 0;
+  // Consumer-owned line
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_{0};
+  uint64_t cached_head_ = 0;
+
+  alignas(kCacheLineSize) T slots_[Capacity]{};
+};
+
+struct MatchResult {
+  uint64_t sequence; // position of the record in the record ring
+  uint8_t matched;
+};
+
+template <typename T, std::size_t Capacity> struct RingChannel {
+  SpscRing<T, Capacity> records; // producer -> consumer
+  SpscRing<MatchResult, Capacity> results; // consumer -> producer
+};
+
+template <typename T, std::size_t Capacity> class RingFilterConsumer {
+public:
+  void initialize(const FilterCondition &condition) {
+    evaluator_.initialize(condition);
+  }
+
+  // Evaluates up to `max_records` published records in place, publishes a
+  // MatchResult for each and frees their slots. Returns how many were
+  // processed: 0 when no record is ready or the result ring is full.
+  std::size_t poll(RingChannel<T, Capacity> &channel,
+                   std::size_t max_records = Capacity) {
+    std::size_t n = channel.records.readable();
+    const std::size_t room = channel.results.writable(n);
+    n = n < room ? n : room;
+    n = n < max_records ? n : max_records;
+    const uint64_t sequence = channel.records.readSequence();
+    for (std::size_t i = 0; i < n; ++i) {
+      MatchResult &result = channel.results.writeSlot(i);
+      result.sequence = sequence + i;
+      result.matched = evaluator_.evaluate(channel.records.readSlot(i));
+    }
+    if (n != 0) {
+      channel.records.release(n);
+      channel.results.publish(n);
+    }
+    return n;
+  }
+
+private:
+  StructEvaluator<T> evaluator_;
+};
+
+// A POSIX shared-memory object mapped read/write. The creating instance
+// unlinks the name when destroyed; mappings stay valid until each side's
+// instance is destroyed. Failures throw std::system_error. POSIX only.
+//
+// A channel is preceded by a one-line header whose magic word the creator
+// stores last, with release ordering, so the other process never sees a
+// half-constructed channel. Size mappings with bytesFor<Channel>().
+class SharedMemory {
+public:
+  // `size` must not exceed the object: open() checks it, so a consumer that
+  // runs ahead of the producer's create() gets an error instead of SIGBUS.
+  static SharedMemory create(const std::string &name, std::size_t size);
+  static SharedMemory open(const std::string &name, std::size_t size);
+
+  SharedMemory(SharedMemory &&other) noexcept;
+  SharedMemory &operator=(SharedMemory &&other) noexcept;
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory &operator=(const SharedMemory &) = delete;
+  ~SharedMemory();
+
+  void *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+  // Mapping size needed to hold a Channel and its header
+  template <typename Channel> static constexpr std::size_t bytesFor() {
+    return sizeof(Header) + sizeof(Channel);
+  }
+
+  // Constructs a channel (or ring) after the header and publishes it
+  template <typename Channel> Channel *construct() {
+    static_assert(alignof(Channel) <= kCacheLineSize, "over-aligned channel");
+    checkFits(bytesFor<Channel>());
+    Header *header = new (data_) Header();
+    Channel *channel = new (header + 1) Channel();
+    header->channel_size = sizeof(Channel);
+    header->magic.store(kMagic, std::memory_order_release);
+    return channel;
+  }
+  // A channel constructed by the other process, or nullptr while it has not
+  // been published yet (retry). Throws when it was built for another type.
+  template <typename Channel> Channel *attach() const {
+    checkFits(bytesFor<Channel>());
+    const Header *header = static_cast<const Header *>(data_);
+    if (header->magic.load(std::memory_order_acquire) != kMagic) {
+      return nullptr;
+    }
+    checkChannelSize(header->channel_size, sizeof(Channel));
+    return reinterpret_cast<Channel *>(const_cast<Header *>(header + 1));
+  }
+
+private:
+  SharedMemory(std::string name, void *data, std::size_t size, bool owner)
+      : name_(std::move(name)), data_(data), size_(size), owner_(owner) {}
+  void reset();
+  void checkFits(std::size_t bytes) const;
+  static void checkChannelSize(uint64_t stored, std::size_t expected);
+
+  // "EXPRRNG" plus a layout version in the low byte
+  static constexpr uint64_t kMagic = 0x4558'5052'524E'4701ull;
+
+  struct alignas(kCacheLineSize) Header {
+    std::atomic<uint64_t> magic{0};
+    uint64_t channel_size = 0;
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "the header is read from another process");
+
+  std::string name_;
+  void *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool owner_ = false;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "parser.h"
+
+/**
+ * Evaluate FilterConditions directly on user structs.
+ *
+ * Describe a struct's fields once at namespace scope:
+ *
+ *   struct Order { int64_t qty; double price; std::string symbol; };
+ *   EXPR_EVAL_STRUCT(Order, EXPR_EVAL_FIELD(qty), EXPR_EVAL_FIELD(price),
+ *                    EXPR_EVAL_FIELD(symbol));
+ *
+ * then StructEvaluator<Order> accepts the same runtime FilterConditions as
+ * Evaluator. Keys are resolved to (type, offset) pairs once in initialize, so
+ * evaluate reads the struct in place: no std::vector<Key>, no name lookups,
+ * no allocation. Type errors a vector<Key> record would only hit at evaluate
+ * time (unknown field, mismatched constant, ordering on bool) are reported by
+ * initialize with a ParseException.
+ *
+ * Supported field types: int64_t, int32_t, double, bool, std::string,
+ * IpAddress and char[N] (an inline string, NUL-padded when shorter than N;
+ * lets a record stay trivially copyable, e.g. for shared memory). The struct must be
+ * standard-layout.
+ */
+
+struct FieldDescriptor {
+  std::string name;
+  DataTypes type;
+  std::size_t offset;
+  std::size_t size; // bytes; distinguishes int32_t from int64_t
+  bool inline_chars = false; // STRING stored as char[size], not std::string
+};
+
+template <typename F> struct FieldTraits; // unsupported field type
+template <> struct FieldTraits<int64_t> {
+  static constexpr DataTypes type = DataTypes::INTEGER;
+};
+template <> struct FieldTraits<int32_t> {
+  static constexpr DataTypes type = DataTypes::INTEGER;
+};
+template <> struct FieldTraits<double> {
+  static constexpr DataTypes type = DataTypes::DOUBLE;
+};
+template <> struct FieldTraits<bool> {
+  static constexpr DataTypes type = DataTypes::BOOLEAN;
+};
+template <> struct FieldTraits<std::string> {
+  static constexpr DataTypes type = DataTypes::STRING;
+};
+template <> struct FieldTraits<IpAddress> {
+  static constexpr DataTypes type = DataTypes::IP_ADDRESS;
+};
+template <std::size_t N> struct FieldTraits<char[N]> {
+  static constexpr DataTypes type = DataTypes::STRING;
+  static constexpr bool inline_chars = true;
+};
+
+template <typename F, typename = void>
+struct IsInlineChars : std::false_type {};
+template <typename F>
+struct IsInlineChars<F, std::void_t<decltype(FieldTraits<F>::inline_chars)>>
+    : std::true_type {};
+
+// Member type with references and cv stripped, keeping arrays intact
+#define EXPR_EVAL_FIELD_TYPE(member)                                           \
+  std::remove_cv_t<std::remove_reference_t<decltype(std::declval<Self &>().member)>>
+
+// Specialized for each bound struct by EXPR_EVAL_STRUCT
+template <typename T> struct StructSchema;
+
+#define EXPR_EVAL_FIELD(member)                                                \
+  ::FieldDescriptor {                                                          \
+    #member, ::FieldTraits<EXPR_EVAL_FIELD_TYPE(member)>::type,                \
+        offsetof(Self, member), sizeof(std::declval<Self &>().member),         \
+        ::IsInlineChars<EXPR_EVAL_FIELD_TYPE(member)>::value                   \
+  }
+
+#define EXPR_EVAL_STRUCT(Type, ...)                                            \
+  template <> struct StructSchema<Type> {                                      \
+    using Self = Type;                                                         \
+    static_assert(std::is_standard_layout<Type>::value,                        \
+                  "EXPR_EVAL_STRUCT needs a standard-layout struct");          \
+    static const std::vector<::FieldDescriptor> &fields() {                    \
+      static const std::vector<::FieldDescriptor> descriptors{__VA_ARGS__};    \
+      return descriptors;                                                      \
+    }                                                                          \
+  }
+
+// Type-erased compiled plan over a record laid out as described by `fields`
+class StructPlan {
+public:
+  StructPlan() = default;
+  StructPlan(const std::vector<FieldDescriptor> &fields,
+             const FilterCondition &condition);
+
+  // `record` must point at a struct described by the plan's fields
+  bool evaluate(const void *record) const;
+
+private:
+  struct Operand {
+    DataTypes type;
+    std::size_t offset;
+    std::size_t size;
+    bool inline_chars;
+  };
+  enum class Kind : uint8_t {
+    COMPARE,    // left compared with `constant` by `op`
+    ARITHMETIC, // left arith_op right, compared with `constant` by `op`
+    BITMASK,    // left & bit_mask compared with bit_expect by `op`
+    SAMPLE,     // seeded hash of left below sample_threshold
+    THRESHOLD,  // at least min_count of children hold
+    FIXED       // result known at initialize (EXISTS): fixed_result
+  };
+  struct Clause {
+    Kind kind;
+    LogicalOperations prev_logical_op;
+    // COMPARE, ARITHMETIC, BITMASK, SAMPLE
+    Operand left;
+    ComparisonOperations op;
+    DataTypes compared_type; // type of the value compared to `constant`
+    ValueType constant;
+    // ARITHMETIC
+    Operand right;
+    ArithmeticOperations arith_op;
+    // BITMASK
+    uint64_t bit_mask;
+    uint64_t bit_expect;
+    // SAMPLE
+    uint64_t sample_seed;
+    uint64_t sample_threshold;
+    // THRESHOLD
+    std::size_t min_count;
+    std::vector<StructPlan> children;
+    // FIXED
+    bool fixed_result;
+  };
+
+  static Operand resolve(const std::vector<FieldDescriptor> &fields,
+                         const std::string &name);
+  static bool evaluateClause(const Clause &clause, const char *base);
+  static bool evaluateArithmetic(const Clause &clause, const char *base);
+  static bool evaluateComparison(const Clause &clause, const char *base);
+
+  std::vector<Clause> clauses_;
+};
+
+template <typename T> class StructEvaluator {
+public:
+  void initialize(const FilterCondition &condition) {
+    plan_ = StructPlan(StructSchema<T>::fields(), condition);
+  }
+  bool evaluate(const T &record) const { return plan_.evaluate(&record); }
+
+private:
+  StructPlan plan_;
+};
@@ -0,0 +1,921 @@
+#include "batch_evaluator.h"
+#include "batch_kernels.h"
+#include "bitmask.h"
+#include "cidr_set.h"
+#include "geo_region.h"
+#include "parser.h"
+#include "sample_hash.h"
+#include "threshold.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Clause state built once by initialize, mirroring the condition's clauses:
+// network sets and geo regions (whose range tables and polygon grids are
+// costly to build) and the compiled clauses of threshold children, whose
+// k-of-n bounds are checked here rather than per batch
+struct CompiledBatchClause {
+    std::unique_ptr<const CidrSet> networks;      // CidrExpression
+    std::unique_ptr<const GeoRegion> region;      // GeoExpression
+    std::vector<CompiledBatchCondition> children; // ThresholdExpression
+};
+
+struct CompiledBatchCondition {
+    std::vector<CompiledBatchClause> clauses;
+};
+
+namespace {
+
+CompiledBatchCondition compileCondition(const FilterCondition& condition) {
+    CompiledBatchCondition compiled;
+    compiled.clauses.resize(condition.sub_expressions.size());
+    for (std::size_t i = 0; i < condition.sub_expressions.size(); ++i) {
+        const Expression& expr = condition.sub_expressions[i].expr;
+        CompiledBatchClause& clause = compiled.clauses[i];
+        if (const auto* c = std::get_if<CidrExpression>(&expr)) {
+            checkCidr(*c);
+            clause.networks = std::make_unique<const CidrSet>(c->networks);
+        } else if (const auto* g = std::get_if<GeoExpression>(&expr)) {
+            clause.region = std::make_unique<const GeoRegion>(g->region);
+        } else if (const auto* t = std::get_if<ThresholdExpression>(&expr)) {
+            checkThreshold(*t);
+            for (const FilterCondition& child : t->children) {
+                clause.children.push_back(compileCondition(child));
+            }
+        }
+    }
+    return compiled;
+}
+
+const ColumnView& requireColumn(const ColumnBatch& batch, const std::string& name) {
+    const ColumnView* column = batch.find(name);
+    if (!column) {
+        throw ParseException("Key not found: " + name);
+    }
+    return *column;
+}
+
+// Rows [begin, end) of a batch
+struct RowRange {
+    int64_t begin;
+    int64_t end;
+};
+
+// Rows whose clause result can still change the running mask: acc == 1 for
+// AND, acc == 0 for OR, every row otherwise; within a threshold child, only
+// rows the threshold has not decided yet (`live`). Used so data-dependent
+// errors (division by zero) only fire where the row path would also evaluate.
+struct NeededRows {
+    const uint8_t* acc = nullptr;
+    uint8_t want = 0;
+    const uint8_t* live = nullptr;
+
+    bool operator()(int64_t i) const { return (!live || live[i]) && (!acc || acc[i] == want); }
+};
+
+// Arithmetic columns computed during one evaluate call, shared by every
+// clause and projection with the same operands and operator. Rows where a
+// division was skipped (null, or not needed by the clause that computed it)
+// hold 0.
+struct ArithmeticValues {
+    bool integer = true;
+    std::vector<int64_t> ints;
+    std::vector<double> doubles;
+};
+using ArithmeticCache = std::map<std::tuple<std::string, ArithmeticOperations, std::string>, ArithmeticValues>;
+
+// State of one evaluate call
+struct EvalContext {
+    ArithmeticCache cache;
+    int64_t selection_density;
+};
+
+void evaluateCondition(const FilterCondition& condition, const CompiledBatchCondition& compiled,
+                       const ColumnBatch& batch, const uint8_t* live, EvalContext& context, uint8_t* acc);
+
+// Clause kernels take the rows they evaluate as AllRows (every row of the
+// batch) or SelectedRows (survivors of the clauses before it) and write the
+// result for row rows(k) to out[k].
+
+template <typename Rows>
+void evaluateUnary(const UnaryExpression& expr, const ColumnBatch& batch, const Rows& rows, uint8_t* out) {
+    const ColumnView& column = requireColumn(batch, expr.key);
+    if (valueDataType(expr.value) != column.type) {
+        throw ParseException("Comparison requires operands of the same type");
+    }
+    const int64_t n = rows.count;
+    switch (column.type) {
+        case DataTypes::INTEGER: {
+            const int64_t* values = static_cast<const int64_t*>(column.values) + column.offset;
+            compareKernel([values, rows](int64_t k) { return values[rows(k)]; }, n, expr.op,
+                          std::get<int64_t>(expr.value), out);
+            break;
+        }
+        case DataTypes::DOUBLE: {
+            const double* values = static_cast<const double*>(column.values) + column.offset;
+            compareKernel([values, rows](int64_t k) { return values[rows(k)]; }, n, expr.op,
+                          std::get<double>(expr.value), out);
+            break;
+        }
+        case DataTypes::STRING: {
+            const std::string_view constant(std::get<std::string>(expr.value));
+            compareKernel([&column, rows](int64_t k) { return column.stringAt(rows(k)); }, n, expr.op, constant, out);
+            break;
+        }
+        case DataTypes::BOOLEAN: {
+            if (!isEqualityComparison(expr.op)) {
+                throw ParseException("Unsupported comparison operation for boolean");
+            }
+            compareKernel([&column, rows](int64_t k) { return column.boolAt(rows(k)); }, n, expr.op,
+                          std::get<bool>(expr.value), out);
+            break;
+        }
+        case DataTypes::IP_ADDRESS: {
+            const auto& constant = std::get<IpAddress>(expr.value);
+            if (column.byte_width == 4 && constant.isV4()) {
+                compareKernel([&column, rows](int64_t k) { return column.ipv4At(rows(k)); }, n, expr.op,
+                              constant.v4Bits(), out);
+            } else {
+                compareKernel([&column, rows](int64_t k) { return column.ipAt(rows(k)); }, n, expr.op, constant, out);
+            }
+            break;
+        }
+    }
+    applyValidity(column, rows, out);
+}
+
+template <typename Rows>
+void evaluateCidr(const CidrExpression& expr, const CidrSet& set, const ColumnBatch& batch, const Rows& rows,
+                  uint8_t* out) {
+    const ColumnView& column = requireColumn(batch, expr.key);
+    if (column.type != DataTypes::IP_ADDRESS) {
+        throw ParseException("Comparison requires operands of the same type");
+    }
+    const int64_t n = rows.count;
+    if (column.byte_width == 4) {
+        std::vector<uint32_t> addresses(static_cast<std::size_t>(n));
+        for (int64_t k = 0; k < n; ++k) addresses[k] = column.ipv4At(rows(k));
+        set.containsV4(addresses.data(), n, out);
+    } else {
+        for (int64_t k = 0; k < n; ++k) out[k] = set.contains(column.ipAt(rows(k)));
+    }
+    if (expr.op == ComparisonOperations::NOT_EQUAL) {
+        for (int64_t k = 0; k < n; ++k) out[k] ^= 1;
+    }
+    applyValidity(column, rows, out);
+}
+
+// Degrees of a DOUBLE column in place, or of the rows converted / gathered
+// into `scratch`
+template <typename Rows>
+const double* coordinates(const ColumnView& column, const Rows& rows, std::vector<double>& scratch) {
+    if (column.type != DataTypes::DOUBLE && column.type != DataTypes::INTEGER) {
+        throw ParseException("Geo predicates require numeric coordinates");
+    }
+    if constexpr (std::is_same_v<Rows, AllRows>) {
+        if (column.type == DataTypes::DOUBLE) {
+            return static_cast<const double*>(column.values) + column.offset;
+        }
+    }
+    scratch.resize(static_cast<std::size_t>(rows.count));
+    for (int64_t k = 0; k < rows.count; ++k) {
+        scratch[k] = column.type == DataTypes::DOUBLE ? column.doubleAt(rows(k))
+                                                      : static_cast<double>(column.int64At(rows(k)));
+    }
+    return scratch.data();
+}
+
+template <typename Rows>
+void evaluateGeo(const GeoExpression& expr, const GeoRegion& region, const ColumnBatch& batch, const Rows& rows,
+                 uint8_t* out) {
+    const ColumnView& lat = requireColumn(batch, expr.lat_key);
+    const ColumnView& lon = requireColumn(batch, expr.lon_key);
+    std::vector<double> lat_scratch, lon_scratch;
+    region.contains(coordinates(lat, rows, lat_scratch), coordinates(lon, rows, lon_scratch), rows.count, out);
+    applyValidity(lat, rows, out);
+    applyValidity(lon, rows, out);
+}
+
+template <typename Rows>
+void evaluateBitmask(const BitmaskExpression& expr, const ColumnBatch& batch, const Rows& rows, uint8_t* out) {
+    const ColumnView& column = requireColumn(batch, expr.key);
+    if (column.type != DataTypes::INTEGER) {
+        throw ParseException("Bitmask predicates require integer keys: " + expr.key);
+    }
+    const BitmaskTest test = BitmaskTest::compile(expr);
+    const int64_t* values = static_cast<const int64_t*>(column.values) + column.offset;
+    const uint64_t mask = test.mask;
+    const uint64_t expect = test.expect;
+    const uint8_t flip = test.negate;
+    for (int64_t k = 0; k < rows.count; ++k) {
+        out[k] = static_cast<uint8_t>((static_cast<uint64_t>(values[rows(k)]) & mask) == expect) ^ flip;
+    }
+    applyValidity(column, rows, out);
+}
+
+template <typename Rows>
+void evaluateSample(const SampleExpression& expr, const ColumnBatch& batch, const Rows& rows, uint8_t* out) {
+    const ColumnView& column = requireColumn(batch, expr.key);
+    const SampleTest test = SampleTest::compile(expr);
+    const int64_t n = rows.count;
+    if (column.type == DataTypes::INTEGER) {
+        const int64_t* values = static_cast<const int64_t*>(column.values) + column.offset;
+        const uint64_t seed = test.mixed_seed;
+        const uint64_t threshold = test.threshold;
+        for (int64_t k = 0; k < n; ++k) out[k] = (sampleHash(seed, values[rows(k)]) >> 1) < threshold;
+    } else if (column.type == DataTypes::STRING) {
+        for (int64_t k = 0; k < n; ++k) out[k] = test(column.stringAt(rows(k)));
+    } else {
+        throw ParseException("Sample predicates require integer or string keys: " + expr.key);
+    }
+    applyValidity(column, rows, out);
+}
+
+template <typename Rows>
+void evaluateExists(const ExistsExpression& expr, const ColumnBatch& batch, const Rows& rows, uint8_t* out) {
+    const ColumnView* column = batch.find(expr.key);
+    const int64_t n = rows.count;
+    std::fill(out, out + n, static_cast<uint8_t>(column != nullptr));
+    if (column) {
+        applyValidity(*column, rows, out); // null rows are missing
+    }
+    if (!expr.exists) {
+        for (int64_t k = 0; k < n; ++k) out[k] ^= 1;
+    }
+}
+
+// Per-row counts of passing children, added one child mask at a time (plain
+// byte adds the compiler vectorizes). Children only need the rows still open
+// (live, below min_count and still able to reach it); stops once none is.
+template <typename Count>
+void countThreshold(const ThresholdExpression& expr, const CompiledBatchClause& compiled, const ColumnBatch& batch,
+                    const uint8_t* live, EvalContext& context, uint8_t* out) {
+    const int64_t n = batch.numRows();
+    const std::size_t total = expr.children.size();
+    const auto k = static_cast<Count>(expr.min_count);
+    std::vector<Count> counts(static_cast<std::size_t>(n), 0);
+    std::vector<uint8_t> child(static_cast<std::size_t>(n));
+    std::vector<uint8_t> open(live, live + n);
+    Count* c = counts.data();
+    for (std::size_t j = 0; j < total; ++j) {
+        evaluateCondition(expr.children[j], compiled.children[j], batch, open.data(), context, child.data());
+        const uint8_t* passed = child.data();
+        for (int64_t i = 0; i < n; ++i) c[i] += passed[i];
+
+        const std::size_t left = total - 1 - j;
+        const Count reachable = left >= expr.min_count ? 0 : static_cast<Count>(expr.min_count - left);
+        uint8_t any = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            open[i] &= static_cast<uint8_t>((c[i] < k) & (c[i] >= reachable));
+            any |= open[i];
+        }
+        if (!any) break;
+    }
+    for (int64_t i = 0; i < n; ++i) out[i] = c[i] >= k;
+}
+
+void evaluateThreshold(const ThresholdExpression& expr, const CompiledBatchClause& compiled, const ColumnBatch& batch,
+                       const uint8_t* live, EvalContext& context, uint8_t* out) {
+    if (expr.children.size() <= 0xff) {
+        countThreshold<uint8_t>(expr, compiled, batch, live, context, out);
+    } else {
+        countThreshold<uint32_t>(expr, compiled, batch, live, context, out);
+    }
+}
+
+// `throws(i)`: whether a zero divisor in row i raises (a valid row the clause
+// needs); other rows get 0
+template <typename T, typename LoadL, typename LoadR, typename Throws>
+void arithmeticKernel(LoadL l, LoadR r, int64_t n, ArithmeticOperations op, Throws throws, T* out) {
+    switch (op) {
+        case ArithmeticOperations::ADD:
+            for (int64_t i = 0; i < n; ++i) out[i] = l(i) + r(i);
+            break;
+        case ArithmeticOperations::SUBTRACT:
+            for (int64_t i = 0; i < n; ++i) out[i] = l(i) - r(i);
+            break;
+        case ArithmeticOperations::MULTIPLY:
+            for (int64_t i = 0; i < n; ++i) out[i] = l(i) * r(i);
+            break;
+        case ArithmeticOperations::DIVIDE:
+            for (int64_t i = 0; i < n; ++i) {
+                const T divisor = r(i);
+                if (divisor == T(0)) {
+                    if (throws(i)) {
+                        throw ParseException("Division by zero");
+                    }
+                    out[i] = T(0); // row is null or already decided
+                } else {
+                    out[i] = l(i) / divisor;
+                }
+            }
+            break;
+        default: throw ParseException("Unsupported arithmetic operation");
+    }
+}
+
+// Loader of column rows as doubles
+template <typename Rows>
+auto doubleLoader(const ColumnView& c, const Rows& rows) {
+    const bool is_int = c.type == DataTypes::INTEGER;
+    const void* base = c.values;
+    const int64_t offset = c.offset;
+    return [is_int, base, offset, rows](int64_t k) {
+        const int64_t i = offset + rows(k);
+        return is_int ? static_cast<double>(static_cast<const int64_t*>(base)[i]) : static_cast<const double*>(base)[i];
+    };
+}
+
+// left op right at `rows` into ints / doubles (sized rows.count)
+template <typename Rows, typename Throws>
+void computeArithmetic(const ColumnView& left, ArithmeticOperations op, const ColumnView& right, const Rows& rows,
+                       Throws throws, ArithmeticValues& values) {
+    const int64_t n = rows.count;
+    values.integer = left.type == DataTypes::INTEGER && right.type == DataTypes::INTEGER;
+    if (values.integer) {
+        const int64_t* l = static_cast<const int64_t*>(left.values) + left.offset;
+        const int64_t* r = static_cast<const int64_t*>(right.values) + right.offset;
+        values.ints.resize(static_cast<std::size_t>(n));
+        arithmeticKernel<int64_t>([l, rows](int64_t k) { return l[rows(k)]; },
+                                  [r, rows](int64_t k) { return r[rows(k)]; }, n, op, throws, values.ints.data());
+    } else {
+        values.doubles.resize(static_cast<std::size_t>(n));
+        arithmeticKernel<double>(doubleLoader(left, rows), doubleLoader(right, rows), n, op, throws,
+                                 values.doubles.data());
+    }
+}
+
+// Division by zero in a needed row of cached values that skipped it
+template <typename Rows, typename Needed>
+void checkDivisors(const ColumnView& left, const ColumnView& right, const Rows& rows, Needed needed) {
+    for (int64_t k = 0; k < rows.count; ++k) {
+        const int64_t i = rows(k);
+        const bool zero = right.type == DataTypes::INTEGER ? right.int64At(i) == 0 : right.doubleAt(i) == 0.0;
+        if (zero && needed(i) && left.isValid(i) && right.isValid(i)) {
+            throw ParseException("Division by zero");
+        }
+    }
+}
+
+// left_key op right_key over the batch, computed on first use
+ArithmeticCache::iterator arithmeticValues(const std::string& left_key, ArithmeticOperations op,
+                                           const std::string& right_key, const ColumnBatch& batch,
+                                           const NeededRows& needed, ArithmeticCache& cache) {
+    const ColumnView& left = requireColumn(batch, left_key);
+    const ColumnView& right = requireColumn(batch, right_key);
+    if (!isNumeric(left.type) || !isNumeric(right.type)) {
+        throw ParseException("Arithmetic operations require numeric types");
+    }
+    const AllRows rows{batch.numRows()};
+    auto [it, inserted] = cache.try_emplace(std::make_tuple(left_key, op, right_key));
+    if (!inserted) {
+        if (op == ArithmeticOperations::DIVIDE) {
+            checkDivisors(left, right, rows, needed);
+        }
+        return it;
+    }
+    try {
+        computeArithmetic(left, op, right, rows,
+                          [&](int64_t i) { return needed(i) && left.isValid(i) && right.isValid(i); }, it->second);
+    } catch (...) {
+        cache.erase(it);
+        throw;
+    }
+    return it;
+}
+
+// On every row the values are computed once and cached; on selected rows
+// cached values are reused, and otherwise only the selected rows computed.
+template <typename Rows>
+void evaluateBinary(const BinaryExpression& expr, const ColumnBatch& batch, const NeededRows& needed,
+                    const Rows& rows, ArithmeticCache& cache, uint8_t* out) {
+    const ColumnView& left = requireColumn(batch, expr.left_key);
+    const ColumnView& right = requireColumn(batch, expr.right_key);
+    if (!isNumeric(left.type) || !isNumeric(right.type)) {
+        throw ParseException("Arithmetic operations require numeric types");
+    }
+    const bool integer = left.type == DataTypes::INTEGER && right.type == DataTypes::INTEGER;
+    if (valueDataType(expr.value) != (integer ? DataTypes::INTEGER : DataTypes::DOUBLE)) {
+        throw ParseException("Comparison requires operands of the same type");
+    }
+    const int64_t n = rows.count;
+    auto compare = [&](const ArithmeticValues& values, auto at) {
+        if (values.integer) {
+            const int64_t* v = values.ints.data();
+            compareKernel([v, at](int64_t k) { return v[at(k)]; }, n, expr.comp_op, std::get<int64_t>(expr.value), out);
+        } else {
+            const double* v = values.doubles.data();
+            compareKernel([v, at](int64_t k) { return v[at(k)]; }, n, expr.comp_op, std::get<double>(expr.value), out);
+        }
+    };
+    if constexpr (std::is_same_v<Rows, AllRows>) {
+        compare(arithmeticValues(expr.left_key, expr.arith_op, expr.right_key, batch, needed, cache)->second, rows);
+    } else {
+        auto it = cache.find(std::make_tuple(expr.left_key, expr.arith_op, expr.right_key));
+        if (it != cache.end()) {
+            if (expr.arith_op == ArithmeticOperations::DIVIDE) {
+                checkDivisors(left, right, rows, [](int64_t) { return true; });
+            }
+            compare(it->second, rows);
+        } else {
+            ArithmeticValues values;
+            computeArithmetic(left, expr.arith_op, right, rows,
+                              [&](int64_t k) { return left.isValid(rows(k)) && right.isValid(rows(k)); }, values);
+            compare(values, AllRows{n});
+        }
+    }
+    applyValidity(left, rows, out);
+    applyValidity(right, rows, out);
+}
+
+// Moves each projection's values into out, computing those the filter did
+// not. `matches`, when set, limits the valid rows.
+void projectInto(const ColumnBatch& batch, const std::vector<ArithmeticExpression>& projections,
+                 const uint8_t* matches, ArithmeticCache& cache, std::vector<ProjectedColumn>& out) {
+    const int64_t n = batch.numRows();
+    out.clear();
+    out.resize(projections.size());
+    for (std::size_t j = 0; j < projections.size(); ++j) {
+        const ArithmeticExpression& expr = projections[j];
+        const NeededRows needed{matches, 1, nullptr};
+        auto node = cache.extract(
+            arithmeticValues(expr.left_key, expr.arith_op, expr.right_key, batch, needed, cache));
+        ArithmeticValues& values = node.mapped();
+        ProjectedColumn& column = out[j];
+        column.type = values.integer ? DataTypes::INTEGER : DataTypes::DOUBLE;
+        column.ints = std::move(values.ints);
+        column.doubles = std::move(values.doubles);
+
+        const ColumnView& left = *batch.find(expr.left_key);
+        const ColumnView& right = *batch.find(expr.right_key);
+        if (!matches && !left.validity && !right.validity) {
+            continue; // every row is valid
+        }
+        column.validity.assign(static_cast<std::size_t>((n + 7) / 8), 0);
+        for (int64_t i = 0; i < n; ++i) {
+            const bool valid = (!matches || matches[i]) && left.isValid(i) && right.isValid(i);
+            column.validity[i >> 3] |= static_cast<uint8_t>(valid << (i & 7));
+        }
+    }
+}
+
+// First row in [begin, end) of an ascending column where value >= c
+// (upper = false) or value > c (upper = true)
+template <typename Load, typename T>
+int64_t searchSorted(Load load, int64_t begin, int64_t end, const T& c, bool upper) {
+    while (begin < end) {
+        const int64_t mid = begin + (end - begin) / 2;
+        const auto value = load(mid);
+        if (upper ? !(c < value) : value < c) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+// Rows of a sorted column where `value op c` holds: [lo, hi) of n
+template <typename Load, typename T>
+RowRange sortedClauseRange(Load load, int64_t n, ComparisonOperations op, const T& c) {
+    switch (op) {
+        case ComparisonOperations::EQUAL:
+            return {searchSorted(load, 0, n, c, false), searchSorted(load, 0, n, c, true)};
+        case ComparisonOperations::GREATER_THAN: return {searchSorted(load, 0, n, c, true), n};
+        case ComparisonOperations::GREATER_EQUAL: return {searchSorted(load, 0, n, c, false), n};
+        case ComparisonOperations::LESS_THAN: return {0, searchSorted(load, 0, n, c, false)};
+        case ComparisonOperations::LESS_EQUAL: return {0, searchSorted(load, 0, n, c, true)};
+        default: return {0, n};
+    }
+}
+
+// Rows outside the returned range fail a clause every match needs: a
+// comparison on a sorted column in the condition's trailing AND run. Clauses
+// that would throw (type mismatch) are left to evaluation.
+RowRange sortedRange(const FilterCondition& condition, const ColumnBatch& batch) {
+    const int64_t n = batch.numRows();
+    RowRange range{0, n};
+    const auto& subs = condition.sub_expressions;
+    for (std::size_t i = LanguageParser::requiredClauses(condition); i < subs.size(); ++i) {
+        const auto* u = std::get_if<UnaryExpression>(&subs[i].expr);
+        const ColumnView* column = u ? batch.find(u->key) : nullptr;
+        if (!column || !column->sorted || column->validity || valueDataType(u->value) != column->type) {
+            continue;
+        }
+        RowRange clause{0, n};
+        switch (column->type) {
+            case DataTypes::INTEGER:
+                clause = sortedClauseRange([column](int64_t r) { return column->int64At(r); }, n, u->op,
+                                           std::get<int64_t>(u->value));
+                break;
+            case DataTypes::DOUBLE:
+                clause = sortedClauseRange([column](int64_t r) { return column->doubleAt(r); }, n, u->op,
+                                           std::get<double>(u->value));
+                break;
+            case DataTypes::STRING:
+                clause = sortedClauseRange([column](int64_t r) { return column->stringAt(r); }, n, u->op,
+                                           std::string_view(std::get<std::string>(u->value)));
+                break;
+            default: break;
+        }
+        range.begin = std::max(range.begin, clause.begin);
+        range.end = std::max(range.begin, std::min(range.end, clause.end));
+    }
+    return range;
+}
+
+// Values projected over rows [begin, begin + rows) placed in a column of n
+// rows; rows outside are null
+void widenProjection(ProjectedColumn& column, int64_t begin, int64_t n) {
+    auto widen = [begin, n](auto& values) {
+        using Values = std::remove_reference_t<decltype(values)>;
+        Values wide(static_cast<std::size_t>(n));
+        std::copy(values.begin(), values.end(), wide.begin() + begin);
+        values = std::move(wide);
+    };
+    const int64_t rows = static_cast<int64_t>(column.type == DataTypes::INTEGER ? column.ints.size()
+                                                                                 : column.doubles.size());
+    if (column.type == DataTypes::INTEGER) {
+        widen(column.ints);
+    } else {
+        widen(column.doubles);
+    }
+    std::vector<uint8_t> validity(static_cast<std::size_t>((n + 7) / 8), 0);
+    for (int64_t i = 0; i < rows; ++i) {
+        const bool valid = column.validity.empty() || ColumnView::bit(column.validity.data(), i);
+        validity[(begin + i) >> 3] |= static_cast<uint8_t>(valid << ((begin + i) & 7));
+    }
+    column.validity = std::move(validity);
+}
+
+// One clause over `rows`
+template <typename Rows>
+void evaluateClause(const Expression& expr, const CompiledBatchClause& compiled, const ColumnBatch& batch,
+                    const NeededRows& needed, const Rows& rows, EvalContext& context, uint8_t* out) {
+    if (const auto* u = std::get_if<UnaryExpression>(&expr)) {
+        evaluateUnary(*u, batch, rows, out);
+    } else if (const auto* b = std::get_if<BinaryExpression>(&expr)) {
+        evaluateBinary(*b, batch, needed, rows, context.cache, out);
+    } else if (const auto* c = std::get_if<CidrExpression>(&expr)) {
+        evaluateCidr(*c, *compiled.networks, batch, rows, out);
+    } else if (const auto* g = std::get_if<GeoExpression>(&expr)) {
+        evaluateGeo(*g, *compiled.region, batch, rows, out);
+    } else if (const auto* m = std::get_if<BitmaskExpression>(&expr)) {
+        evaluateBitmask(*m, batch, rows, out);
+    } else if (const auto* s = std::get_if<SampleExpression>(&expr)) {
+        evaluateSample(*s, batch, rows, out);
+    } else if (const auto* t = std::get_if<ThresholdExpression>(&expr)) {
+        // Children run on the whole batch, limited to the needed rows
+        const int64_t n = batch.numRows();
+        std::vector<uint8_t> open(static_cast<std::size_t>(n));
+        for (int64_t i = 0; i < n; ++i) open[i] = needed(i);
+        if constexpr (std::is_same_v<Rows, AllRows>) {
+            evaluateThreshold(*t, compiled, batch, open.data(), context, out);
+        } else {
+            std::vector<uint8_t> counted(static_cast<std::size_t>(n));
+            evaluateThreshold(*t, compiled, batch, open.data(), context, counted.data());
+            for (int64_t k = 0; k < rows.count; ++k) out[k] = counted[rows(k)];
+        }
+    } else if (const auto* e = std::get_if<ExistsExpression>(&expr)) {
+        evaluateExists(*e, batch, rows, out);
+    } else if (std::holds_alternative<ListExpression>(expr)) {
+        throw ParseException("List predicates are not supported on columns");
+    } else {
+        throw ParseException("Unknown expression type");
+    }
+}
+
+// Masks hold 0 / 1 bytes, so eight rows load as one word with one 0 / 1
+// byte per row. Words are only tested for zero, summed bytewise or stored
+// back to bytes, so the result does not depend on byte order.
+constexpr uint64_t kOnes = 0x0101010101010101ull;
+
+uint64_t neededWord(const NeededRows& needed, int64_t i) {
+    uint64_t word;
+    std::memcpy(&word, needed.acc + i, sizeof(word));
+    word ^= needed.want ? 0 : kOnes;
+    if (needed.live) {
+        uint64_t live;
+        std::memcpy(&live, needed.live + i, sizeof(live));
+        word &= live;
+    }
+    return word;
+}
+
+// Number of rows set in a neededWord: the multiply sums all bytes into the
+// top one (at most 8, so nothing carries out of it)
+int64_t neededCount(uint64_t word) {
+    return static_cast<int64_t>((word * kOnes) >> 56);
+}
+
+// Rows where needed(i) holds, counted in blocks until the count exceeds
+// `limit` (the result is then only known to be above it)
+int64_t countNeeded(const NeededRows& needed, int64_t n, int64_t limit) {
+    constexpr int64_t kBlock = 4096;
+    int64_t count = 0;
+    int64_t i = 0;
+    while (i + 8 <= n && count <= limit) {
+        const int64_t end = std::min(n & ~int64_t{7}, i + kBlock);
+        if (!needed.live) {
+            // Byte compares vectorize better than word popcounts
+            const uint8_t* acc = needed.acc;
+            const uint8_t want = needed.want;
+            uint32_t block = 0;
+            for (; i < end; ++i) block += acc[i] == want;
+            count += block;
+        } else {
+            for (; i < end; i += 8) count += neededCount(neededWord(needed, i));
+        }
+    }
+    if (count <= limit) {
+        for (; i < n; ++i) count += needed(i);
+    }
+    return count;
+}
+
+// Indices of the `count` rows where needed(i) holds; words without
+// survivors cost a single test
+void buildSelection(const NeededRows& needed, int64_t n, int64_t count, std::vector<uint32_t>& selection) {
+    selection.resize(static_cast<std::size_t>(count) + 8); // unselected rows of a word write past the end
+    uint32_t* sel = selection.data();
+    int64_t k = 0;
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const uint64_t word = neededWord(needed, i);
+        if (word == 0) {
+            continue;
+        }
+        uint8_t rows[8];
+        std::memcpy(rows, &word, sizeof(rows));
+        for (int b = 0; b < 8; ++b) {
+            sel[k] = static_cast<uint32_t>(i + b);
+            k += rows[b];
+        }
+    }
+    for (; i < n; ++i) {
+        if (needed(i)) sel[k++] = static_cast<uint32_t>(i);
+    }
+    selection.resize(static_cast<std::size_t>(count));
+}
+
+// Numeric comparisons run on whole columns as vectorized loops: building a
+// selection only pays off for them when survivors are kCompareGatherCost
+// times sparser than for other clauses
+constexpr int64_t kCompareGatherCost = 4;
+
+bool vectorizedCompare(const Expression& expr, const ColumnBatch& batch) {
+    const auto* u = std::get_if<UnaryExpression>(&expr);
+    const ColumnView* column = u ? batch.find(u->key) : nullptr;
+    return column && (column->type == DataTypes::INTEGER || column->type == DataTypes::DOUBLE);
+}
+
+// Folds `condition` into acc (numRows bytes). `live`, when set, marks the
+// rows whose result matters to an enclosing threshold.
+//
+// An AND clause only needs the rows still true and an OR clause the rows
+// still false. When those survivors are sparse (at most 1 in
+// selection_density rows) they are gathered into a selection vector and the
+// clause runs on them alone; otherwise it runs on the whole column and is
+// folded with vectorized byte ANDs / ORs. A selection of true rows is kept
+// across AND clauses and refined in place, so a chain of ANDs after a
+// selective first clause costs O(survivors) per clause.
+void evaluateCondition(const FilterCondition& condition, const CompiledBatchCondition& compiled,
+                       const ColumnBatch& batch, const uint8_t* live, EvalContext& context, uint8_t* acc) {
+    const int64_t n = batch.numRows();
+    std::fill(acc, acc + n, uint8_t{1}); // Default to true for AND operations
+    std::vector<uint8_t> clause(static_cast<std::size_t>(n));
+    std::vector<uint32_t> selection;
+    bool true_rows = false; // selection holds exactly the needed rows of an AND
+    const int64_t density = context.selection_density;
+
+    // Survivor counts above a clause's limit only need to be known as "many"
+    const int64_t sparse = density > 0 ? n / density : 0;
+
+    for (std::size_t j = 0; j < condition.sub_expressions.size(); ++j) {
+        const SubExpression& subExpr = condition.sub_expressions[j];
+        const CompiledBatchClause& compiledClause = compiled.clauses[j];
+        const LogicalOperations op = subExpr.prev_logical_op;
+        const bool refine = op == LogicalOperations::AND;
+        const bool build = !(refine && true_rows);
+        const int64_t limit = build && vectorizedCompare(subExpr.expr, batch) ? sparse / kCompareGatherCost : sparse;
+        NeededRows needed{nullptr, 0, live};
+        int64_t survivors = n;
+        switch (op) {
+            case LogicalOperations::AND:
+                needed = NeededRows{acc, 1, live};
+                survivors = true_rows ? static_cast<int64_t>(selection.size()) : countNeeded(needed, n, limit);
+                break;
+            case LogicalOperations::OR:
+                needed = NeededRows{acc, 0, live};
+                survivors = countNeeded(needed, n, limit);
+                break;
+            case LogicalOperations::NONE:
+                true_rows = false;
+                break;
+            default: throw ParseException("Unsupported logical operation");
+        }
+        if (op != LogicalOperations::NONE && survivors == 0) {
+            continue; // nothing left to AND away / OR in
+        }
+
+        if (op != LogicalOperations::NONE && density > 0 && survivors <= limit) {
+            if (build) {
+                buildSelection(needed, n, survivors, selection);
+            }
+            uint32_t* sel = selection.data();
+            evaluateClause(subExpr.expr, compiledClause, batch, needed, SelectedRows{sel, survivors}, context,
+                           clause.data());
+            // Survivors hold 1 (AND) or 0 (OR), so the clause result replaces them
+            const uint8_t* c = clause.data();
+            int64_t kept = 0;
+            for (int64_t k = 0; k < survivors; ++k) {
+                acc[sel[k]] = c[k];
+                sel[kept] = sel[k];
+                kept += c[k];
+            }
+            selection.resize(static_cast<std::size_t>(kept));
+            true_rows = refine; // an OR adds rows the selection lacks
+            continue;
+        }
+
+        true_rows = false;
+        evaluateClause(subExpr.expr, compiledClause, batch, needed, AllRows{n}, context, clause.data());
+        const uint8_t* c = clause.data();
+        switch (op) {
+            case LogicalOperations::AND:
+                for (int64_t i = 0; i < n; ++i) acc[i] &= c[i];
+                break;
+            case LogicalOperations::OR:
+                for (int64_t i = 0; i < n; ++i) acc[i] |= c[i];
+                break;
+            default:
+                std::copy(c, c + n, acc);
+                break;
+        }
+    }
+}
+
+} // namespace
+
+BatchEvaluator::BatchEvaluator() : compiled_(std::make_shared<const CompiledBatchCondition>()) {}
+
+void BatchEvaluator::initialize(const FilterCondition& condition) {
+    auto compiled = std::make_shared<const CompiledBatchCondition>(compileCondition(condition));
+    condition_ = condition;
+    compiled_ = std::move(compiled);
+}
+
+void BatchEvaluator::evaluate(const ColumnBatch& batch, std::vector<uint8_t>& matches) const {
+    const int64_t n = batch.numRows();
+    matches.resize(static_cast<std::size_t>(n));
+    EvalContext context{{}, selection_density_};
+    const RowRange range = sortedRange(condition_, batch);
+    if (range.begin == 0 && range.end == n) {
+        evaluateCondition(condition_, *compiled_, batch, nullptr, context, matches.data());
+        return;
+    }
+    std::fill(matches.begin(), matches.end(), uint8_t{0});
+    if (range.begin < range.end) {
+        evaluateCondition(condition_, *compiled_, batch.slice(range.begin, range.end - range.begin), nullptr,
+                          context, matches.data() + range.begin);
+    }
+}
+
+void BatchEvaluator::evaluate(const ColumnBatch& batch, std::vector<uint8_t>& matches,
+                              const std::vector<ArithmeticExpression>& projections,
+                              std::vector<ProjectedColumn>& out) const {
+    const int64_t n = batch.numRows();
+    matches.resize(static_cast<std::size_t>(n));
+    EvalContext context{{}, selection_density_};
+    const RowRange range = sortedRange(condition_, batch);
+    if (range.begin == 0 && range.end == n) {
+        evaluateCondition(condition_, *compiled_, batch, nullptr, context, matches.data());
+        projectInto(batch, projections, matches.data(), context.cache, out);
+        return;
+    }
+    // Filter and project the interval only, then widen the projections
+    std::fill(matches.begin(), matches.end(), uint8_t{0});
+    const ColumnBatch rows = batch.slice(range.begin, range.end - range.begin);
+    evaluateCondition(condition_, *compiled_, rows, nullptr, context, matches.data() + range.begin);
+    projectInto(rows, projections, matches.data() + range.begin, context.cache, out);
+    for (ProjectedColumn& column : out) {
+        widenProjection(column, range.begin, n);
+    }
+}
+
+void BatchEvaluator::project(const ColumnBatch& batch, const std::vector<ArithmeticExpression>& projections,
+                             std::vector<ProjectedColumn>& out) {
+    ArithmeticCache cache;
+    projectInto(batch, projections, nullptr, cache, out);
+}
+
+ColumnView ProjectedColumn::view() const {
+    ColumnView column = type == DataTypes::INTEGER
+                            ? ColumnView::ofInt64(ints.data(), static_cast<int64_t>(ints.size()))
+                            : ColumnView::ofDouble(doubles.data(), static_cast<int64_t>(doubles.size()));
+    column.validity = validity.empty() ? nullptr : validity.data();
+    return column;
+}
+
+std::vector<uint32_t> BatchEvaluator::select(const ColumnBatch& batch) const {
+    std::vector<uint8_t> mask;
+    evaluate(batch, mask);
+    return toSelection(mask);
+}
+
+std::vector<uint32_t> BatchEvaluator::select(const ColumnBatch& batch, std::size_t limit) const {
+    std::vector<uint32_t> selection;
+    std::vector<uint8_t> mask;
+    const int64_t n = batch.numRows();
+    int64_t begin = 0;
+    int64_t slice_rows = kLimitSliceRows;
+    while (begin < n && selection.size() < limit) {
+        const int64_t rows = std::min(slice_rows, n - begin);
+        if (rows == n) {
+            evaluate(batch, mask); // no slice: a conditional would copy the batch
+        } else {
+            evaluate(batch.slice(begin, rows), mask);
+        }
+        for (int64_t i = 0; i < rows && selection.size() < limit; ++i) {
+            if (mask[i]) {
+                selection.push_back(static_cast<uint32_t>(begin + i));
+            }
+        }
+        begin += rows;
+        slice_rows = std::min(slice_rows * 2, kMaxLimitSliceRows);
+    }
+    return selection;
+}
+
+bool BatchEvaluator::any(const ColumnBatch& batch) const {
+    return !select(batch, 1).empty();
+}
+
+std::vector<uint32_t> BatchEvaluator::toSelection(const std::vector<uint8_t>& mask) {
+    std::vector<uint32_t> selection;
+    selection.reserve(mask.size() / 4);
+    for (std::size_t i = 0; i < mask.size(); ++i) {
+        if (mask[i]) {
+            selection.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return selection;
+}
+
+void BatchEvaluator::exportArrow(const ColumnBatch& batch, ArrowArray* out, ArrowSchema* out_schema) const {
+    std::vector<uint8_t> mask;
+    evaluate(batch, mask);
+    exportMask(mask, out, out_schema);
+}
+
+namespace {
+
+struct ExportedMask {
+    std::vector<uint8_t> bitmap;
+    const void* buffers[2] = {nullptr, nullptr};
+};
+
+void releaseMaskArray(ArrowArray* array) {
+    delete static_cast<ExportedMask*>(array->private_data);
+    array->release = nullptr;
+}
+
+void releaseMaskSchema(ArrowSchema* schema) {
+    schema->release = nullptr;
+}
+
+} // namespace
+
+void BatchEvaluator::exportMask(const std::vector<uint8_t>& mask, ArrowArray* out, ArrowSchema* out_schema) {
+    auto* exported = new ExportedMask();
+    exported->bitmap.assign((mask.size() + 7) / 8, 0);
+    for (std::size_t i = 0; i < mask.size(); ++i) {
+        exported->bitmap[i >> 3] |= static_cast<uint8_t>((mask[i] & 1) << (i & 7));
+    }
+    exported->buffers[1] = exported->bitmap.data();
+
+    out->length = static_cast<int64_t>(mask.size());
+    out->null_count = 0;
+    out->offset = 0;
+    out->n_buffers = 2;
+    out->n_children = 0;
+    out->buffers = exported->buffers;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = releaseMaskArray;
+    out->private_data = exported;
+
+    out_schema->format = "b";
+    out_schema->name = "";
+    out_schema->metadata = nullptr;
+    out_schema->flags = 0;
+    out_schema->n_children = 0;
+    out_schema->children = nullptr;
+    out_schema->dictionary = nullptr;
+    out_schema->release = releaseMaskSchema;
+    out_schema->private_data = nullptr;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "column_batch.h"
+#include "comparison.h"
+#include <cstdint>
+
+// Column kernels for BatchEvaluator. Each loop body is branch-free so the
+// compiler can vectorize it; the operator switch sits outside the loop.
+
+// out[i] = load(i) op c, for i in [0, n)
+template <typename T, typename Load>
+void compareKernel(Load load, int64_t n, ComparisonOperations op, const T& c, uint8_t* out) {
+    switch (op) {
+        case ComparisonOperations::EQUAL:
+            for (int64_t i = 0; i < n; ++i) out[i] = load(i) == c;
+            break;
+        case ComparisonOperations::NOT_EQUAL:
+            for (int64_t i = 0; i < n; ++i) out[i] = load(i) != c;
+            break;
+        case ComparisonOperations::GREATER_THAN:
+            for (int64_t i = 0; i < n; ++i) out[i] = load(i) > c;
+            break;
+        case ComparisonOperations::LESS_THAN:
+            for (int64_t i = 0; i < n; ++i) out[i] = load(i) < c;
+            break;
+        case ComparisonOperations::GREATER_EQUAL:
+            for (int64_t i = 0; i < n; ++i) out[i] = load(i) >= c;
+            break;
+        case ComparisonOperations::LESS_EQUAL:
+            for (int64_t i = 0; i < n; ++i) out[i] = load(i) <= c;
+            break;
+        default: throw ParseException("Unsupported comparison operation");
+    }
+}
+
+// Clears out[i] for null rows of `column`
+inline void applyValidity(const ColumnView& column, int64_t n, uint8_t* out) {
+    if (!column.validity) {
+        return;
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] &= static_cast<uint8_t>(column.isValid(i));
+    }
+}
+
+// Rows a kernel runs on: rows(k) for k < count
+struct AllRows {
+    int64_t count;
+    int64_t operator()(int64_t k) const { return k; }
+};
+
+struct SelectedRows {
+    const uint32_t* sel;
+    int64_t count;
+    int64_t operator()(int64_t k) const { return sel[k]; }
+};
+
+// Clears out[k] where row rows(k) of `column` is null
+template <typename Rows>
+void applyValidity(const ColumnView& column, const Rows& rows, uint8_t* out) {
+    if (!column.validity) {
+        return;
+    }
+    for (int64_t k = 0; k < rows.count; ++k) {
+        out[k] &= static_cast<uint8_t>(column.isValid(rows(k)));
+    }
+}
+
+inline bool anySet(const uint8_t* mask, int64_t n) {
+    uint8_t any = 0;
+    for (int64_t i = 0; i < n; ++i) any |= mask[i];
+    return any != 0;
+}
+
+inline bool allSet(const uint8_t* mask, int64_t n) {
+    uint8_t all = 1;
+    for (int64_t i = 0; i < n; ++i) all &= mask[i];
+    return all != 0;
+}
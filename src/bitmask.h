@@ -0,0 +1,23 @@
+#pragma once
+
+#include "filter_structs.h"
+#include <cstdint>
+
+// A BitmaskExpression reduced to one AND and one compare:
+//   test(v) = ((v & mask) == expect) != negate
+// The shift is folded into `mask` and `expect`, so the key is never shifted;
+// ANY is the negation of NONE.
+struct BitmaskTest {
+    uint64_t mask;
+    uint64_t expect;
+    bool negate;
+
+    // Throws ParseException for a zero mask, a shift outside [0, 63], a mask
+    // that loses bits when shifted, or a FIELD_EQUAL value with bits outside
+    // the mask
+    static BitmaskTest compile(const BitmaskExpression& expr);
+
+    bool operator()(int64_t v) const {
+        return ((static_cast<uint64_t>(v) & mask) == expect) != negate;
+    }
+};
@@ -0,0 +1,41 @@
+#include "parser.h"
+#include "bitmask.h"
+#include "key_path.h"
+#include <memory>
+
+BitmaskTest BitmaskTest::compile(const BitmaskExpression& expr) {
+    const auto mask = static_cast<uint64_t>(expr.mask);
+    const auto value = static_cast<uint64_t>(expr.value);
+    if (mask == 0) {
+        throw ParseException("Bitmask predicate requires a non-zero mask: " + expr.key);
+    }
+    if (expr.shift < 0 || expr.shift > 63 || ((mask << expr.shift) >> expr.shift) != mask) {
+        throw ParseException("Bitmask does not fit in 64 bits after shifting: " + expr.key);
+    }
+    const uint64_t shifted = mask << expr.shift;
+    switch (expr.test) {
+        case BitTest::ALL: return {shifted, shifted, false};
+        case BitTest::ANY: return {shifted, 0, true};
+        case BitTest::NONE: return {shifted, 0, false};
+        case BitTest::FIELD_EQUAL:
+            if ((value & ~mask) != 0) {
+                throw ParseException("Field value has bits outside the mask: " + expr.key);
+            }
+            return {shifted, value << expr.shift, false};
+    }
+    throw ParseException("Unsupported bit test");
+}
+
+KeyPredicate LanguageParser::compileBitmaskClause(const BitmaskExpression& expr) {
+    return [test = BitmaskTest::compile(expr), path = std::make_shared<const KeyPath>(expr.key)](
+               const std::vector<Key>& keys) {
+        const Key& key = findKey(keys, *path);
+        if (const auto* v = std::get_if<int64_t>(&key.getValue())) {
+            return test(*v);
+        }
+        if (key.isText()) {
+            return test(std::get<int64_t>(textAsNumber(key, DataTypes::INTEGER)));
+        }
+        throw ParseException("Bitmask predicates require integer keys: " + key.getName());
+    };
+}
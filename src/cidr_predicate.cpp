@@ -0,0 +1,30 @@
+#include "parser.h"
+#include "cidr_set.h"
+#include "comparison.h"
+#include "key_path.h"
+#include <memory>
+
+void checkCidr(const CidrExpression& expr) {
+    if (!isEqualityComparison(expr.op)) {
+        throw ParseException("CIDR predicates support EQUAL and NOT_EQUAL only: " + expr.key);
+    }
+    if (expr.networks.empty()) {
+        throw ParseException("CIDR predicate requires at least one network: " + expr.key);
+    }
+}
+
+KeyPredicate LanguageParser::compileCidrClause(const CidrExpression& expr) {
+    checkCidr(expr);
+    return [set = std::make_shared<const CidrSet>(expr.networks), inside = expr.op == ComparisonOperations::EQUAL,
+            path = std::make_shared<const KeyPath>(expr.key)](const std::vector<Key>& keys) {
+        const Key& key = findKey(keys, *path);
+        if (key.isText()) {
+            return set->contains(textAsAddress(key)) == inside;
+        }
+        const auto* address = std::get_if<IpAddress>(&key.getValue());
+        if (!address) {
+            throw ParseException("Comparison requires operands of the same type");
+        }
+        return set->contains(*address) == inside;
+    };
+}
@@ -0,0 +1,96 @@
+#include "cidr_set.h"
+#include <algorithm>
+
+namespace {
+
+uint32_t successor(uint32_t v) {
+    return v + 1;
+}
+
+std::pair<uint64_t, uint64_t> successor(const std::pair<uint64_t, uint64_t>& v) {
+    return {v.first + (v.second == ~0ull ? 1 : 0), v.second + 1};
+}
+
+// Sorts ranges by first address and merges overlapping or adjacent ones
+template <typename T>
+void mergeRanges(std::vector<std::pair<T, T>> ranges, std::vector<T>& first, std::vector<T>& last) {
+    std::sort(ranges.begin(), ranges.end());
+    for (const auto& [lo, hi] : ranges) {
+        // successor() of the maximum wraps, but then lo <= last.back() holds
+        if (!last.empty() && (lo <= last.back() || lo == successor(last.back()))) {
+            last.back() = std::max(last.back(), hi);
+        } else {
+            first.push_back(lo);
+            last.push_back(hi);
+        }
+    }
+}
+
+// Whether v falls in one of the sorted disjoint ranges. The search narrows to
+// the last range starting at or below v with conditional moves only.
+template <typename T>
+bool inRanges(const std::vector<T>& first, const std::vector<T>& last, const T& v) {
+    std::size_t base = 0;
+    for (std::size_t n = first.size(); n > 1;) {
+        const std::size_t half = n / 2;
+        base = first[base + half] <= v ? base + half : base;
+        n -= half;
+    }
+    return first[base] <= v && v <= last[base];
+}
+
+} // namespace
+
+CidrSet::CidrSet(const std::vector<Cidr>& networks) {
+    std::vector<std::pair<uint32_t, uint32_t>> v4_ranges;
+    std::vector<std::pair<U128, U128>> v6_ranges;
+    for (const auto& cidr : networks) {
+        const IpAddress& net = cidr.network();
+        if (net.isV4()) {
+            v4_linear_.push_back({net.v4Bits(), Cidr::v4Mask(cidr.prefix())});
+            v4_ranges.emplace_back(net.v4Bits(), cidr.last().v4Bits());
+        } else {
+            v6_linear_.push_back({{net.high(), net.low()},
+                                  {Cidr::v6HalfMask(cidr.prefix(), 0), Cidr::v6HalfMask(cidr.prefix(), 64)}});
+            v6_ranges.emplace_back(U128{net.high(), net.low()}, U128{cidr.last().high(), cidr.last().low()});
+        }
+    }
+    if (v4_linear_.size() > kLinearCidrLimit) {
+        mergeRanges(std::move(v4_ranges), v4_first_, v4_last_);
+    }
+    if (v6_linear_.size() > kLinearCidrLimit) {
+        mergeRanges(std::move(v6_ranges), v6_first_, v6_last_);
+        v6_linear_.clear();
+    }
+}
+
+bool CidrSet::containsV4(uint32_t address) const {
+    if (!v4_first_.empty()) {
+        return inRanges(v4_first_, v4_last_, address);
+    }
+    bool in = false;
+    for (const auto& n : v4_linear_) in |= (address & n.mask) == n.network;
+    return in;
+}
+
+bool CidrSet::containsV6(uint64_t high, uint64_t low) const {
+    if (!v6_first_.empty()) {
+        return inRanges(v6_first_, v6_last_, U128{high, low});
+    }
+    bool in = false;
+    for (const auto& n : v6_linear_) {
+        in |= ((high & n.mask.first) == n.network.first) & ((low & n.mask.second) == n.network.second);
+    }
+    return in;
+}
+
+void CidrSet::containsV4(const uint32_t* addresses, int64_t n, uint8_t* out) const {
+    if (v4_linear_.size() > kBatchLinearCidrLimit) {
+        for (int64_t i = 0; i < n; ++i) out[i] = inRanges(v4_first_, v4_last_, addresses[i]);
+        return;
+    }
+    std::fill(out, out + n, uint8_t{0});
+    for (const auto& net : v4_linear_) {
+        for (int64_t i = 0; i < n; ++i) out[i] |= (addresses[i] & net.mask) == net.network;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "filter_structs.h"
+#include "ip_address.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// The networks of one CidrExpression, compiled for membership tests. Up to
+// kLinearCidrLimit networks per family are checked one by one with a
+// mask-and-compare; more are merged into disjoint [first, last] address
+// ranges sorted by first address and binary searched without branches.
+// Column scans vectorize the mask-and-compare passes, so they keep using them
+// up to kBatchLinearCidrLimit IPv4 networks.
+
+// Throws ParseException unless op is EQUAL or NOT_EQUAL and networks is not
+// empty; shared by the row and batch compilers
+void checkCidr(const CidrExpression& expr);
+
+constexpr std::size_t kLinearCidrLimit = 8;
+constexpr std::size_t kBatchLinearCidrLimit = 48;
+
+class CidrSet {
+public:
+    explicit CidrSet(const std::vector<Cidr>& networks);
+
+    bool contains(const IpAddress& address) const {
+        return address.isV4() ? containsV4(address.v4Bits()) : containsV6(address.high(), address.low());
+    }
+    bool containsV4(uint32_t address) const;
+    bool containsV6(uint64_t high, uint64_t low) const;
+    // out[i] = containsV4(addresses[i])
+    void containsV4(const uint32_t* addresses, int64_t n, uint8_t* out) const;
+
+private:
+    using U128 = std::pair<uint64_t, uint64_t>; // high, low: orders numerically
+
+    struct V4Network {
+        uint32_t network, mask;
+    };
+    struct V6Network {
+        U128 network, mask;
+    };
+
+    std::vector<V4Network> v4_linear_;         // always kept, for column scans
+    std::vector<uint32_t> v4_first_, v4_last_; // range table, when not linear
+    std::vector<V6Network> v6_linear_;
+    std::vector<U128> v6_first_, v6_last_;
+};
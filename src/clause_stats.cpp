@@ -0,0 +1,297 @@
+#include "clause_stats.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+// FNV-1a, fed field by field so the hash does not depend on struct padding
+struct Fnv1a {
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    void bytes(const void* data, std::size_t size) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= p[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+    void u64(uint64_t v) { bytes(&v, sizeof(v)); }
+    void str(const std::string& s) {
+        u64(s.size());
+        bytes(s.data(), s.size());
+    }
+    void real(double d) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &d, sizeof(bits));
+        u64(bits);
+    }
+    void point(const GeoPoint& p) {
+        real(p.lat);
+        real(p.lon);
+    }
+    void value(const ValueType& v) {
+        u64(v.index());
+        if (const auto* i = std::get_if<int64_t>(&v)) {
+            u64(static_cast<uint64_t>(*i));
+        } else if (const auto* d = std::get_if<double>(&v)) {
+            real(*d);
+        } else if (const auto* s = std::get_if<std::string>(&v)) {
+            str(*s);
+        } else if (const auto* b = std::get_if<bool>(&v)) {
+            u64(*b ? 1 : 0);
+        } else if (const auto* a = std::get_if<IpAddress>(&v)) {
+            u64(static_cast<uint64_t>(a->family()));
+            u64(a->high());
+            u64(a->low());
+        }
+    }
+};
+
+// Cost of evaluating a clause per unit of work it saves: AND groups want
+// cheap clauses that fail, OR groups cheap clauses that pass.
+double rank(const ClauseStats& stats, LogicalOperations group_op) {
+    const double decisive = group_op == LogicalOperations::AND ? 1.0 - stats.passRate() : stats.passRate();
+    const double cost = std::max(stats.costPerEvaluation(), 1e-3);
+    return decisive <= 0.0 ? std::numeric_limits<double>::infinity() : cost / decisive;
+}
+
+constexpr char kMagic[4] = {'E', 'X', 'S', 'T'};
+constexpr uint32_t kVersion = 1;
+
+template <typename T>
+void writePod(std::ofstream& out, T v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+bool readPod(std::ifstream& in, T& v) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&v), sizeof(v)));
+}
+
+// Children of a ThresholdExpression are hashed recursively
+void hashCondition(Fnv1a& h, const FilterCondition& condition) {
+    h.u64(condition.sub_expressions.size());
+    for (const auto& subExpr : condition.sub_expressions) {
+        h.u64(static_cast<uint64_t>(subExpr.prev_logical_op));
+        h.u64(subExpr.expr.index());
+        if (const auto* u = std::get_if<UnaryExpression>(&subExpr.expr)) {
+            h.u64(static_cast<uint64_t>(u->op));
+            h.str(u->key);
+            h.value(u->value);
+        } else if (const auto* b = std::get_if<BinaryExpression>(&subExpr.expr)) {
+            h.str(b->left_key);
+            h.u64(static_cast<uint64_t>(b->arith_op));
+            h.str(b->right_key);
+            h.u64(static_cast<uint64_t>(b->comp_op));
+            h.value(b->value);
+        } else if (const auto* l = std::get_if<ListExpression>(&subExpr.expr)) {
+            h.u64(static_cast<uint64_t>(l->quantifier));
+            h.str(l->key);
+            h.u64(static_cast<uint64_t>(l->op));
+            h.u64(l->values.size());
+            for (const auto& value : l->values) {
+                h.value(value);
+            }
+        } else if (const auto* c = std::get_if<CidrExpression>(&subExpr.expr)) {
+            h.str(c->key);
+            h.u64(static_cast<uint64_t>(c->op));
+            h.u64(c->networks.size());
+            for (const auto& cidr : c->networks) {
+                h.value(cidr.network());
+                h.u64(cidr.prefix());
+            }
+        } else if (const auto* g = std::get_if<GeoExpression>(&subExpr.expr)) {
+            h.str(g->lat_key);
+            h.str(g->lon_key);
+            h.u64(g->region.index());
+            if (const auto* box = std::get_if<GeoBox>(&g->region)) {
+                h.point(box->south_west);
+                h.point(box->north_east);
+            } else if (const auto* circle = std::get_if<GeoCircle>(&g->region)) {
+                h.point(circle->center);
+                h.real(circle->radius_m);
+            } else if (const auto* polygons = std::get_if<GeoPolygons>(&g->region)) {
+                h.u64(polygons->rings.size());
+                for (const auto& ring : polygons->rings) {
+                    h.u64(ring.size());
+                    for (const auto& p : ring) {
+                        h.point(p);
+                    }
+                }
+            }
+        } else if (const auto* m = std::get_if<BitmaskExpression>(&subExpr.expr)) {
+            h.u64(static_cast<uint64_t>(m->test));
+            h.str(m->key);
+            h.u64(static_cast<uint64_t>(m->mask));
+            h.u64(static_cast<uint64_t>(m->shift));
+            h.u64(static_cast<uint64_t>(m->value));
+        } else if (const auto* s = std::get_if<SampleExpression>(&subExpr.expr)) {
+            h.str(s->key);
+            h.real(s->rate);
+            h.u64(s->seed);
+        } else if (const auto* t = std::get_if<ThresholdExpression>(&subExpr.expr)) {
+            h.u64(t->min_count);
+            h.u64(t->children.size());
+            for (const auto& child : t->children) {
+                hashCondition(h, child);
+            }
+        } else if (const auto* e = std::get_if<ExistsExpression>(&subExpr.expr)) {
+            h.str(e->key);
+            h.u64(e->exists ? 1 : 0);
+        }
+    }
+}
+
+} // namespace
+
+uint64_t conditionFingerprint(const FilterCondition& condition) {
+    Fnv1a h;
+    hashCondition(h, condition);
+    return h.hash;
+}
+
+std::vector<std::size_t> planClauseOrder(const FilterCondition& condition,
+                                         const std::vector<ClauseStats>& stats,
+                                         uint64_t min_evaluations) {
+    const auto& subs = condition.sub_expressions;
+    std::vector<std::size_t> order(subs.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    const bool have_stats = stats.size() == subs.size();
+    // Sample clauses pass at a rate known up front, for almost no cost
+    auto sampleRate = [&subs](std::size_t i) {
+        const auto* sample = std::get_if<SampleExpression>(&subs[i].expr);
+        return sample ? sample->rate : 2.0;
+    };
+
+    auto isJoin = [](LogicalOperations op) {
+        return op == LogicalOperations::AND || op == LogicalOperations::OR;
+    };
+    std::size_t begin = 0;
+    while (begin < subs.size()) {
+        // A NONE clause resets the result, so it joins the run that follows it
+        LogicalOperations group_op = subs[begin].prev_logical_op;
+        if (group_op == LogicalOperations::NONE && begin + 1 < subs.size()) {
+            group_op = subs[begin + 1].prev_logical_op;
+        }
+        std::size_t end = begin + 1;
+        if (isJoin(group_op)) {
+            while (end < subs.size() && subs[end].prev_logical_op == group_op) {
+                ++end;
+            }
+        }
+
+        const bool sampled = have_stats && std::all_of(order.begin() + begin, order.begin() + end, [&](std::size_t i) {
+            return stats[i].evaluations >= min_evaluations;
+        });
+        if (end - begin > 1 && sampled) {
+            std::stable_sort(order.begin() + begin, order.begin() + end, [&](std::size_t a, std::size_t b) {
+                return rank(stats[a], group_op) < rank(stats[b], group_op);
+            });
+        } else if (end - begin > 1 && group_op == LogicalOperations::AND) {
+            std::stable_sort(order.begin() + begin, order.begin() + end,
+                             [&](std::size_t a, std::size_t b) { return sampleRate(a) < sampleRate(b); });
+        }
+        begin = end;
+    }
+    return order;
+}
+
+FilterCondition reorderClauses(const FilterCondition& condition, const std::vector<std::size_t>& order) {
+    FilterCondition reordered;
+    reordered.sub_expressions.reserve(order.size());
+    for (std::size_t pos = 0; pos < order.size(); ++pos) {
+        SubExpression subExpr = condition.sub_expressions[order[pos]];
+        subExpr.prev_logical_op = condition.sub_expressions[pos].prev_logical_op;
+        reordered.sub_expressions.push_back(std::move(subExpr));
+    }
+    return reordered;
+}
+
+void ClauseStatsStore::merge(uint64_t fingerprint, const std::vector<ClauseStats>& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[fingerprint];
+    if (entry.size() != stats.size()) {
+        entry.assign(stats.size(), ClauseStats{});
+    }
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        entry[i].evaluations += stats[i].evaluations;
+        entry[i].passes += stats[i].passes;
+        entry[i].cost_ns += stats[i].cost_ns;
+    }
+}
+
+std::vector<ClauseStats> ClauseStatsStore::lookup(uint64_t fingerprint) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(fingerprint);
+    return it != entries_.end() ? it->second : std::vector<ClauseStats>{};
+}
+
+std::size_t ClauseStatsStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+// Layout (host byte order): "EXST", u32 version, u64 entry count, then per
+// entry u64 fingerprint, u32 clause count and (evaluations, passes, cost_ns)
+// as u64 per clause.
+bool ClauseStatsStore::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.write(kMagic, sizeof(kMagic));
+    writePod<uint32_t>(out, kVersion);
+    writePod<uint64_t>(out, entries_.size());
+    for (const auto& entry : entries_) {
+        writePod<uint64_t>(out, entry.first);
+        writePod<uint32_t>(out, static_cast<uint32_t>(entry.second.size()));
+        for (const auto& s : entry.second) {
+            writePod<uint64_t>(out, s.evaluations);
+            writePod<uint64_t>(out, s.passes);
+            writePod<uint64_t>(out, s.cost_ns);
+        }
+    }
+    return static_cast<bool>(out.flush());
+}
+
+bool ClauseStatsStore::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    const std::streamoff end = in.tellg();
+    in.seekg(0);
+    char magic[sizeof(kMagic)] = {};
+    uint32_t version = 0;
+    uint64_t count = 0;
+    if (!in || !in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !readPod(in, version) || version != kVersion || !readPod(in, count)) {
+        return false;
+    }
+    std::vector<std::pair<uint64_t, std::vector<ClauseStats>>> loaded;
+    for (uint64_t e = 0; e < count; ++e) {
+        uint64_t fingerprint = 0;
+        uint32_t clauses = 0;
+        if (!readPod(in, fingerprint) || !readPod(in, clauses)) {
+            return false;
+        }
+        // A corrupt count must not size the allocation: the file has to hold it
+        const auto left = static_cast<uint64_t>(end - in.tellg());
+        if (clauses > left / (3 * sizeof(uint64_t))) {
+            return false;
+        }
+        std::vector<ClauseStats> stats(clauses);
+        for (auto& s : stats) {
+            if (!readPod(in, s.evaluations) || !readPod(in, s.passes) || !readPod(in, s.cost_ns)) {
+                return false;
+            }
+        }
+        loaded.emplace_back(fingerprint, std::move(stats));
+    }
+    for (const auto& entry : loaded) {
+        merge(entry.first, entry.second);
+    }
+    return true;
+}
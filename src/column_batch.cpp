@@ -0,0 +1,147 @@
+#include "column_batch.h"
+#include "parser.h"
+#include <algorithm>
+#include <cstring>
+
+ColumnView ColumnView::ofInt64(const int64_t* values, int64_t length) {
+    ColumnView view;
+    view.type = DataTypes::INTEGER;
+    view.length = length;
+    view.values = values;
+    return view;
+}
+
+ColumnView ColumnView::ofDouble(const double* values, int64_t length) {
+    ColumnView view;
+    view.type = DataTypes::DOUBLE;
+    view.length = length;
+    view.values = values;
+    return view;
+}
+
+ColumnView ColumnView::ofBoolBitmap(const uint8_t* bitmap, int64_t length) {
+    ColumnView view;
+    view.type = DataTypes::BOOLEAN;
+    view.length = length;
+    view.values = bitmap;
+    return view;
+}
+
+ColumnView ColumnView::ofStrings(const int32_t* offsets, const char* data, int64_t length) {
+    ColumnView view;
+    view.type = DataTypes::STRING;
+    view.length = length;
+    view.offsets = offsets;
+    view.data = data;
+    return view;
+}
+
+ColumnView ColumnView::ofIpv4(const uint8_t* bytes, int64_t length) {
+    ColumnView view;
+    view.type = DataTypes::IP_ADDRESS;
+    view.length = length;
+    view.values = bytes;
+    view.byte_width = 4;
+    return view;
+}
+
+ColumnView ColumnView::ofIpv6(const uint8_t* bytes, int64_t length) {
+    ColumnView view = ofIpv4(bytes, length);
+    view.byte_width = 16;
+    return view;
+}
+
+void ColumnBatch::addColumn(const std::string& name, const ColumnView& column) {
+    if (!columns_.empty() && column.length != rows_) {
+        throw ParseException("Column length mismatch: " + name);
+    }
+    rows_ = column.length;
+    names_.push_back(name);
+    columns_.push_back(column);
+}
+
+const ColumnView* ColumnBatch::find(const std::string& name) const {
+    auto it = std::find(names_.begin(), names_.end(), name);
+    return it != names_.end() ? &columns_[static_cast<std::size_t>(it - names_.begin())] : nullptr;
+}
+
+void ColumnBatch::setSorted(const std::string& name, bool sorted) {
+    auto it = std::find(names_.begin(), names_.end(), name);
+    if (it == names_.end()) {
+        throw ParseException("Key not found: " + name);
+    }
+    columns_[static_cast<std::size_t>(it - names_.begin())].sorted = sorted;
+}
+
+ColumnBatch ColumnBatch::slice(int64_t offset, int64_t length) const {
+    if (offset < 0 || length < 0 || offset + length > rows_) {
+        throw ParseException("Slice out of range");
+    }
+    ColumnBatch sliced;
+    sliced.names_ = names_;
+    sliced.columns_ = columns_;
+    for (ColumnView& column : sliced.columns_) {
+        column.offset += offset;
+        column.length = length;
+    }
+    sliced.rows_ = length;
+    return sliced;
+}
+
+void ColumnBatch::addArrowColumn(const std::string& name, const ArrowArray& array, const ArrowSchema& schema) {
+    if (!schema.format || array.n_buffers < 2) {
+        throw ParseException("Invalid Arrow array: " + name);
+    }
+    // A dictionary-encoded column keeps its index type in `format`; reading
+    // the indices as values would evaluate the wrong data.
+    if (schema.dictionary || array.dictionary) {
+        throw ParseException("Dictionary-encoded Arrow columns are not supported: " + name);
+    }
+    ColumnView view;
+    view.length = array.length;
+    view.offset = array.offset;
+    view.validity = array.null_count != 0 ? static_cast<const uint8_t*>(array.buffers[0]) : nullptr;
+
+    const std::string format(schema.format);
+    if (format == "l") {
+        view.type = DataTypes::INTEGER;
+        view.values = array.buffers[1];
+    } else if (format == "g") {
+        view.type = DataTypes::DOUBLE;
+        view.values = array.buffers[1];
+    } else if (format == "b") {
+        view.type = DataTypes::BOOLEAN;
+        view.values = array.buffers[1];
+    } else if (format == "w:4" || format == "w:16") {
+        view.type = DataTypes::IP_ADDRESS;
+        view.values = array.buffers[1];
+        view.byte_width = format == "w:4" ? 4 : 16;
+    } else if (format == "u" && array.n_buffers >= 3) {
+        view.type = DataTypes::STRING;
+        view.offsets = static_cast<const int32_t*>(array.buffers[1]);
+        view.data = static_cast<const char*>(array.buffers[2]);
+    } else {
+        throw ParseException("Unsupported Arrow format '" + format + "' for column: " + name);
+    }
+    addColumn(name, view);
+}
+
+ColumnBatch ColumnBatch::fromArrow(const ArrowArray& array, const ArrowSchema& schema) {
+    if (!schema.format || std::strcmp(schema.format, "+s") != 0 || array.n_children != schema.n_children) {
+        throw ParseException("Arrow import expects a struct array");
+    }
+    if (array.null_count != 0) {
+        throw ParseException("Struct-level nulls are not supported");
+    }
+    ColumnBatch batch;
+    for (int64_t i = 0; i < array.n_children; ++i) {
+        const ArrowSchema& child_schema = *schema.children[i];
+        ArrowArray child = *array.children[i];
+        // The parent's offset applies on top of the child's own
+        child.offset += array.offset;
+        child.length = array.length;
+        batch.addArrowColumn(child_schema.name ? child_schema.name : "", child, child_schema);
+    }
+    batch.rows_ = array.length;
+    return batch;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "enums.h"
+#include "parser.h"
+
+// Shared comparison kernels for the row, struct and batch evaluation paths.
+
+template <typename T>
+inline bool compareOrdered(const T& l, ComparisonOperations op, const T& r) {
+    switch (op) {
+        case ComparisonOperations::EQUAL: return l == r;
+        case ComparisonOperations::NOT_EQUAL: return l != r;
+        case ComparisonOperations::GREATER_THAN: return l > r;
+        case ComparisonOperations::LESS_THAN: return l < r;
+        case ComparisonOperations::GREATER_EQUAL: return l >= r;
+        case ComparisonOperations::LESS_EQUAL: return l <= r;
+        default: throw ParseException("Unsupported comparison operation");
+    }
+}
+
+inline bool compareBool(bool l, ComparisonOperations op, bool r) {
+    switch (op) {
+        case ComparisonOperations::EQUAL: return l == r;
+        case ComparisonOperations::NOT_EQUAL: return l != r;
+        default: throw ParseException("Unsupported comparison operation for boolean");
+    }
+}
+
+// DataTypes of the alternative held by `value`
+inline DataTypes valueDataType(const ValueType& value) {
+    if (std::holds_alternative<int64_t>(value)) return DataTypes::INTEGER;
+    if (std::holds_alternative<double>(value)) return DataTypes::DOUBLE;
+    if (std::holds_alternative<std::string>(value)) return DataTypes::STRING;
+    if (std::holds_alternative<IpAddress>(value)) return DataTypes::IP_ADDRESS;
+    return DataTypes::BOOLEAN;
+}
+
+inline bool isNumeric(DataTypes type) {
+    return type == DataTypes::INTEGER || type == DataTypes::DOUBLE;
+}
+
+// Whether `op` is allowed on booleans (equality only)
+inline bool isEqualityComparison(ComparisonOperations op) {
+    return op == ComparisonOperations::EQUAL || op == ComparisonOperations::NOT_EQUAL;
+}
@@ -0,0 +1,216 @@
+#include "cost_profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+// Per-thread open-addressed table. Only the owning thread writes a slot, so
+// updates are plain relaxed load/store pairs; readers merge with relaxed loads.
+constexpr std::size_t kSlots = 4096; // power of two
+constexpr std::size_t kMaxProbe = 16;
+
+struct Slot {
+    std::atomic<uint64_t> plan_id{0};
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> sampled_calls{0};
+    std::atomic<uint64_t> sampled_cycles{0};
+};
+
+// Bumped by reset(); a table whose epoch is older holds stale counts
+std::atomic<uint64_t> g_epoch{0};
+
+struct ThreadTable {
+    Slot slots[kSlots];
+    Slot overflow; // counts of evicted plans, reported as plan 0
+    std::atomic<uint64_t> epoch{g_epoch.load(std::memory_order_acquire)};
+    std::atomic<bool> in_use{true};
+    ThreadTable* next = nullptr;
+};
+
+// Tables are never freed: a thread that exits releases its table for reuse
+// by the next new thread, and its counts stay visible to report().
+std::atomic<ThreadTable*> g_tables{nullptr};
+std::atomic<uint32_t> g_period{64};
+
+// Token of a call that is counted but not timed; sampled calls pass an odd
+// timestamp
+constexpr uint64_t kUnsampled = 2;
+
+ThreadTable* acquireTable() {
+    for (ThreadTable* t = g_tables.load(std::memory_order_acquire); t; t = t->next) {
+        bool expected = false;
+        if (t->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return t;
+        }
+    }
+    auto* table = new ThreadTable();
+    table->next = g_tables.load(std::memory_order_relaxed);
+    while (!g_tables.compare_exchange_weak(table->next, table, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+    return table;
+}
+
+struct TableHandle {
+    ThreadTable* table = acquireTable();
+    ~TableHandle() { table->in_use.store(false, std::memory_order_release); }
+};
+
+thread_local TableHandle t_handle;
+thread_local uint32_t t_countdown = 0;
+
+inline void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void clearSlot(Slot& slot) {
+    slot.calls.store(0, std::memory_order_relaxed);
+    slot.sampled_calls.store(0, std::memory_order_relaxed);
+    slot.sampled_cycles.store(0, std::memory_order_relaxed);
+}
+
+// The calling thread's table, cleared first if reset() ran since its last
+// use. The slots are zeroed before the new epoch is published, so report()
+// never counts stale values under the current epoch.
+ThreadTable& ownTable() {
+    ThreadTable& table = *t_handle.table;
+    const uint64_t epoch = g_epoch.load(std::memory_order_acquire);
+    if (table.epoch.load(std::memory_order_relaxed) != epoch) {
+        for (Slot& slot : table.slots) {
+            slot.plan_id.store(0, std::memory_order_relaxed); // frees the slot for new plans
+            clearSlot(slot);
+        }
+        clearSlot(table.overflow);
+        table.epoch.store(epoch, std::memory_order_release);
+    }
+    return table;
+}
+
+// Plan IDs grow with every initialize, so a long-running process keeps
+// bringing new plans. When the probe window holds no free slot, the plan with
+// the fewest calls there (usually one no longer evaluated) is evicted: its
+// counts move to the overflow slot and the new plan takes its place.
+Slot& findSlot(ThreadTable& table, uint64_t plan_id) {
+    std::size_t index = static_cast<std::size_t>((plan_id * 0x9E3779B97F4A7C15ull) >> 52) & (kSlots - 1);
+    Slot* victim = nullptr;
+    uint64_t victim_calls = 0;
+    for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+        Slot& slot = table.slots[(index + probe) & (kSlots - 1)];
+        const uint64_t owner = slot.plan_id.load(std::memory_order_relaxed);
+        if (owner == plan_id) {
+            return slot;
+        }
+        if (owner == 0) {
+            slot.plan_id.store(plan_id, std::memory_order_relaxed);
+            return slot;
+        }
+        const uint64_t calls = slot.calls.load(std::memory_order_relaxed);
+        if (!victim || calls < victim_calls) {
+            victim = &slot;
+            victim_calls = calls;
+        }
+    }
+    bump(table.overflow.calls, victim_calls);
+    bump(table.overflow.sampled_calls, victim->sampled_calls.load(std::memory_order_relaxed));
+    bump(table.overflow.sampled_cycles, victim->sampled_cycles.load(std::memory_order_relaxed));
+    clearSlot(*victim);
+    victim->plan_id.store(plan_id, std::memory_order_relaxed);
+    return *victim;
+}
+
+uint64_t readTimestamp() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // namespace
+
+void CostProfiler::setSamplePeriod(uint32_t period) {
+    g_period.store(period ? period : 1, std::memory_order_relaxed);
+}
+
+uint64_t CostProfiler::beginSlow() {
+    if (t_countdown > 1) {
+        --t_countdown;
+        return kUnsampled;
+    }
+    t_countdown = g_period.load(std::memory_order_relaxed);
+    return readTimestamp() | 1; // odd, so never 0 or kUnsampled
+}
+
+void CostProfiler::endSlow(uint64_t plan_id, uint64_t token) {
+    // Stop the clock before touching the table: the first call on a thread
+    // allocates it, and that cost belongs to the profiler, not the plan.
+    const bool sampled = (token & 1) != 0;
+    const uint64_t now = sampled ? readTimestamp() : 0;
+    Slot& slot = findSlot(ownTable(), plan_id);
+    bump(slot.calls, 1);
+    if (sampled) {
+        bump(slot.sampled_calls, 1);
+        bump(slot.sampled_cycles, now > token ? now - token : 0);
+    }
+}
+
+std::vector<ConditionCost> CostProfiler::report(std::size_t n, CostOrder order) {
+    std::unordered_map<uint64_t, ConditionCost> merged;
+    auto add = [&merged](const Slot& slot, uint64_t plan_id) {
+        const uint64_t calls = slot.calls.load(std::memory_order_relaxed);
+        if (calls == 0) {
+            return;
+        }
+        auto& cost = merged.try_emplace(plan_id, ConditionCost{plan_id, 0, 0, 0}).first->second;
+        cost.calls += calls;
+        cost.sampled_calls += slot.sampled_calls.load(std::memory_order_relaxed);
+        cost.sampled_cycles += slot.sampled_cycles.load(std::memory_order_relaxed);
+    };
+    const uint64_t epoch = g_epoch.load(std::memory_order_acquire);
+    for (ThreadTable* t = g_tables.load(std::memory_order_acquire); t; t = t->next) {
+        if (t->epoch.load(std::memory_order_acquire) != epoch) {
+            continue; // not yet cleared by its owner since the last reset()
+        }
+        for (const Slot& slot : t->slots) {
+            const uint64_t plan_id = slot.plan_id.load(std::memory_order_relaxed);
+            if (plan_id != 0) {
+                add(slot, plan_id);
+            }
+        }
+        add(t->overflow, 0);
+    }
+
+    std::vector<ConditionCost> result;
+    result.reserve(merged.size());
+    for (const auto& entry : merged) {
+        result.push_back(entry.second);
+    }
+    auto key = [order](const ConditionCost& c) -> double {
+        switch (order) {
+            case CostOrder::TOTAL: return c.estimatedTotalCycles();
+            case CostOrder::CALLS: return static_cast<double>(c.calls);
+            case CostOrder::PER_CALL: return c.cyclesPerCall();
+        }
+        return 0.0;
+    };
+    const std::size_t top = std::min(n, result.size());
+    std::partial_sort(result.begin(), result.begin() + top, result.end(),
+                      [&key](const ConditionCost& a, const ConditionCost& b) {
+                          const double ka = key(a);
+                          const double kb = key(b);
+                          return ka != kb ? ka > kb : a.plan_id < b.plan_id;
+                      });
+    result.resize(top);
+    return result;
+}
+
+void CostProfiler::reset() {
+    g_epoch.fetch_add(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,46 @@
+#include "evaluator.h"
+#include <chrono>
+
+void Evaluator::initialize(const FilterCondition& condition, ClauseStatsStore& stats) {
+    const uint64_t new_id = nextPlanId();
+    EXPR_EVAL_PROBE2(initialize_start, new_id, condition.sub_expressions.size());
+    flushStats();
+    fingerprint_ = conditionFingerprint(condition);
+    clause_order_ = planClauseOrder(condition, stats.lookup(fingerprint_));
+    clauses_ = std::make_shared<const std::vector<CompiledClause>>(
+        LanguageParser::compile(reorderClauses(condition, clause_order_)));
+    clause_stats_.assign(condition.sub_expressions.size(), ClauseStats{});
+    stats_countdown_ = kStatsSamplePeriod;
+    stats_store_ = &stats;
+    install(new_id, condition, LanguageParser::fold(clauses_));
+}
+
+bool Evaluator::evaluateSampled(const std::vector<Key>& keys) {
+    stats_countdown_ = kStatsSamplePeriod;
+    bool result = true;
+    const auto& clauses = *clauses_;
+    for (std::size_t pos = 0; pos < clauses.size(); ++pos) {
+        const auto& clause = clauses[pos];
+        if (!LanguageParser::needsClause(result, clause.prev_logical_op)) {
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const bool subResult = clause.predicate(keys);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        auto& stats = clause_stats_[clause_order_[pos]];
+        stats.evaluations += 1;
+        stats.passes += subResult ? 1 : 0;
+        stats.cost_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        result = LanguageParser::combine(result, clause.prev_logical_op, subResult);
+    }
+    return result;
+}
+
+void Evaluator::flushStats() {
+    if (!stats_store_) {
+        return;
+    }
+    stats_store_->merge(fingerprint_, clause_stats_);
+    clause_stats_.assign(clause_stats_.size(), ClauseStats{});
+}
@@ -0,0 +1,25 @@
+#include "parser.h"
+#include "geo_region.h"
+#include "key_path.h"
+#include <memory>
+
+KeyPredicate LanguageParser::compileGeoClause(const GeoExpression& expr) {
+    // Degrees from a double, integer or numeric text key
+    auto coordinate = [](const Key& key) {
+        if (key.isText()) {
+            return std::get<double>(textAsNumber(key, DataTypes::DOUBLE));
+        }
+        if (const auto* d = std::get_if<double>(&key.getValue())) {
+            return *d;
+        }
+        if (const auto* i = std::get_if<int64_t>(&key.getValue())) {
+            return static_cast<double>(*i);
+        }
+        throw ParseException("Geo predicates require numeric coordinates: " + key.getName());
+    };
+    return [region = std::make_shared<const GeoRegion>(expr.region), coordinate,
+            lat = std::make_shared<const KeyPath>(expr.lat_key),
+            lon = std::make_shared<const KeyPath>(expr.lon_key)](const std::vector<Key>& keys) {
+        return region->contains(coordinate(findKey(keys, *lat)), coordinate(findKey(keys, *lon)));
+    };
+}
@@ -0,0 +1,211 @@
+#include "geo_region.h"
+#include "parser.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kEarthRadiusM = 6371008.8; // mean radius
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kRadians = kPi / 180.0;
+
+void checkPoint(const GeoPoint& p) {
+    if (!(p.lat >= -90.0 && p.lat <= 90.0 && p.lon >= -180.0 && p.lon <= 180.0)) {
+        throw ParseException("Coordinates out of range: " + std::to_string(p.lat) + ", " + std::to_string(p.lon));
+    }
+}
+
+// Longitude separation in degrees, going around the antimeridian if shorter
+double lonDistance(double lon, double center) {
+    const double d = std::fabs(lon - center);
+    return std::min(d, 360.0 - d);
+}
+
+double square(double x) {
+    return x * x;
+}
+
+} // namespace
+
+GeoRegion::GeoRegion(const GeoRegionSpec& spec) {
+    if (const auto* box = std::get_if<GeoBox>(&spec)) {
+        checkPoint(box->south_west);
+        checkPoint(box->north_east);
+        if (box->south_west.lat > box->north_east.lat) {
+            throw ParseException("Box south edge lies north of its north edge");
+        }
+        shape_ = Shape::BOX;
+        south_ = box->south_west.lat;
+        north_ = box->north_east.lat;
+        west_ = box->south_west.lon;
+        east_ = box->north_east.lon;
+        wraps_ = west_ > east_;
+    } else if (const auto* circle = std::get_if<GeoCircle>(&spec)) {
+        checkPoint(circle->center);
+        if (!(circle->radius_m >= 0.0) || std::isinf(circle->radius_m)) {
+            throw ParseException("Circle radius must be a non-negative number of meters");
+        }
+        shape_ = Shape::CIRCLE;
+        center_lat_ = circle->center.lat;
+        center_lon_ = circle->center.lon;
+        cos_center_lat_ = std::cos(center_lat_ * kRadians);
+        const double angle = std::min(circle->radius_m / kEarthRadiusM, kPi);
+        max_haversine_ = square(std::sin(angle / 2.0));
+        // Bounding box: the latitude band, and the widest longitude reach,
+        // which is everything once the circle covers a pole
+        const double reach = angle / kRadians;
+        south_ = center_lat_ - reach;
+        north_ = center_lat_ + reach;
+        const double s = std::sin(angle);
+        half_width_ = (south_ <= -90.0 || north_ >= 90.0 || s >= cos_center_lat_)
+                          ? 180.0
+                          : std::asin(s / cos_center_lat_) / kRadians;
+    } else {
+        const auto& polygons = std::get<GeoPolygons>(spec);
+        if (polygons.rings.empty()) {
+            throw ParseException("Polygon region requires at least one ring");
+        }
+        shape_ = Shape::POLYGONS;
+        for (const auto& points : polygons.rings) {
+            if (points.size() < 3) {
+                throw ParseException("Polygon ring requires at least three vertices");
+            }
+            Ring ring{points, {90.0, -90.0, 180.0, -180.0}};
+            for (const auto& p : points) {
+                checkPoint(p);
+                ring.bounds.min_lat = std::min(ring.bounds.min_lat, p.lat);
+                ring.bounds.max_lat = std::max(ring.bounds.max_lat, p.lat);
+                ring.bounds.min_lon = std::min(ring.bounds.min_lon, p.lon);
+                ring.bounds.max_lon = std::max(ring.bounds.max_lon, p.lon);
+            }
+            rings_.push_back(std::move(ring));
+        }
+        all_ = rings_.front().bounds;
+        for (const auto& ring : rings_) {
+            all_.min_lat = std::min(all_.min_lat, ring.bounds.min_lat);
+            all_.max_lat = std::max(all_.max_lat, ring.bounds.max_lat);
+            all_.min_lon = std::min(all_.min_lon, ring.bounds.min_lon);
+            all_.max_lon = std::max(all_.max_lon, ring.bounds.max_lon);
+        }
+        if (rings_.size() > kGridRingLimit) {
+            buildGrid();
+        }
+    }
+}
+
+void GeoRegion::buildGrid() {
+    // About four cells per ring, square-ish, between 4x4 and 256x256
+    const int side = std::clamp(static_cast<int>(std::ceil(std::sqrt(4.0 * rings_.size()))), 4, 256);
+    grid_rows_ = grid_cols_ = side;
+    cell_lat_ = std::max(all_.max_lat - all_.min_lat, 1e-9) / side;
+    cell_lon_ = std::max(all_.max_lon - all_.min_lon, 1e-9) / side;
+
+    auto row = [this](double lat) {
+        return std::clamp(static_cast<int>((lat - all_.min_lat) / cell_lat_), 0, grid_rows_ - 1);
+    };
+    auto col = [this](double lon) {
+        return std::clamp(static_cast<int>((lon - all_.min_lon) / cell_lon_), 0, grid_cols_ - 1);
+    };
+    std::vector<std::vector<uint32_t>> cells(static_cast<std::size_t>(side) * side);
+    for (std::size_t r = 0; r < rings_.size(); ++r) {
+        const Bounds& b = rings_[r].bounds;
+        for (int y = row(b.min_lat); y <= row(b.max_lat); ++y) {
+            for (int x = col(b.min_lon); x <= col(b.max_lon); ++x) {
+                cells[static_cast<std::size_t>(y) * side + x].push_back(static_cast<uint32_t>(r));
+            }
+        }
+    }
+    cell_begin_.reserve(cells.size() + 1);
+    cell_begin_.push_back(0);
+    for (const auto& cell : cells) {
+        cell_rings_.insert(cell_rings_.end(), cell.begin(), cell.end());
+        cell_begin_.push_back(static_cast<uint32_t>(cell_rings_.size()));
+    }
+}
+
+bool GeoRegion::inBox(double lat, double lon) const {
+    const bool in_lat = (lat >= south_) & (lat <= north_);
+    const bool in_lon = wraps_ ? (lon >= west_) | (lon <= east_) : (lon >= west_) & (lon <= east_);
+    return in_lat & in_lon;
+}
+
+bool GeoRegion::inCircle(double lat, double lon) const {
+    const double haversine = square(std::sin((lat - center_lat_) * kRadians / 2.0)) +
+                             cos_center_lat_ * std::cos(lat * kRadians) *
+                                 square(std::sin((lon - center_lon_) * kRadians / 2.0));
+    return haversine <= max_haversine_;
+}
+
+bool GeoRegion::inRing(const Ring& ring, double lat, double lon) {
+    if (!ring.bounds.contains(lat, lon)) {
+        return false;
+    }
+    const auto& p = ring.points;
+    bool in = false;
+    for (std::size_t i = 0, j = p.size() - 1; i < p.size(); j = i++) {
+        if ((p[i].lat > lat) != (p[j].lat > lat) &&
+            lon < (p[j].lon - p[i].lon) * (lat - p[i].lat) / (p[j].lat - p[i].lat) + p[i].lon) {
+            in = !in;
+        }
+    }
+    return in;
+}
+
+bool GeoRegion::inPolygons(double lat, double lon) const {
+    if (!all_.contains(lat, lon)) {
+        return false;
+    }
+    if (grid_rows_ == 0) {
+        return std::any_of(rings_.begin(), rings_.end(), [&](const Ring& ring) { return inRing(ring, lat, lon); });
+    }
+    const int y = std::min(static_cast<int>((lat - all_.min_lat) / cell_lat_), grid_rows_ - 1);
+    const int x = std::min(static_cast<int>((lon - all_.min_lon) / cell_lon_), grid_cols_ - 1);
+    const std::size_t cell = static_cast<std::size_t>(y) * grid_cols_ + x;
+    for (uint32_t k = cell_begin_[cell]; k < cell_begin_[cell + 1]; ++k) {
+        if (inRing(rings_[cell_rings_[k]], lat, lon)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GeoRegion::contains(double lat, double lon) const {
+    switch (shape_) {
+        case Shape::BOX: return inBox(lat, lon);
+        case Shape::CIRCLE:
+            return (lat >= south_) & (lat <= north_) & (lonDistance(lon, center_lon_) <= half_width_) &&
+                   inCircle(lat, lon);
+        case Shape::POLYGONS: return inPolygons(lat, lon);
+    }
+    return false;
+}
+
+void GeoRegion::contains(const double* lat, const double* lon, int64_t n, uint8_t* out) const {
+    switch (shape_) {
+        case Shape::BOX:
+            // Separate loops so the wrap test is not evaluated per row
+            if (wraps_) {
+                for (int64_t i = 0; i < n; ++i) {
+                    out[i] = (lat[i] >= south_) & (lat[i] <= north_) & ((lon[i] >= west_) | (lon[i] <= east_));
+                }
+            } else {
+                for (int64_t i = 0; i < n; ++i) {
+                    out[i] = (lat[i] >= south_) & (lat[i] <= north_) & (lon[i] >= west_) & (lon[i] <= east_);
+                }
+            }
+            break;
+        case Shape::CIRCLE:
+            // Branch-free bounding-box pass, then the haversine for survivors
+            for (int64_t i = 0; i < n; ++i) {
+                const double d = std::fabs(lon[i] - center_lon_);
+                out[i] = (lat[i] >= south_) & (lat[i] <= north_) & (std::min(d, 360.0 - d) <= half_width_);
+            }
+            for (int64_t i = 0; i < n; ++i) {
+                if (out[i]) out[i] = inCircle(lat[i], lon[i]);
+            }
+            break;
+        case Shape::POLYGONS:
+            for (int64_t i = 0; i < n; ++i) out[i] = inPolygons(lat[i], lon[i]);
+            break;
+    }
+}
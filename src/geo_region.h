@@ -0,0 +1,67 @@
+#pragma once
+
+#include "geo.h"
+#include <cstdint>
+#include <vector>
+
+// A GeoRegionSpec checked and prepared once, for the row and batch paths.
+//
+// Boxes are two branch-free range tests. Circles first test the circle's
+// bounding box the same way (longitude distance taken around the
+// antimeridian) and run the haversine only on points inside it. Polygon rings
+// are ray-cast after a bounding-box check; above kGridRingLimit rings a
+// uniform grid over their common bounds lists, per cell, the rings whose
+// bounds overlap it, so a point only visits the rings near it.
+
+constexpr std::size_t kGridRingLimit = 4;
+
+class GeoRegion {
+public:
+    // Throws ParseException for out-of-range coordinates, a negative radius
+    // or rings with fewer than three vertices
+    explicit GeoRegion(const GeoRegionSpec& spec);
+
+    bool contains(double lat, double lon) const;
+    // out[i] = contains(lat[i], lon[i])
+    void contains(const double* lat, const double* lon, int64_t n, uint8_t* out) const;
+
+private:
+    enum class Shape : uint8_t { BOX, CIRCLE, POLYGONS };
+
+    struct Bounds {
+        double min_lat, max_lat, min_lon, max_lon;
+        bool contains(double lat, double lon) const {
+            return (lat >= min_lat) & (lat <= max_lat) & (lon >= min_lon) & (lon <= max_lon);
+        }
+    };
+    struct Ring {
+        std::vector<GeoPoint> points;
+        Bounds bounds;
+    };
+
+    bool inBox(double lat, double lon) const;
+    bool inCircle(double lat, double lon) const;
+    bool inPolygons(double lat, double lon) const;
+    static bool inRing(const Ring& ring, double lat, double lon);
+    void buildGrid();
+
+    Shape shape_;
+
+    // BOX, and the bounding box of a CIRCLE: south / north, west / east edges;
+    // wraps_ when the longitude range crosses the antimeridian
+    double south_ = 0, north_ = 0, west_ = 0, east_ = 0;
+    bool wraps_ = false;
+
+    // CIRCLE: center, its longitude half-width in degrees for the bounding
+    // box, and the haversine bound sin^2(radius / 2R)
+    double center_lat_ = 0, center_lon_ = 0, cos_center_lat_ = 1;
+    double half_width_ = 0, max_haversine_ = 0;
+
+    // POLYGONS
+    std::vector<Ring> rings_;
+    Bounds all_{};                       // union of the ring bounds
+    int grid_rows_ = 0, grid_cols_ = 0;  // 0: no grid
+    double cell_lat_ = 0, cell_lon_ = 0; // cell size in degrees
+    std::vector<uint32_t> cell_begin_;   // CSR offsets into cell_rings_
+    std::vector<uint32_t> cell_rings_;
+};
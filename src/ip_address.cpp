@@ -0,0 +1,193 @@
+#include "ip_address.h"
+#include "parser.h"
+#include <charconv>
+#include <cstdio>
+
+namespace {
+
+bool parseV4(std::string_view text, uint32_t& out) {
+    uint32_t address = 0;
+    for (int octet = 0; octet < 4; ++octet) {
+        if (octet > 0) {
+            if (text.empty() || text.front() != '.') return false;
+            text.remove_prefix(1);
+        }
+        // 1-3 digits, no leading zeros (they read as octal elsewhere)
+        std::size_t digits = 0;
+        while (digits < text.size() && digits < 4 && text[digits] >= '0' && text[digits] <= '9') ++digits;
+        if (digits == 0 || digits > 3 || (digits > 1 && text.front() == '0')) return false;
+        unsigned value = 0;
+        std::from_chars(text.data(), text.data() + digits, value);
+        if (value > 255) return false;
+        address = (address << 8) | value;
+        text.remove_prefix(digits);
+    }
+    if (!text.empty()) return false;
+    out = address;
+    return true;
+}
+
+// Colon-separated groups of one side of "::". A dotted IPv4 tail is allowed
+// as the last group when `tail` is set and counts as two groups.
+bool parseGroups(std::string_view text, bool tail, uint16_t* groups, int& count) {
+    count = 0;
+    if (text.empty()) return true;
+    while (true) {
+        const std::size_t colon = text.find(':');
+        const std::string_view group = text.substr(0, colon);
+        if (colon == std::string_view::npos && tail && group.find('.') != std::string_view::npos) {
+            uint32_t v4 = 0;
+            if (count > 6 || !parseV4(group, v4)) return false;
+            groups[count++] = static_cast<uint16_t>(v4 >> 16);
+            groups[count++] = static_cast<uint16_t>(v4);
+            return true;
+        }
+        if (group.empty() || group.size() > 4 || count == 8) return false;
+        unsigned value = 0;
+        const auto [ptr, ec] = std::from_chars(group.data(), group.data() + group.size(), value, 16);
+        if (ec != std::errc() || ptr != group.data() + group.size()) return false;
+        groups[count++] = static_cast<uint16_t>(value);
+        if (colon == std::string_view::npos) return true;
+        text.remove_prefix(colon + 1);
+    }
+}
+
+bool parseV6(std::string_view text, uint64_t& high, uint64_t& low) {
+    uint16_t groups[8] = {};
+    const std::size_t gap = text.find("::");
+    if (gap == std::string_view::npos) {
+        int count = 0;
+        if (!parseGroups(text, true, groups, count) || count != 8) return false;
+    } else {
+        if (text.find("::", gap + 1) != std::string_view::npos) return false;
+        uint16_t head[8], rest[8];
+        int head_count = 0, rest_count = 0;
+        if (!parseGroups(text.substr(0, gap), false, head, head_count) ||
+            !parseGroups(text.substr(gap + 2), true, rest, rest_count) || head_count + rest_count > 7) {
+            return false;
+        }
+        for (int i = 0; i < head_count; ++i) groups[i] = head[i];
+        for (int i = 0; i < rest_count; ++i) groups[8 - rest_count + i] = rest[i];
+    }
+    high = low = 0;
+    for (int i = 0; i < 4; ++i) high = (high << 16) | groups[i];
+    for (int i = 4; i < 8; ++i) low = (low << 16) | groups[i];
+    return true;
+}
+
+} // namespace
+
+bool IpAddress::parse(std::string_view text, IpAddress& out) {
+    if (text.find(':') == std::string_view::npos) {
+        uint32_t v4 = 0;
+        if (!parseV4(text, v4)) return false;
+        out = IpAddress::v4(v4);
+        return true;
+    }
+    uint64_t high = 0, low = 0;
+    if (!parseV6(text, high, low)) return false;
+    out = IpAddress::v6(high, low);
+    return true;
+}
+
+IpAddress IpAddress::fromString(std::string_view text) {
+    IpAddress address;
+    if (!parse(text, address)) {
+        throw ParseException("Invalid IP address: " + std::string(text));
+    }
+    return address;
+}
+
+std::string IpAddress::str() const {
+    char buffer[48];
+    if (isV4()) {
+        const uint32_t a = v4Bits();
+        std::snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", a >> 24, (a >> 16) & 255, (a >> 8) & 255, a & 255);
+        return buffer;
+    }
+    uint16_t groups[8];
+    for (int i = 0; i < 4; ++i) {
+        groups[i] = static_cast<uint16_t>(high_ >> (48 - 16 * i));
+        groups[4 + i] = static_cast<uint16_t>(low_ >> (48 - 16 * i));
+    }
+    // Longest run of two or more zero groups becomes "::"
+    int best = -1, best_length = 1;
+    for (int i = 0; i < 8;) {
+        int j = i;
+        while (j < 8 && groups[j] == 0) ++j;
+        if (j - i > best_length) {
+            best = i;
+            best_length = j - i;
+        }
+        i = j == i ? i + 1 : j;
+    }
+    std::string text;
+    for (int i = 0; i < 8; ++i) {
+        if (i == best) {
+            text += "::";
+            i += best_length - 1;
+            continue;
+        }
+        if (!text.empty() && text.back() != ':') text += ':';
+        std::snprintf(buffer, sizeof(buffer), "%x", groups[i]);
+        text += buffer;
+    }
+    return text;
+}
+
+Cidr::Cidr(IpAddress network, unsigned prefix) : prefix_(prefix) {
+    if (network.isV4()) {
+        if (prefix > 32) throw ParseException("CIDR prefix out of range: " + std::to_string(prefix));
+        network_ = IpAddress::v4(network.v4Bits() & v4Mask(prefix));
+    } else {
+        if (prefix > 128) throw ParseException("CIDR prefix out of range: " + std::to_string(prefix));
+        network_ = IpAddress::v6(network.high() & v6HalfMask(prefix, 0), network.low() & v6HalfMask(prefix, 64));
+    }
+}
+
+bool Cidr::parse(std::string_view text, Cidr& out) {
+    const std::size_t slash = text.find('/');
+    IpAddress address;
+    if (!IpAddress::parse(text.substr(0, slash), address)) return false;
+    unsigned prefix = address.isV4() ? 32 : 128;
+    if (slash != std::string_view::npos) {
+        const std::string_view digits = text.substr(slash + 1);
+        const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), prefix);
+        if (digits.empty() || ec != std::errc() || ptr != digits.data() + digits.size() ||
+            prefix > (address.isV4() ? 32u : 128u)) {
+            return false;
+        }
+    }
+    out = Cidr(address, prefix);
+    return true;
+}
+
+Cidr Cidr::fromString(std::string_view text) {
+    Cidr cidr;
+    if (!parse(text, cidr)) {
+        throw ParseException("Invalid CIDR: " + std::string(text));
+    }
+    return cidr;
+}
+
+IpAddress Cidr::last() const {
+    if (network_.isV4()) {
+        return IpAddress::v4(network_.v4Bits() | ~v4Mask(prefix_));
+    }
+    return IpAddress::v6(network_.high() | ~v6HalfMask(prefix_, 0), network_.low() | ~v6HalfMask(prefix_, 64));
+}
+
+bool Cidr::contains(const IpAddress& address) const {
+    if (address.family() != network_.family()) {
+        return false;
+    }
+    if (address.isV4()) {
+        return (address.v4Bits() & v4Mask(prefix_)) == network_.v4Bits();
+    }
+    return (address.high() & v6HalfMask(prefix_, 0)) == network_.high() &&
+           (address.low() & v6HalfMask(prefix_, 64)) == network_.low();
+}
+
+std::string Cidr::str() const {
+    return network_.str() + "/" + std::to_string(prefix_);
+}
@@ -0,0 +1,73 @@
+#include "key_path.h"
+#include <algorithm>
+
+namespace {
+
+bool allDigits(const std::string& s) {
+    return !s.empty() && s.size() <= 9 && std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+} // namespace
+
+KeyPath::KeyPath(const std::string& path)
+    : path_(path),
+      flat_hint_(std::make_unique<std::atomic<uint32_t>>(0)) {
+    std::size_t begin = 0;
+    while (true) {
+        const std::size_t dot = path.find('.', begin);
+        Segment segment;
+        segment.name = path.substr(begin, dot == std::string::npos ? std::string::npos : dot - begin);
+        // The first segment always names a key; later digit-only ones index lists
+        if (!segments_.empty() && allDigits(segment.name)) {
+            segment.is_position = true;
+            segment.position = static_cast<uint32_t>(std::stoul(segment.name));
+        } else {
+            segment.hint = std::make_unique<std::atomic<uint32_t>>(0);
+        }
+        segments_.push_back(std::move(segment));
+        if (dot == std::string::npos) {
+            break;
+        }
+        begin = dot + 1;
+    }
+}
+
+const Key* KeyPath::findField(const std::vector<Key>& keys, const std::string& name, std::atomic<uint32_t>& hint) {
+    const uint32_t guess = hint.load(std::memory_order_relaxed);
+    if (guess < keys.size() && keys[guess].getName() == name) {
+        return &keys[guess];
+    }
+    auto it = std::find_if(keys.begin(), keys.end(), [&name](const Key& k) { return k.getName() == name; });
+    if (it == keys.end()) {
+        return nullptr;
+    }
+    // Only reached when the position moved, so records with a stable field
+    // order never write the shared hint
+    hint.store(static_cast<uint32_t>(it - keys.begin()), std::memory_order_relaxed);
+    return &*it;
+}
+
+const Key* KeyPath::findNested(const std::vector<Key>& keys) const {
+    const Key* current = findField(keys, segments_[0].name, *segments_[0].hint);
+    for (std::size_t i = 1; current && i < segments_.size(); ++i) {
+        const Segment& segment = segments_[i];
+        const std::vector<Key>& children = current->children();
+        if (segment.is_position) {
+            current = current->isList() && segment.position < children.size() ? &children[segment.position] : nullptr;
+        } else {
+            current = current->isObject() ? findField(children, segment.name, *segment.hint) : nullptr;
+        }
+    }
+    return current;
+}
+
+const Key* KeyPath::find(const std::vector<Key>& keys) const {
+    if (!isNested()) {
+        return findField(keys, path_, *segments_[0].hint);
+    }
+    // Fixed precedence, so a record's result never depends on earlier records
+    if (const Key* key = findNested(keys)) {
+        return key;
+    }
+    return findField(keys, path_, *flat_hint_);
+}
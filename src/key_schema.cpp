@@ -0,0 +1,63 @@
+#include "key_schema.h"
+#include "key_path.h"
+#include "parser.h"
+#include <algorithm>
+
+KeySchema::KeySchema(std::vector<std::string> names) : names_(std::move(names)) {
+    if (names_.size() > kMaxKeys) {
+        throw ParseException("Key schema holds at most 64 keys: " + std::to_string(names_.size()));
+    }
+    for (std::size_t i = 0; i < names_.size(); ++i) {
+        if (std::find(names_.begin(), names_.begin() + i, names_[i]) != names_.begin() + i) {
+            throw ParseException("Duplicate key in schema: " + names_[i]);
+        }
+        paths_.push_back(std::make_unique<KeyPath>(names_[i]));
+    }
+}
+
+KeySchema::~KeySchema() = default;
+KeySchema::KeySchema(KeySchema&&) noexcept = default;
+KeySchema& KeySchema::operator=(KeySchema&&) noexcept = default;
+
+uint64_t KeySchema::bit(const std::string& name) const {
+    auto it = std::find(names_.begin(), names_.end(), name);
+    return it == names_.end() ? 0 : uint64_t{1} << (it - names_.begin());
+}
+
+uint64_t KeySchema::presence(const std::vector<Key>& keys) const {
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < paths_.size(); ++i) {
+        mask |= static_cast<uint64_t>(paths_[i]->find(keys) != nullptr) << i;
+    }
+    return mask;
+}
+
+PresenceRule KeySchema::rule(const FilterCondition& condition) const {
+    const auto& subs = condition.sub_expressions;
+    PresenceRule rule;
+    for (std::size_t i = LanguageParser::requiredClauses(condition); i < subs.size(); ++i) {
+        const Expression& expr = subs[i].expr;
+        auto require = [&](const std::string& key) { rule.required |= bit(key); };
+        if (const auto* u = std::get_if<UnaryExpression>(&expr)) {
+            require(u->key);
+        } else if (const auto* b = std::get_if<BinaryExpression>(&expr)) {
+            require(b->left_key);
+            require(b->right_key);
+        } else if (const auto* l = std::get_if<ListExpression>(&expr)) {
+            require(l->key);
+        } else if (const auto* c = std::get_if<CidrExpression>(&expr)) {
+            require(c->key);
+        } else if (const auto* g = std::get_if<GeoExpression>(&expr)) {
+            require(g->lat_key);
+            require(g->lon_key);
+        } else if (const auto* m = std::get_if<BitmaskExpression>(&expr)) {
+            require(m->key);
+        } else if (const auto* s = std::get_if<SampleExpression>(&expr)) {
+            require(s->key);
+        } else if (const auto* e = std::get_if<ExistsExpression>(&expr)) {
+            (e->exists ? rule.required : rule.forbidden) |= bit(e->key);
+        }
+        // A threshold needs only some of its children: nothing is required
+    }
+    return rule;
+}
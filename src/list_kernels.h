@@ -0,0 +1,168 @@
+#pragma once
+
+#include "comparison.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Kernels for list predicates over packed Key::array values. Each chunk is
+// scanned without branches so numeric arrays vectorize; the early exit is
+// taken between chunks.
+
+constexpr std::size_t kListChunk = 32;
+
+// Constant sets up to this size are scanned once per constant; larger ones
+// are hashed and probed once per element
+constexpr std::size_t kScanSetLimit = 8;
+
+// CONTAINS always scans arrays up to this size
+constexpr std::size_t kScanArrayLimit = 32;
+
+// Strings are probed through views so neither side is copied
+template <typename T>
+using ListProbe = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+
+template <typename T, typename Pred>
+bool anyElement(const std::vector<T>& a, Pred pred) {
+    const std::size_t n = a.size();
+    for (std::size_t begin = 0; begin < n; begin += kListChunk) {
+        const std::size_t end = std::min(n, begin + kListChunk);
+        bool hit = false;
+        for (std::size_t i = begin; i < end; ++i) hit |= pred(a[i]);
+        if (hit) return true;
+    }
+    return false;
+}
+
+template <typename T, typename Pred>
+bool allElements(const std::vector<T>& a, Pred pred) {
+    return !anyElement(a, [&pred](const T& x) { return !pred(x); });
+}
+
+// The constants of a list clause of element type T
+template <typename T>
+class ListValueSet {
+public:
+    explicit ListValueSet(std::vector<T> values) : values_(std::move(values)) {
+        if (values_.size() > kScanSetLimit) {
+            for (const T& v : values_) {
+                hashed_.emplace(ListProbe<T>(v), static_cast<uint32_t>(hashed_.size()));
+            }
+        }
+    }
+    ListValueSet(const ListValueSet&) = delete; // hashed_ may view into values_
+    ListValueSet& operator=(const ListValueSet&) = delete;
+
+    const std::vector<T>& values() const { return values_; }
+    bool isHashed() const { return !hashed_.empty(); }
+
+    // Hashed sets only: index of x among the distinct values, or -1
+    int64_t find(const T& x) const {
+        const auto it = hashed_.find(ListProbe<T>(x));
+        return it == hashed_.end() ? -1 : static_cast<int64_t>(it->second);
+    }
+    std::size_t distinct() const { return hashed_.size(); }
+
+    // Whether `a` has an element equal to one of the values
+    bool anyIn(const std::vector<T>& a) const {
+        if (isHashed()) {
+            return anyElement(a, [this](const T& x) { return hashed_.count(ListProbe<T>(x)) != 0; });
+        }
+        return std::any_of(values_.begin(), values_.end(),
+                           [&a](const T& v) { return anyElement(a, [&v](const T& x) { return x == v; }); });
+    }
+
+    // Whether every element of `a` equals one of the values
+    bool allIn(const std::vector<T>& a) const {
+        if (isHashed()) {
+            return allElements(a, [this](const T& x) { return hashed_.count(ListProbe<T>(x)) != 0; });
+        }
+        // Per chunk, one branch-free pass per constant marks the members
+        uint8_t in[kListChunk];
+        for (std::size_t begin = 0; begin < a.size(); begin += kListChunk) {
+            const std::size_t len = std::min(a.size() - begin, kListChunk);
+            std::fill(in, in + len, uint8_t{0});
+            for (const T& v : values_) {
+                for (std::size_t i = 0; i < len; ++i) in[i] |= a[begin + i] == v;
+            }
+            uint8_t all = 1;
+            for (std::size_t i = 0; i < len; ++i) all &= in[i];
+            if (!all) return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<T> values_;
+    std::unordered_map<ListProbe<T>, uint32_t> hashed_; // distinct value -> index
+};
+
+template <typename T, typename Pred>
+bool quantify(ListQuantifier quantifier, const std::vector<T>& a, Pred pred) {
+    return quantifier == ListQuantifier::ANY ? anyElement(a, pred) : allElements(a, pred);
+}
+
+// ANY / ALL. Membership runs as whole-array passes (see ListValueSet);
+// ordered operators compare with the single value, the switch kept outside
+// the scan.
+template <typename T>
+bool quantifyArray(ListQuantifier quantifier, ComparisonOperations op, const std::vector<T>& a,
+                   const ListValueSet<T>& set) {
+    const bool any = quantifier == ListQuantifier::ANY;
+    const T& c = set.values().front();
+    switch (op) {
+        case ComparisonOperations::EQUAL:
+            return any ? set.anyIn(a) : set.allIn(a);
+        case ComparisonOperations::NOT_EQUAL: // ANY x not in S == !ALL x in S
+            return any ? !set.allIn(a) : !set.anyIn(a);
+        case ComparisonOperations::GREATER_THAN:
+            return quantify(quantifier, a, [&c](const T& x) { return x > c; });
+        case ComparisonOperations::LESS_THAN:
+            return quantify(quantifier, a, [&c](const T& x) { return x < c; });
+        case ComparisonOperations::GREATER_EQUAL:
+            return quantify(quantifier, a, [&c](const T& x) { return x >= c; });
+        case ComparisonOperations::LESS_EQUAL:
+            return quantify(quantifier, a, [&c](const T& x) { return x <= c; });
+        default: throw ParseException("Unsupported comparison operation");
+    }
+}
+
+// Whether `a` holds every value of `set`. Small sets or arrays scan `a` once
+// per value; otherwise each element probes the hashed set and the distinct
+// values seen are counted, stopping once all have been found.
+template <typename T>
+bool containsAll(const std::vector<T>& a, const ListValueSet<T>& set) {
+    const auto& wanted = set.values();
+    if (!set.isHashed() || a.size() <= kScanArrayLimit) {
+        return std::all_of(wanted.begin(), wanted.end(), [&a](const T& v) {
+            return anyElement(a, [&v](const T& x) { return x == v; });
+        });
+    }
+    if (a.size() < set.distinct()) {
+        return false;
+    }
+    std::vector<uint8_t> seen(set.distinct());
+    std::size_t found = 0;
+    for (const T& x : a) {
+        const int64_t i = set.find(x);
+        if (i >= 0 && !seen[i]) {
+            seen[i] = 1;
+            if (++found == seen.size()) return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+bool matchArray(ListQuantifier quantifier, ComparisonOperations op, const std::vector<T>& a,
+                const ListValueSet<T>& set) {
+    if (quantifier == ListQuantifier::CONTAINS) {
+        return containsAll(a, set);
+    }
+    return quantifyArray(quantifier, op, a, set);
+}
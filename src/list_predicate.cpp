@@ -0,0 +1,134 @@
+#include "parser.h"
+#include "comparison.h"
+#include "key_path.h"
+#include "list_kernels.h"
+#include "probes.h"
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// A ListExpression checked and converted once at compile time. Only the set
+// matching the constants' type is built; bool constants only apply to
+// Key::list elements.
+struct ListConstants {
+    ListQuantifier quantifier;
+    ComparisonOperations op;
+    DataTypes type;
+    std::vector<ValueType> values;
+    std::unique_ptr<ListValueSet<int64_t>> integers;
+    std::unique_ptr<ListValueSet<double>> doubles;
+    std::unique_ptr<ListValueSet<std::string>> strings;
+};
+
+template <typename T>
+std::unique_ptr<ListValueSet<T>> makeValueSet(const std::vector<ValueType>& values) {
+    std::vector<T> typed;
+    typed.reserve(values.size());
+    for (const auto& value : values) {
+        typed.push_back(std::get<T>(value));
+    }
+    return std::make_unique<ListValueSet<T>>(std::move(typed));
+}
+
+std::shared_ptr<const ListConstants> makeConstants(const ListExpression& expr) {
+    if (expr.values.empty()) {
+        throw ParseException("List predicate requires at least one value: " + expr.key);
+    }
+    auto constants = std::make_shared<ListConstants>();
+    constants->quantifier = expr.quantifier;
+    constants->op = expr.quantifier == ListQuantifier::CONTAINS ? ComparisonOperations::EQUAL : expr.op;
+    constants->type = valueDataType(expr.values.front());
+    constants->values = expr.values;
+    for (const auto& value : expr.values) {
+        if (valueDataType(value) != constants->type) {
+            throw ParseException("List predicate values must share one type: " + expr.key);
+        }
+    }
+    if (!isEqualityComparison(constants->op)) {
+        if (expr.values.size() != 1) {
+            throw ParseException("Ordered list comparison takes exactly one value: " + expr.key);
+        }
+        if (constants->type == DataTypes::BOOLEAN) {
+            throw ParseException("Unsupported comparison operation for boolean");
+        }
+    }
+    switch (constants->type) {
+        case DataTypes::INTEGER: constants->integers = makeValueSet<int64_t>(expr.values); break;
+        case DataTypes::DOUBLE: constants->doubles = makeValueSet<double>(expr.values); break;
+        case DataTypes::STRING: constants->strings = makeValueSet<std::string>(expr.values); break;
+        default: break;
+    }
+    return constants;
+}
+
+template <typename T>
+bool matchTyped(const std::vector<T>& a, const ListConstants& c, const ListValueSet<T>* set) {
+    if (!set) {
+        throw ParseException("Comparison requires operands of the same type");
+    }
+    return matchArray(c.quantifier, c.op, a, *set);
+}
+
+bool matchPacked(const ArrayValue& array, const ListConstants& c) {
+    if (const auto* a = std::get_if<std::vector<int64_t>>(&array)) {
+        return matchTyped(*a, c, c.integers.get());
+    } else if (const auto* a = std::get_if<std::vector<double>>(&array)) {
+        return matchTyped(*a, c, c.doubles.get());
+    }
+    return matchTyped(std::get<std::vector<std::string>>(array), c, c.strings.get());
+}
+
+} // namespace
+
+KeyPredicate LanguageParser::compileListClause(const ListExpression& expr) {
+    return [c = makeConstants(expr), path = std::make_shared<const KeyPath>(expr.key)](const std::vector<Key>& keys) {
+        const Key* list = path->find(keys);
+        if (!list) {
+            EXPR_EVAL_PROBE1(key_missing, EXPR_EVAL_PROBE_PTR(path->str().c_str()));
+            throw ParseException("Key not found: " + path->str());
+        }
+        if (const ArrayValue* array = list->array()) {
+            return matchPacked(*array, *c);
+        }
+        if (!list->isList()) {
+            throw ParseException("Key is not a list: " + path->str());
+        }
+
+        // Key::list elements are compared one by one, like scalar keys
+        const std::vector<Key>& elements = list->children();
+        auto valueOf = [&](const Key& element, ValueType& parsed) -> const ValueType& {
+            if (!element.isScalar()) {
+                throw ParseException("List element is not a scalar: " + path->str());
+            }
+            if (element.isText() && isNumeric(c->type)) {
+                return parsed = textAsNumber(element, c->type);
+            }
+            return element.getValue();
+        };
+        auto elementMatches = [&](const Key& element) {
+            ValueType parsed;
+            const ValueType& value = valueOf(element, parsed);
+            auto equals = [&value](const ValueType& v) {
+                return evaluateComparison(value, ComparisonOperations::EQUAL, v);
+            };
+            switch (c->op) {
+                case ComparisonOperations::EQUAL: return std::any_of(c->values.begin(), c->values.end(), equals);
+                case ComparisonOperations::NOT_EQUAL: return std::none_of(c->values.begin(), c->values.end(), equals);
+                default: return evaluateComparison(value, c->op, c->values.front());
+            }
+        };
+        switch (c->quantifier) {
+            case ListQuantifier::ANY: return std::any_of(elements.begin(), elements.end(), elementMatches);
+            case ListQuantifier::ALL: return std::all_of(elements.begin(), elements.end(), elementMatches);
+            case ListQuantifier::CONTAINS:
+                return std::all_of(c->values.begin(), c->values.end(), [&](const ValueType& wanted) {
+                    return std::any_of(elements.begin(), elements.end(), [&](const Key& element) {
+                        ValueType parsed;
+                        return evaluateComparison(valueOf(element, parsed), ComparisonOperations::EQUAL, wanted);
+                    });
+                });
+            default: throw ParseException("Unsupported list quantifier");
+        }
+    };
+}
@@ -0,0 +1,81 @@
+#include "match_view.h"
+#include "key_path.h"
+#include <utility>
+
+std::vector<const Key*> RecordMatches::project(const std::string& path) const {
+    const KeyPath key(path); // position hints carry over between records
+    std::vector<const Key*> values;
+    values.reserve(indices_.size());
+    for (std::size_t i : indices_) {
+        values.push_back(key.find((*records_)[i]));
+    }
+    return values;
+}
+
+std::vector<std::vector<Key>> RecordMatches::materialize() const {
+    std::vector<std::vector<Key>> copies;
+    copies.reserve(indices_.size());
+    for (std::size_t i : indices_) {
+        copies.push_back((*records_)[i]);
+    }
+    return copies;
+}
+
+RecordMatches matchRecords(const KeyPredicate& predicate, const std::vector<std::vector<Key>>& records,
+                           const ScanOptions& options) {
+    return RecordMatches(records, scanMatches(predicate, records, options));
+}
+
+std::size_t partitionMatches(const KeyPredicate& predicate, std::vector<std::vector<Key>>& records) {
+    // Swapping moves three pointers per record; matches fill the front in
+    // order while the rest shift back
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (predicate(records[i])) {
+            if (i != kept) {
+                std::swap(records[kept], records[i]);
+            }
+            ++kept;
+        }
+    }
+    return kept;
+}
+
+const ColumnView& BatchMatches::column(const std::string& name) const {
+    const ColumnView* column = batch_->find(name);
+    if (!column) {
+        throw ParseException("Key not found: " + name);
+    }
+    return *column;
+}
+
+void BatchMatches::gather(const std::string& name, ProjectedColumn& out) const {
+    const ColumnView& source = column(name);
+    const std::size_t n = rows_.size();
+    out.type = source.type;
+    out.ints.clear();
+    out.doubles.clear();
+    out.validity.clear();
+    switch (source.type) {
+        case DataTypes::INTEGER:
+            out.ints.resize(n);
+            for (std::size_t k = 0; k < n; ++k) out.ints[k] = source.int64At(rows_[k]);
+            break;
+        case DataTypes::DOUBLE:
+            out.doubles.resize(n);
+            for (std::size_t k = 0; k < n; ++k) out.doubles[k] = source.doubleAt(rows_[k]);
+            break;
+        default:
+            throw ParseException("Only INTEGER and DOUBLE columns can be gathered: " + name);
+    }
+    if (source.validity) {
+        out.validity.assign((n + 7) / 8, 0);
+        for (std::size_t k = 0; k < n; ++k) {
+            out.validity[k >> 3] |= static_cast<uint8_t>(source.isValid(rows_[k]) << (k & 7));
+        }
+    }
+}
+
+BatchMatches matchRows(const BatchEvaluator& evaluator, const ColumnBatch& batch) {
+    return BatchMatches(batch, evaluator.select(batch));
+}
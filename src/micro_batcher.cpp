@@ -0,0 +1,114 @@
+#include "micro_batcher.h"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+// Checked before the worker starts: a zero max_batch would take empty batches forever
+MicroBatchOptions validated(MicroBatchOptions options) {
+    if (options.max_batch == 0) {
+        throw ParseException("max_batch must be at least 1");
+    }
+    return options;
+}
+
+} // namespace
+
+MicroBatchEvaluator::MicroBatchEvaluator(MicroBatchOptions options)
+    : options_(validated(options)), worker_([this] { run(); }) {}
+
+MicroBatchEvaluator::~MicroBatchEvaluator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+void MicroBatchEvaluator::initialize(const FilterCondition& condition) {
+    auto plan = std::make_shared<const KeyPredicate>(LanguageParser::parse(condition));
+    std::lock_guard<std::mutex> lock(mutex_);
+    plan_ = std::move(plan);
+}
+
+std::future<bool> MicroBatchEvaluator::submit(const std::vector<Key>& keys) {
+    Pending pending{&keys, std::promise<bool>()};
+    std::future<bool> future = pending.result.get_future();
+    bool first = false;
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!plan_) {
+            throw std::bad_function_call(); // same as an uninitialized Evaluator
+        }
+        first = queue_.empty();
+        if (first) {
+            oldest_ = std::chrono::steady_clock::now();
+        }
+        queue_.push_back(std::move(pending));
+        full = queue_.size() >= options_.max_batch;
+    }
+    // The worker only needs waking to start a batch timer or to close a full batch
+    if (first || full) {
+        wake_.notify_one();
+    }
+    return future;
+}
+
+MicroBatchEvaluator::Stats MicroBatchEvaluator::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MicroBatchEvaluator::run() {
+    std::vector<Pending> batch;
+    std::vector<uint8_t> results;
+    std::vector<std::exception_ptr> errors;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return; // stopping, nothing left to complete
+        }
+        if (!stop_) {
+            wake_.wait_until(lock, oldest_ + options_.max_wait,
+                             [this] { return stop_ || queue_.size() >= options_.max_batch; });
+        }
+
+        // Take at most max_batch calls. Leftovers keep the old timestamp, which
+        // is no later than their own arrival, so they never wait past max_wait.
+        const std::size_t n = std::min(queue_.size(), options_.max_batch);
+        batch.clear();
+        std::move(queue_.begin(), queue_.begin() + n, std::back_inserter(batch));
+        queue_.erase(queue_.begin(), queue_.begin() + n);
+        std::shared_ptr<const KeyPredicate> plan = plan_;
+        ++stats_.batches;
+        stats_.records += n;
+        lock.unlock();
+
+        // Evaluate the whole batch first, then wake the callers
+        const KeyPredicate& predicate = *plan;
+        results.assign(n, 0);
+        errors.assign(n, nullptr);
+        for (std::size_t i = 0; i < n; ++i) {
+            try {
+                results[i] = predicate(*batch[i].keys);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (errors[i]) {
+                batch[i].result.set_exception(errors[i]);
+            } else {
+                batch[i].result.set_value(results[i] != 0);
+            }
+        }
+
+        lock.lock();
+    }
+}
@@ -1,47 +1,112 @@
 #include "parser.h"
+#include "comparison.h"
+#include "key_path.h"
+#include "probes.h"
 #include <stdexcept>
 #include <algorithm>
 #include <iostream>
 #include <functional>
 
 std::function<bool(const std::vector<Key>&)> LanguageParser::parse(const FilterCondition& condition) {
-    return [condition](const std::vector<Key>& keys) -> bool {
-        bool result = true; // Default to true for AND operations
-        for (const auto& subExpr : condition.sub_expressions) {
-            bool subResult = false;
-            if (std::holds_alternative<UnaryExpression>(subExpr.expr)) {
-                const auto& expr = std::get<UnaryExpression>(subExpr.expr);
-                ValueType keyValue = getValueFromKey(keys, expr.key);
-                subResult = evaluateComparison(keyValue, expr.op, expr.value);
-            } else if (std::holds_alternative<BinaryExpression>(subExpr.expr)) {
-                const auto& expr = std::get<BinaryExpression>(subExpr.expr);
-                ValueType leftValue = getValueFromKey(keys, expr.left_key);
-                ValueType rightValue = getValueFromKey(keys, expr.right_key);
-                ValueType arithResult = evaluateArithmetic(leftValue, expr.arith_op, rightValue);
-                subResult = evaluateComparison(arithResult, expr.comp_op, expr.value);
-            } else {
-                throw ParseException("Unknown expression type");
-            }
+    return fold(std::make_shared<const std::vector<CompiledClause>>(compile(condition)));
+}
 
-            // Combine with previous results using the logical operator
-            switch (subExpr.prev_logical_op) {
-                case LogicalOperations::AND:
-                    result = result && subResult;
-                    break;
-                case LogicalOperations::OR:
-                    result = result || subResult;
-                    break;
-                case LogicalOperations::NONE:
-                    result = subResult; // For the first expression
-                    break;
-                default:
-                    throw ParseException("Unsupported logical operation");
+std::function<bool(const std::vector<Key>&)> LanguageParser::fold(
+    std::shared_ptr<const std::vector<CompiledClause>> clauses) {
+    return [clauses = std::move(clauses)](const std::vector<Key>& keys) -> bool {
+        bool result = true; // Default to true for AND operations
+        for (const auto& clause : *clauses) {
+            if (!needsClause(result, clause.prev_logical_op)) {
+                continue; // cannot change the result
             }
+            result = combine(result, clause.prev_logical_op, clause.predicate(keys));
         }
         return result;
     };
 }
 
+std::vector<CompiledClause> LanguageParser::compile(const FilterCondition& condition) {
+    std::vector<CompiledClause> clauses;
+    clauses.reserve(condition.sub_expressions.size());
+    for (const auto& subExpr : condition.sub_expressions) {
+        clauses.push_back(CompiledClause{compileClause(subExpr), subExpr.prev_logical_op});
+    }
+    return clauses;
+}
+
+KeyProjection LanguageParser::project(const ArithmeticExpression& expr) {
+    return [op = expr.arith_op, left = std::make_shared<const KeyPath>(expr.left_key),
+            right = std::make_shared<const KeyPath>(expr.right_key)](const std::vector<Key>& keys) {
+        return evaluateArithmetic(arithmeticOperand(findKey(keys, *left)), op,
+                                  arithmeticOperand(findKey(keys, *right)));
+    };
+}
+
+KeyPredicate LanguageParser::compileClause(const SubExpression& subExpr) {
+    if (std::holds_alternative<UnaryExpression>(subExpr.expr)) {
+        const auto& unary = std::get<UnaryExpression>(subExpr.expr);
+        return [expr = unary, wanted = valueDataType(unary.value),
+                path = std::make_shared<const KeyPath>(unary.key)](const std::vector<Key>& keys) {
+            const Key& key = findKey(keys, *path);
+            if (key.isText() && isNumeric(wanted)) {
+                return evaluateComparison(textAsNumber(key, wanted), expr.op, expr.value);
+            }
+            if (key.isText() && wanted == DataTypes::IP_ADDRESS) {
+                return evaluateComparison(textAsAddress(key), expr.op, expr.value);
+            }
+            return evaluateComparison(key.getValue(), expr.op, expr.value);
+        };
+    } else if (std::holds_alternative<BinaryExpression>(subExpr.expr)) {
+        const auto& binary = std::get<BinaryExpression>(subExpr.expr);
+        return [expr = binary, left = std::make_shared<const KeyPath>(binary.left_key),
+                right = std::make_shared<const KeyPath>(binary.right_key)](const std::vector<Key>& keys) {
+            ValueType leftValue = arithmeticOperand(findKey(keys, *left));
+            ValueType rightValue = arithmeticOperand(findKey(keys, *right));
+            ValueType arithResult = evaluateArithmetic(leftValue, expr.arith_op, rightValue);
+            return evaluateComparison(arithResult, expr.comp_op, expr.value);
+        };
+    } else if (const auto* list = std::get_if<ListExpression>(&subExpr.expr)) {
+        return compileListClause(*list);
+    } else if (const auto* cidr = std::get_if<CidrExpression>(&subExpr.expr)) {
+        return compileCidrClause(*cidr);
+    } else if (const auto* geo = std::get_if<GeoExpression>(&subExpr.expr)) {
+        return compileGeoClause(*geo);
+    } else if (const auto* bitmask = std::get_if<BitmaskExpression>(&subExpr.expr)) {
+        return compileBitmaskClause(*bitmask);
+    } else if (const auto* sample = std::get_if<SampleExpression>(&subExpr.expr)) {
+        return compileSampleClause(*sample);
+    } else if (const auto* threshold = std::get_if<ThresholdExpression>(&subExpr.expr)) {
+        return compileThresholdClause(*threshold);
+    } else if (const auto* exists = std::get_if<ExistsExpression>(&subExpr.expr)) {
+        return [want = exists->exists, path = std::make_shared<const KeyPath>(exists->key)](
+                   const std::vector<Key>& keys) { return (path->find(keys) != nullptr) == want; };
+    } else {
+        throw ParseException("Unknown expression type");
+    }
+}
+
+bool LanguageParser::combine(bool result, LogicalOperations op, bool subResult) {
+    // Combine with previous results using the logical operator
+    switch (op) {
+        case LogicalOperations::AND: return result && subResult;
+        case LogicalOperations::OR: return result || subResult;
+        case LogicalOperations::NONE: return subResult; // For the first expression
+        default: throw ParseException("Unsupported logical operation");
+    }
+}
+
+std::size_t LanguageParser::requiredClauses(const FilterCondition& condition) {
+    const auto& subs = condition.sub_expressions;
+    std::size_t begin = subs.size();
+    while (begin > 0 && subs[begin - 1].prev_logical_op == LogicalOperations::AND) {
+        --begin;
+    }
+    if (begin > 0 && subs[begin - 1].prev_logical_op == LogicalOperations::NONE) {
+        --begin; // the clause the run starts from
+    }
+    return begin;
+}
+
 ValueType LanguageParser::evaluateArithmetic(const ValueType& left, ArithmeticOperations op, const ValueType& right) {
     if (std::holds_alternative<int64_t>(left) && std::holds_alternative<int64_t>(right)) {
         int64_t l = std::get<int64_t>(left);
@@ -75,65 +140,63 @@ ValueType LanguageParser::evaluateArithmetic(const ValueType& left, ArithmeticOp
 
 bool LanguageParser::evaluateComparison(const ValueType& left, ComparisonOperations op, const ValueType& right) {
     if (left.index() != right.index()) {
+        EXPR_EVAL_PROBE2(type_mismatch, left.index(), right.index());
         throw ParseException("Comparison requires operands of the same type");
     }
 
     if (std::holds_alternative<int64_t>(left)) {
-        int64_t l = std::get<int64_t>(left);
-        int64_t r = std::get<int64_t>(right);
-        switch (op) {
-            case ComparisonOperations::EQUAL: return l == r;
-            case ComparisonOperations::NOT_EQUAL: return l != r;
-            case ComparisonOperations::GREATER_THAN: return l > r;
-            case ComparisonOperations::LESS_THAN: return l < r;
-            case ComparisonOperations::GREATER_EQUAL: return l >= r;
-            case ComparisonOperations::LESS_EQUAL: return l <= r;
-            default: throw ParseException("Unsupported comparison operation");
-        }
+        return compareOrdered(std::get<int64_t>(left), op, std::get<int64_t>(right));
     } else if (std::holds_alternative<double>(left)) {
-        double l = std::get<double>(left);
-        double r = std::get<double>(right);
-        switch (op) {
-            case ComparisonOperations::EQUAL: return l == r;
-            case ComparisonOperations::NOT_EQUAL: return l != r;
-            case ComparisonOperations::GREATER_THAN: return l > r;
-            case ComparisonOperations::LESS_THAN: return l < r;
-            case ComparisonOperations::GREATER_EQUAL: return l >= r;
-            case ComparisonOperations::LESS_EQUAL: return l <= r;
-            default: throw ParseException("Unsupported comparison operation");
-        }
+        return compareOrdered(std::get<double>(left), op, std::get<double>(right));
     } else if (std::holds_alternative<std::string>(left)) {
-        const std::string& l = std::get<std::string>(left);
-        const std::string& r = std::get<std::string>(right);
-        switch (op) {
-            case ComparisonOperations::EQUAL: return l == r;
-            case ComparisonOperations::NOT_EQUAL: return l != r;
-            case ComparisonOperations::GREATER_THAN: return l > r;
-            case ComparisonOperations::LESS_THAN: return l < r;
-            case ComparisonOperations::GREATER_EQUAL: return l >= r;
-            case ComparisonOperations::LESS_EQUAL: return l <= r;
-            default: throw ParseException("Unsupported comparison operation");
-        }
+        return compareOrdered(std::get<std::string>(left), op, std::get<std::string>(right));
     } else if (std::holds_alternative<bool>(left)) {
-        bool l = std::get<bool>(left);
-        bool r = std::get<bool>(right);
-        switch (op) {
-            case ComparisonOperations::EQUAL: return l == r;
-            case ComparisonOperations::NOT_EQUAL: return l != r;
-            default: throw ParseException("Unsupported comparison operation for boolean");
-        }
+        return compareBool(std::get<bool>(left), op, std::get<bool>(right));
+    } else if (std::holds_alternative<IpAddress>(left)) {
+        return compareOrdered(std::get<IpAddress>(left), op, std::get<IpAddress>(right));
     } else {
         throw ParseException("Unsupported type for comparison");
     }
 }
 
-ValueType LanguageParser::getValueFromKey(const std::vector<Key>& keys, const std::string& keyName) {
-    auto it = std::find_if(keys.begin(), keys.end(), [&keyName](const Key& k) { return k.getName() == keyName; });
-    if (it != keys.end()) {
-        return it->getValue();
-    } else {
-        throw ParseException("Key not found: " + keyName);
+const Key& LanguageParser::findKey(const std::vector<Key>& keys, const KeyPath& path) {
+    const Key* key = path.find(keys);
+    if (!key) {
+        EXPR_EVAL_PROBE1(key_missing, EXPR_EVAL_PROBE_PTR(path.str().c_str()));
+        throw ParseException("Key not found: " + path.str());
+    }
+    if (!key->isScalar()) {
+        throw ParseException("Key is not a scalar: " + path.str());
+    }
+    return *key;
+}
+
+ValueType LanguageParser::textAsNumber(const Key& key, DataTypes type) {
+    ValueType number;
+    if (!key.parseNumber(type, number)) {
+        throw ParseException("Cannot convert text to " +
+                             std::string(type == DataTypes::INTEGER ? "integer" : "double") + ": " + key.getName());
+    }
+    return number;
+}
+
+IpAddress LanguageParser::textAsAddress(const Key& key) {
+    IpAddress address;
+    if (!IpAddress::parse(std::get<std::string>(key.getValue()), address)) {
+        throw ParseException("Cannot convert text to IP address: " + key.getName());
+    }
+    return address;
+}
+
+ValueType LanguageParser::arithmeticOperand(const Key& key) {
+    if (!key.isText()) {
+        return key.getValue();
+    }
+    ValueType number;
+    if (!key.parseAnyNumber(number)) {
+        throw ParseException("Cannot convert text to number: " + key.getName());
     }
+    return number;
 }
 
 bool LanguageParser::evaluateLogical(bool left, LogicalOperations op, bool right) {
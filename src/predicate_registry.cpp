@@ -0,0 +1,115 @@
+#include "predicate_registry.h"
+#include "clause_stats.h"
+#include <algorithm>
+
+namespace {
+
+// States of a predicate for the current record
+constexpr uint8_t kUnknown = 0;
+constexpr uint8_t kFalse = 1;
+constexpr uint8_t kTrue = 2;
+constexpr uint8_t kFailed = 3;
+
+SubExpression single(const Expression& expr) {
+    return SubExpression{expr, LogicalOperations::NONE};
+}
+
+// Clauses that are shared when equal; the rest hold containers (lists,
+// regions, children) that are rarely repeated verbatim
+bool samePredicate(const Expression& a, const Expression& b) {
+    if (a.index() != b.index()) {
+        return false;
+    }
+    if (const auto* u = std::get_if<UnaryExpression>(&a)) {
+        const auto& v = std::get<UnaryExpression>(b);
+        return u->op == v.op && u->key == v.key && u->value == v.value;
+    }
+    if (const auto* l = std::get_if<BinaryExpression>(&a)) {
+        const auto& r = std::get<BinaryExpression>(b);
+        return l->left_key == r.left_key && l->arith_op == r.arith_op && l->right_key == r.right_key &&
+               l->comp_op == r.comp_op && l->value == r.value;
+    }
+    if (const auto* e = std::get_if<ExistsExpression>(&a)) {
+        const auto& f = std::get<ExistsExpression>(b);
+        return e->key == f.key && e->exists == f.exists;
+    }
+    return false;
+}
+
+} // namespace
+
+uint32_t PredicateRegistry::intern(const Expression& expr) {
+    const uint64_t fingerprint = conditionFingerprint(FilterCondition{{single(expr)}});
+    std::vector<uint32_t>& bucket = by_fingerprint_[fingerprint];
+    for (uint32_t id : bucket) {
+        if (samePredicate(expressions_[id], expr)) {
+            return id;
+        }
+    }
+    const auto id = static_cast<uint32_t>(predicates_.size());
+    predicates_.push_back(LanguageParser::compile(FilterCondition{{single(expr)}})[0].predicate);
+    expressions_.push_back(expr);
+    bucket.push_back(id);
+    return id;
+}
+
+std::size_t PredicateRegistry::add(const FilterCondition& condition) {
+    for (const auto& subExpr : condition.sub_expressions) {
+        if (subExpr.prev_logical_op == LogicalOperations::NOT) {
+            throw ParseException("Unsupported logical operation");
+        }
+    }
+    for (const auto& subExpr : condition.sub_expressions) {
+        clauses_.push_back(Clause{intern(subExpr.expr), subExpr.prev_logical_op});
+    }
+    offsets_.push_back(clauses_.size());
+    states_.resize(predicates_.size());
+    return size() - 1;
+}
+
+void PredicateRegistry::evaluate(const std::vector<Key>& keys, std::vector<uint8_t>& matches) {
+    evaluateAll(keys, matches, nullptr);
+}
+
+void PredicateRegistry::evaluate(const std::vector<Key>& keys, std::vector<uint8_t>& matches,
+                                 std::vector<std::size_t>& failed) {
+    failed.clear();
+    evaluateAll(keys, matches, &failed);
+}
+
+void PredicateRegistry::evaluateAll(const std::vector<Key>& keys, std::vector<uint8_t>& matches,
+                                    std::vector<std::size_t>* failed) {
+    std::fill(states_.begin(), states_.end(), kUnknown);
+    uint8_t* states = states_.data();
+    const std::size_t conditions = size();
+    matches.resize(conditions);
+
+    for (std::size_t c = 0; c < conditions; ++c) {
+        bool result = true; // Default to true for AND operations
+        bool ok = true;
+        for (std::size_t i = offsets_[c]; i < offsets_[c + 1]; ++i) {
+            const Clause& clause = clauses_[i];
+            if (!LanguageParser::needsClause(result, clause.prev_logical_op)) {
+                continue; // cannot change the result
+            }
+            uint8_t& state = states[clause.predicate];
+            if (state == kUnknown) {
+                try {
+                    state = predicates_[clause.predicate](keys) ? kTrue : kFalse;
+                } catch (const ParseException&) {
+                    state = kFailed; // every condition that needs it fails too
+                }
+            }
+            if (state == kFailed) {
+                ok = false;
+                break;
+            }
+            // A needed AND / OR clause decides the result on its own
+            result = state == kTrue;
+        }
+        matches[c] = static_cast<uint8_t>(ok && result);
+        if (!ok && failed) {
+            failed->push_back(c);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "filter_structs.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Seeded 64-bit hashes for SampleExpression. The output depends only on the
+// seed and the value (integers by value, strings by their bytes, read in
+// little-endian order whatever the host), so every process keeps the same
+// records. Integers cost one mixing round; strings one round per 8 bytes.
+
+// splitmix64 finalizer: a bijection whose every output bit depends on every
+// input bit
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+inline uint64_t sampleHash(uint64_t mixed_seed, int64_t value) {
+    return mix64(static_cast<uint64_t>(value) ^ mixed_seed);
+}
+
+inline uint64_t sampleHash(uint64_t mixed_seed, std::string_view bytes) {
+    const auto* p = reinterpret_cast<const unsigned char*>(bytes.data());
+    const std::size_t n = bytes.size();
+    uint64_t h = mixed_seed ^ (n * 0x9e3779b97f4a7c15ull);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word = 0;
+        for (int b = 7; b >= 0; --b) word = word << 8 | p[i + b]; // compiles to one load
+        h = mix64(h ^ word);
+    }
+    uint64_t tail = 0;
+    for (std::size_t b = n; b > i; --b) tail = tail << 8 | p[b - 1];
+    return mix64(h ^ tail ^ 0xff51afd7ed558ccdull);
+}
+
+// A SampleExpression prepared once: a value is kept when the top 63 bits of
+// its hash fall below rate * 2^63 (so rate 1 keeps everything)
+struct SampleTest {
+    uint64_t mixed_seed;
+    uint64_t threshold;
+
+    // Throws ParseException unless 0 <= rate <= 1
+    static SampleTest compile(const SampleExpression& expr);
+
+    bool keeps(uint64_t hash) const { return (hash >> 1) < threshold; }
+    bool operator()(int64_t value) const { return keeps(sampleHash(mixed_seed, value)); }
+    bool operator()(std::string_view bytes) const { return keeps(sampleHash(mixed_seed, bytes)); }
+};
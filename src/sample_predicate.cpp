@@ -0,0 +1,30 @@
+#include "parser.h"
+#include "key_path.h"
+#include "sample_hash.h"
+#include <cmath>
+#include <memory>
+
+SampleTest SampleTest::compile(const SampleExpression& expr) {
+    if (!(expr.rate >= 0.0 && expr.rate <= 1.0)) {
+        throw ParseException("Sample rate must lie in [0, 1]: " + expr.key);
+    }
+    // 2^63 * rate, exact at both ends
+    const double scaled = std::ldexp(expr.rate, 63);
+    const uint64_t threshold = expr.rate == 1.0 ? uint64_t{1} << 63 : static_cast<uint64_t>(scaled);
+    return {mix64(expr.seed), threshold};
+}
+
+KeyPredicate LanguageParser::compileSampleClause(const SampleExpression& expr) {
+    return [test = SampleTest::compile(expr), path = std::make_shared<const KeyPath>(expr.key)](
+               const std::vector<Key>& keys) {
+        const Key& key = findKey(keys, *path);
+        const ValueType& value = key.getValue();
+        if (const auto* i = std::get_if<int64_t>(&value)) {
+            return test(*i);
+        }
+        if (const auto* s = std::get_if<std::string>(&value)) {
+            return test(std::string_view(*s));
+        }
+        throw ParseException("Sample predicates require integer or string keys: " + key.getName());
+    };
+}
@@ -0,0 +1,203 @@
+#include "scan.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+using Records = std::vector<std::vector<Key>>;
+
+std::vector<std::size_t> scanSequential(const KeyPredicate& predicate, const Records& records, std::size_t limit) {
+    std::vector<std::size_t> matches;
+    for (std::size_t i = 0; i < records.size() && matches.size() < limit; ++i) {
+        if (predicate(records[i])) {
+            matches.push_back(i);
+        }
+    }
+    return matches;
+}
+
+std::size_t blockCount(const Records& records, std::size_t block_size) {
+    return (records.size() + block_size - 1) / block_size;
+}
+
+// Blocks keep their own matches and error. Once the finished prefix of blocks
+// holds `limit` matches (or ends in an error), stop_block is lowered to the
+// end of that prefix: nothing at or after it can change the result.
+class OrderedScan {
+public:
+    OrderedScan(const KeyPredicate& predicate, const Records& records, std::size_t limit, std::size_t block_size)
+        : predicate_(predicate), records_(records), limit_(limit), block_size_(block_size),
+          blocks_(blockCount(records, block_size)), stop_block_(blocks_), matches_(blocks_), errors_(blocks_),
+          done_(blocks_, 0) {}
+
+    void work() {
+        for (;;) {
+            const std::size_t b = next_block_.fetch_add(1, std::memory_order_relaxed);
+            if (b >= stop_block_.load(std::memory_order_relaxed)) {
+                return; // blocks are claimed in order: every later one is cancelled too
+            }
+            const std::size_t end = std::min(records_.size(), (b + 1) * block_size_);
+            std::vector<std::size_t>& out = matches_[b];
+            try {
+                for (std::size_t i = b * block_size_; i < end && out.size() < limit_; ++i) {
+                    if (b >= stop_block_.load(std::memory_order_relaxed)) break;
+                    if (predicate_(records_[i])) {
+                        out.push_back(i);
+                    }
+                }
+            } catch (...) {
+                errors_[b] = std::current_exception();
+            }
+            finish(b);
+        }
+    }
+
+    std::vector<std::size_t> result() {
+        std::vector<std::size_t> matches;
+        for (std::size_t b = 0; b < blocks_; ++b) {
+            for (std::size_t i : matches_[b]) {
+                matches.push_back(i);
+                if (matches.size() == limit_) return matches;
+            }
+            if (errors_[b]) {
+                std::rethrow_exception(errors_[b]);
+            }
+        }
+        return matches;
+    }
+
+private:
+    void finish(std::size_t b) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_[b] = 1;
+        while (!stopped_ && prefix_ < blocks_ && done_[prefix_]) {
+            prefix_matches_ += matches_[prefix_].size();
+            const bool failed = errors_[prefix_] != nullptr;
+            ++prefix_;
+            if (prefix_matches_ >= limit_ || failed) {
+                stopped_ = true;
+                stop_block_.store(prefix_, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const KeyPredicate& predicate_;
+    const Records& records_;
+    const std::size_t limit_;
+    const std::size_t block_size_;
+    const std::size_t blocks_;
+    std::atomic<std::size_t> next_block_{0};
+    std::atomic<std::size_t> stop_block_;
+    std::vector<std::vector<std::size_t>> matches_; // per block
+    std::vector<std::exception_ptr> errors_;        // per block
+
+    std::mutex mutex_; // guards the finished prefix
+    std::vector<uint8_t> done_;
+    std::size_t prefix_ = 0;
+    std::size_t prefix_matches_ = 0;
+    bool stopped_ = false;
+};
+
+// Every match takes a ticket from `found_`; tickets past the limit (or an
+// error) stop all workers.
+class UnorderedScan {
+public:
+    UnorderedScan(const KeyPredicate& predicate, const Records& records, std::size_t limit, std::size_t block_size)
+        : predicate_(predicate), records_(records), limit_(limit), block_size_(block_size),
+          blocks_(blockCount(records, block_size)) {}
+
+    void work() {
+        std::vector<std::size_t> local;
+        try {
+            while (!cancelled()) {
+                const std::size_t b = next_block_.fetch_add(1, std::memory_order_relaxed);
+                if (b >= blocks_) break;
+                const std::size_t end = std::min(records_.size(), (b + 1) * block_size_);
+                for (std::size_t i = b * block_size_; i < end && !cancelled(); ++i) {
+                    if (predicate_(records_[i]) && found_.fetch_add(1, std::memory_order_relaxed) < limit_) {
+                        local.push_back(i);
+                    }
+                }
+            }
+        } catch (...) {
+            failed_.store(true, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        matches_.insert(matches_.end(), local.begin(), local.end());
+    }
+
+    std::vector<std::size_t> result() {
+        if (error_ && matches_.size() < limit_) {
+            std::rethrow_exception(error_);
+        }
+        std::sort(matches_.begin(), matches_.end());
+        return std::move(matches_);
+    }
+
+private:
+    bool cancelled() const {
+        return found_.load(std::memory_order_relaxed) >= limit_ || failed_.load(std::memory_order_relaxed);
+    }
+
+    const KeyPredicate& predicate_;
+    const Records& records_;
+    const std::size_t limit_;
+    const std::size_t block_size_;
+    const std::size_t blocks_;
+    std::atomic<std::size_t> next_block_{0};
+    std::atomic<std::size_t> found_{0};
+    std::atomic<bool> failed_{false};
+
+    std::mutex mutex_;
+    std::vector<std::size_t> matches_;
+    std::exception_ptr error_;
+};
+
+template <typename Scan>
+std::vector<std::size_t> runParallel(Scan& scan, unsigned threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([&scan] { scan.work(); });
+    }
+    scan.work(); // the calling thread is a worker too
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return scan.result();
+}
+
+} // namespace
+
+std::vector<std::size_t> scanMatches(const KeyPredicate& predicate, const std::vector<std::vector<Key>>& records,
+                                     const ScanOptions& options) {
+    if (options.limit == 0 || records.empty()) {
+        return {};
+    }
+    const std::size_t block_size = std::max<std::size_t>(options.block_size, 1);
+    unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned>(std::min<std::size_t>(std::max(threads, 1u), blockCount(records, block_size)));
+    if (threads == 1) {
+        return scanSequential(predicate, records, options.limit);
+    }
+    if (options.ordered) {
+        OrderedScan scan(predicate, records, options.limit, block_size);
+        return runParallel(scan, threads);
+    }
+    UnorderedScan scan(predicate, records, options.limit, block_size);
+    return runParallel(scan, threads);
+}
+
+bool anyMatch(const KeyPredicate& predicate, const std::vector<std::vector<Key>>& records, unsigned threads) {
+    ScanOptions options;
+    options.limit = 1;
+    options.threads = threads;
+    options.ordered = false;
+    return !scanMatches(predicate, records, options).empty();
+}
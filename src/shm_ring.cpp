@@ -0,0 +1,123 @@
+#include "shm_ring.h"
+
+#ifndef _WIN32 // POSIX shared memory only
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+[[noreturn]] void throwErrno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void* mapShared(int fd, std::size_t size, const std::string& name) {
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        throwErrno("mmap " + name);
+    }
+    close(fd); // the mapping keeps the object alive
+    return data;
+}
+
+} // namespace
+
+SharedMemory SharedMemory::create(const std::string& name, std::size_t size) {
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throwErrno("shm_open " + name);
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const int err = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        errno = err;
+        throwErrno("ftruncate " + name);
+    }
+    try {
+        return SharedMemory(name, mapShared(fd, size, name), size, true);
+    } catch (...) {
+        shm_unlink(name.c_str());
+        throw;
+    }
+}
+
+SharedMemory SharedMemory::open(const std::string& name, std::size_t size) {
+    const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        throwErrno("shm_open " + name);
+    }
+    // Touching pages past the end of the object raises SIGBUS, e.g. when the
+    // producer has not sized it yet or was built with another channel.
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        const int err = errno;
+        close(fd);
+        errno = err;
+        throwErrno("fstat " + name);
+    }
+    if (static_cast<std::size_t>(st.st_size) < size) {
+        close(fd);
+        errno = EINVAL;
+        throwErrno("shm object " + name + " is smaller than " + std::to_string(size) + " bytes");
+    }
+    return SharedMemory(name, mapShared(fd, size, name), size, false);
+}
+
+void SharedMemory::checkFits(std::size_t bytes) const {
+    if (bytes > size_) {
+        errno = EINVAL;
+        throwErrno("channel does not fit in " + name_);
+    }
+}
+
+void SharedMemory::checkChannelSize(uint64_t stored, std::size_t expected) {
+    if (stored != expected) {
+        errno = EINVAL;
+        throwErrno("channel in shared memory has a different layout");
+    }
+}
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept
+    : name_(std::move(other.name_)), data_(other.data_), size_(other.size_), owner_(other.owner_) {
+    other.data_ = nullptr;
+    other.owner_ = false;
+}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept {
+    if (this != &other) {
+        reset();
+        name_ = std::move(other.name_);
+        data_ = other.data_;
+        size_ = other.size_;
+        owner_ = other.owner_;
+        other.data_ = nullptr;
+        other.owner_ = false;
+    }
+    return *this;
+}
+
+SharedMemory::~SharedMemory() {
+    reset();
+}
+
+void SharedMemory::reset() {
+    if (data_) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (owner_) {
+        shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+#endif // _WIN32
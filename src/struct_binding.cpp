@@ -0,0 +1,218 @@
+#include "struct_binding.h"
+#include "bitmask.h"
+#include "comparison.h"
+#include "sample_hash.h"
+#include "threshold.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+template <typename T>
+T load(const char* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+int64_t loadInteger(const char* base, std::size_t offset, std::size_t size) {
+    return size == sizeof(int32_t) ? load<int32_t>(base + offset) : load<int64_t>(base + offset);
+}
+
+} // namespace
+
+StructPlan::Operand StructPlan::resolve(const std::vector<FieldDescriptor>& fields, const std::string& name) {
+    auto it = std::find_if(fields.begin(), fields.end(),
+                           [&name](const FieldDescriptor& f) { return f.name == name; });
+    if (it == fields.end()) {
+        throw ParseException("Key not found: " + name);
+    }
+    return Operand{it->type, it->offset, it->size, it->inline_chars};
+}
+
+StructPlan::StructPlan(const std::vector<FieldDescriptor>& fields, const FilterCondition& condition) {
+    clauses_.reserve(condition.sub_expressions.size());
+    for (const auto& subExpr : condition.sub_expressions) {
+        Clause clause{};
+        clause.prev_logical_op = subExpr.prev_logical_op;
+        if (const auto* u = std::get_if<UnaryExpression>(&subExpr.expr)) {
+            clause.kind = Kind::COMPARE;
+            clause.left = resolve(fields, u->key);
+            clause.op = u->op;
+            clause.compared_type = clause.left.type;
+            clause.constant = u->value;
+        } else if (const auto* b = std::get_if<BinaryExpression>(&subExpr.expr)) {
+            clause.kind = Kind::ARITHMETIC;
+            clause.left = resolve(fields, b->left_key);
+            clause.right = resolve(fields, b->right_key);
+            if (!isNumeric(clause.left.type) || !isNumeric(clause.right.type)) {
+                throw ParseException("Arithmetic operations require numeric types");
+            }
+            clause.arith_op = b->arith_op;
+            clause.op = b->comp_op;
+            clause.compared_type = clause.left.type == DataTypes::INTEGER && clause.right.type == DataTypes::INTEGER
+                                       ? DataTypes::INTEGER
+                                       : DataTypes::DOUBLE;
+            clause.constant = b->value;
+        } else if (const auto* m = std::get_if<BitmaskExpression>(&subExpr.expr)) {
+            clause.kind = Kind::BITMASK;
+            clause.left = resolve(fields, m->key);
+            if (clause.left.type != DataTypes::INTEGER) {
+                throw ParseException("Bitmask predicates require integer keys: " + m->key);
+            }
+            const BitmaskTest test = BitmaskTest::compile(*m);
+            clause.bit_mask = test.mask;
+            clause.bit_expect = test.expect;
+            clause.op = test.negate ? ComparisonOperations::NOT_EQUAL : ComparisonOperations::EQUAL;
+            clause.compared_type = DataTypes::INTEGER;
+            clause.constant = static_cast<int64_t>(test.expect);
+        } else if (const auto* s = std::get_if<SampleExpression>(&subExpr.expr)) {
+            clause.kind = Kind::SAMPLE;
+            clause.left = resolve(fields, s->key);
+            if (clause.left.type != DataTypes::INTEGER && clause.left.type != DataTypes::STRING) {
+                throw ParseException("Sample predicates require integer or string keys: " + s->key);
+            }
+            const SampleTest test = SampleTest::compile(*s);
+            clause.sample_seed = test.mixed_seed;
+            clause.sample_threshold = test.threshold;
+            clause.compared_type = clause.left.type;
+            clause.constant = clause.left.type == DataTypes::INTEGER ? ValueType{int64_t{0}} : ValueType{std::string()};
+        } else if (const auto* t = std::get_if<ThresholdExpression>(&subExpr.expr)) {
+            checkThreshold(*t);
+            clause.kind = Kind::THRESHOLD;
+            clause.min_count = t->min_count;
+            for (const auto& child : t->children) {
+                clause.children.emplace_back(fields, child);
+            }
+            clauses_.push_back(std::move(clause));
+            continue;
+        } else if (const auto* e = std::get_if<ExistsExpression>(&subExpr.expr)) {
+            // Every described field is always present
+            const bool known = std::any_of(fields.begin(), fields.end(),
+                                           [e](const FieldDescriptor& f) { return f.name == e->key; });
+            clause.kind = Kind::FIXED;
+            clause.fixed_result = known == e->exists;
+            clauses_.push_back(std::move(clause));
+            continue;
+        } else {
+            throw ParseException("List, CIDR and geo predicates are not supported on struct fields");
+        }
+        if (valueDataType(clause.constant) != clause.compared_type) {
+            throw ParseException("Comparison requires operands of the same type");
+        }
+        if (clause.compared_type == DataTypes::BOOLEAN && !isEqualityComparison(clause.op)) {
+            throw ParseException("Unsupported comparison operation for boolean");
+        }
+        clauses_.push_back(std::move(clause));
+    }
+}
+
+bool StructPlan::evaluateClause(const Clause& clause, const char* base) {
+    switch (clause.kind) {
+        case Kind::COMPARE: return evaluateComparison(clause, base);
+        case Kind::ARITHMETIC: return evaluateArithmetic(clause, base);
+        case Kind::BITMASK: {
+            // int32_t fields are sign-extended, so high flag bits read as in int64_t
+            const auto bits = static_cast<uint64_t>(loadInteger(base, clause.left.offset, clause.left.size));
+            return ((bits & clause.bit_mask) == clause.bit_expect) == (clause.op == ComparisonOperations::EQUAL);
+        }
+        case Kind::SAMPLE: {
+            const SampleTest test{clause.sample_seed, clause.sample_threshold};
+            if (clause.compared_type == DataTypes::INTEGER) {
+                return test(loadInteger(base, clause.left.offset, clause.left.size));
+            }
+            const char* field = base + clause.left.offset;
+            if (clause.left.inline_chars) {
+                return test(std::string_view(field, static_cast<std::size_t>(
+                                                        std::find(field, field + clause.left.size, '\0') - field)));
+            }
+            return test(std::string_view(*reinterpret_cast<const std::string*>(field)));
+        }
+        case Kind::THRESHOLD: {
+            const std::size_t n = clause.children.size();
+            std::size_t passed = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                passed += clause.children[i].evaluate(base) ? 1 : 0;
+                if (passed >= clause.min_count) return true;
+                if (passed + (n - 1 - i) < clause.min_count) return false;
+            }
+            return false;
+        }
+        case Kind::FIXED: return clause.fixed_result;
+    }
+    return false;
+}
+
+bool StructPlan::evaluateArithmetic(const Clause& clause, const char* base) {
+    if (clause.compared_type == DataTypes::INTEGER) {
+        const int64_t l = loadInteger(base, clause.left.offset, clause.left.size);
+        const int64_t r = loadInteger(base, clause.right.offset, clause.right.size);
+        int64_t value = 0;
+        switch (clause.arith_op) {
+            case ArithmeticOperations::ADD: value = l + r; break;
+            case ArithmeticOperations::SUBTRACT: value = l - r; break;
+            case ArithmeticOperations::MULTIPLY: value = l * r; break;
+            case ArithmeticOperations::DIVIDE:
+                if (r == 0) throw ParseException("Division by zero");
+                value = l / r;
+                break;
+            default: throw ParseException("Unsupported arithmetic operation");
+        }
+        return compareOrdered(value, clause.op, std::get<int64_t>(clause.constant));
+    }
+    auto asDouble = [base](const Operand& o) {
+        return o.type == DataTypes::INTEGER ? static_cast<double>(loadInteger(base, o.offset, o.size))
+                                            : load<double>(base + o.offset);
+    };
+    const double l = asDouble(clause.left);
+    const double r = asDouble(clause.right);
+    double value = 0.0;
+    switch (clause.arith_op) {
+        case ArithmeticOperations::ADD: value = l + r; break;
+        case ArithmeticOperations::SUBTRACT: value = l - r; break;
+        case ArithmeticOperations::MULTIPLY: value = l * r; break;
+        case ArithmeticOperations::DIVIDE:
+            if (r == 0.0) throw ParseException("Division by zero");
+            value = l / r;
+            break;
+        default: throw ParseException("Unsupported arithmetic operation");
+    }
+    return compareOrdered(value, clause.op, std::get<double>(clause.constant));
+}
+
+bool StructPlan::evaluateComparison(const Clause& clause, const char* base) {
+    const char* field = base + clause.left.offset;
+    switch (clause.compared_type) {
+        case DataTypes::INTEGER:
+            return compareOrdered(loadInteger(base, clause.left.offset, clause.left.size), clause.op,
+                                  std::get<int64_t>(clause.constant));
+        case DataTypes::DOUBLE:
+            return compareOrdered(load<double>(field), clause.op, std::get<double>(clause.constant));
+        case DataTypes::STRING:
+            if (clause.left.inline_chars) {
+                const std::size_t length = static_cast<std::size_t>(std::find(field, field + clause.left.size, '\0') - field);
+                const std::string_view chars(field, length);
+                return compareOrdered(chars, clause.op, std::string_view(std::get<std::string>(clause.constant)));
+            }
+            return compareOrdered(*reinterpret_cast<const std::string*>(field), clause.op,
+                                  std::get<std::string>(clause.constant));
+        case DataTypes::BOOLEAN:
+            return compareBool(load<bool>(field), clause.op, std::get<bool>(clause.constant));
+        case DataTypes::IP_ADDRESS:
+            return compareOrdered(load<IpAddress>(field), clause.op, std::get<IpAddress>(clause.constant));
+    }
+    throw ParseException("Unsupported type for comparison");
+}
+
+bool StructPlan::evaluate(const void* record) const {
+    const auto* base = static_cast<const char*>(record);
+    bool result = true; // Default to true for AND operations
+    for (const auto& clause : clauses_) {
+        if (!LanguageParser::needsClause(result, clause.prev_logical_op)) {
+            continue;
+        }
+        result = LanguageParser::combine(result, clause.prev_logical_op, evaluateClause(clause, base));
+    }
+    return result;
+}
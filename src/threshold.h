@@ -0,0 +1,6 @@
+#pragma once
+
+#include "filter_structs.h"
+
+// Throws ParseException unless 1 <= min_count <= children.size()
+void checkThreshold(const ThresholdExpression& expr);
@@ -0,0 +1,39 @@
+#include "parser.h"
+#include "threshold.h"
+#include <memory>
+#include <string>
+
+void checkThreshold(const ThresholdExpression& expr) {
+    if (expr.min_count < 1 || expr.min_count > expr.children.size()) {
+        throw ParseException("Threshold must lie between 1 and the number of children (" +
+                             std::to_string(expr.children.size()) + "): " + std::to_string(expr.min_count));
+    }
+}
+
+KeyPredicate LanguageParser::compileThresholdClause(const ThresholdExpression& expr) {
+    checkThreshold(expr);
+    std::vector<KeyPredicate> children;
+    children.reserve(expr.children.size());
+    for (const auto& child : expr.children) {
+        // A lone clause (after the default true) is its own result: skip the fold
+        const auto& subs = child.sub_expressions;
+        const bool lone = subs.size() == 1 && (subs[0].prev_logical_op == LogicalOperations::NONE ||
+                                               subs[0].prev_logical_op == LogicalOperations::AND);
+        children.push_back(lone ? compileClause(subs[0]) : parse(child));
+    }
+    return [children = std::make_shared<const std::vector<KeyPredicate>>(std::move(children)),
+            min_count = expr.min_count](const std::vector<Key>& keys) {
+        const std::size_t n = children->size();
+        std::size_t passed = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            passed += (*children)[i](keys) ? 1 : 0;
+            if (passed >= min_count) {
+                return true;
+            }
+            if (passed + (n - 1 - i) < min_count) {
+                return false; // not enough children left
+            }
+        }
+        return false;
+    };
+}
@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "parser.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  // A small record batch held in plain vectors, exposed both as a
+  // ColumnBatch and as the equivalent per-row Key vectors.
+  struct Table {
+    std::vector<int64_t> qty;
+    std::vector<int64_t> venue;
+    std::vector<double> price;
+    std::vector<uint8_t> is_buy; // bitmap
+    std::vector<int32_t> symbol_offsets{0};
+    std::string symbol_data;
+
+    void add(int64_t q, int64_t v, double p, bool b, const std::string &s) {
+      const std::size_t row = qty.size();
+      qty.push_back(q);
+      venue.push_back(v);
+      price.push_back(p);
+      if (row % 8 == 0) is_buy.push_back(0);
+      if (b) is_buy[row / 8] |= static_cast<uint8_t>(1u << (row % 8));
+      symbol_data += s;
+      symbol_offsets.push_back(static_cast<int32_t>(symbol_data.size()));
+    }
+
+    int64_t rows() const { return static_cast<int64_t>(qty.size()); }
+
+    ColumnBatch batch() const {
+      ColumnBatch b;
+      b.addColumn("qty", ColumnView::ofInt64(qty.data(), rows()));
+      b.addColumn("venue", ColumnView::ofInt64(venue.data(), rows()));
+      b.addColumn("price", ColumnView::ofDouble(price.data(), rows()));
+      b.addColumn("is_buy", ColumnView::ofBoolBitmap(is_buy.data(), rows()));
+      b.addColumn("symbol", ColumnView::ofStrings(symbol_offsets.data(),
+                                                  symbol_data.data(), rows()));
+      return b;
+    }
+
+    std::vector<Key> keys(int64_t i) const {
+      const auto begin = symbol_offsets[i];
+      return {Key("qty", qty[i]), Key("venue", venue[i]),
+              Key("price", price[i]),
+              Key("is_buy", ColumnView::bit(is_buy.data(), i)),
+              Key("symbol", symbol_data.substr(begin, symbol_offsets[i + 1] - begin))};
+    }
+  };
+
+  Table MakeTable() {
+    Table t;
+    const char *symbols[] = {"ACME", "INIT", "ZETA"};
+    for (int i = 0; i < 37; ++i) {
+      t.add(i * 7 % 23, i % 5 + 1, 0.5 * (i % 11), i % 3 == 0, symbols[i % 3]);
+    }
+    return t;
+  }
+
+  void ExpectMatchesRowPath(const FilterCondition &cond, const Table &t) {
+    BatchEvaluator evaluator;
+    evaluator.initialize(cond);
+    std::vector<uint8_t> mask;
+    evaluator.evaluate(t.batch(), mask);
+    ASSERT_EQ(static_cast<int64_t>(mask.size()), t.rows());
+
+    auto reference = LanguageParser::parse(cond);
+    for (int64_t i = 0; i < t.rows(); ++i) {
+      EXPECT_EQ(mask[i] != 0, reference(t.keys(i))) << "row " << i;
+    }
+  }
+
+  // ---------- Tests ----------
+
+  TEST(BatchEvaluator_Evaluate, MatchesRowPathPerType) {
+    const Table t = MakeTable();
+    ExpectMatchesRowPath(
+        {{SE(UE(ComparisonOperations::GREATER_EQUAL, "qty",
+                static_cast<int64_t>(10)))}},
+        t);
+    ExpectMatchesRowPath(
+        {{SE(UE(ComparisonOperations::LESS_THAN, "price", 2.5))}}, t);
+    ExpectMatchesRowPath(
+        {{SE(UE(ComparisonOperations::NOT_EQUAL, "symbol",
+                std::string("INIT")))}},
+        t);
+    ExpectMatchesRowPath(
+        {{SE(UE(ComparisonOperations::EQUAL, "is_buy", true))}}, t);
+  }
+
+  TEST(BatchEvaluator_Evaluate, MatchesRowPathMixedChain) {
+    const Table t = MakeTable();
+    ExpectMatchesRowPath(
+        {{SE(UE(ComparisonOperations::EQUAL, "symbol", std::string("ACME"))),
+          SE(UE(ComparisonOperations::EQUAL, "is_buy", true),
+             LogicalOperations::AND),
+          SE(BE("qty", ArithmeticOperations::MULTIPLY, "price",
+                ComparisonOperations::GREATER_EQUAL, 20.0),
+             LogicalOperations::AND),
+          SE(BE("qty", ArithmeticOperations::DIVIDE, "venue",
+                ComparisonOperations::LESS_THAN, static_cast<int64_t>(3)),
+             LogicalOperations::OR)}},
+        t);
+  }
+
+  TEST(BatchEvaluator_Evaluate, NullRowsNeverMatch) {
+    const std::vector<int64_t> values{1, 2, 3, 4};
+    const uint8_t validity[] = {0b1011}; // row 2 is null
+    ColumnView column = ColumnView::ofInt64(values.data(), 4);
+    column.validity = validity;
+    ColumnBatch batch;
+    batch.addColumn("x", column);
+
+    BatchEvaluator evaluator;
+    evaluator.initialize({{SE(UE(ComparisonOperations::GREATER_THAN, "x",
+                                 static_cast<int64_t>(0)))}});
+    EXPECT_EQ(evaluator.select(batch), (std::vector<uint32_t>{0, 1, 3}));
+  }
+
+  TEST(BatchEvaluator_Evaluate, DivisionByZeroOnlyWhereRowIsNeeded) {
+    const std::vector<int64_t> gate{0, 1};
+    const std::vector<int64_t> num{5, 5};
+    const std::vector<int64_t> den{0, 5};
+    ColumnBatch batch;
+    batch.addColumn("gate", ColumnView::ofInt64(gate.data(), 2));
+    batch.addColumn("num", ColumnView::ofInt64(num.data(), 2));
+    batch.addColumn("den", ColumnView::ofInt64(den.data(), 2));
+
+    // Row 0 is already false, so the AND never divides by its zero.
+    BatchEvaluator evaluator;
+    evaluator.initialize(
+        {{SE(UE(ComparisonOperations::EQUAL, "gate", static_cast<int64_t>(1))),
+          SE(BE("num", ArithmeticOperations::DIVIDE, "den",
+                ComparisonOperations::EQUAL, static_cast<int64_t>(1)),
+             LogicalOperations::AND)}});
+    EXPECT_EQ(evaluator.select(batch), (std::vector<uint32_t>{1}));
+
+    evaluator.initialize({{SE(BE("num", ArithmeticOperations::DIVIDE, "den",
+                                 ComparisonOperations::EQUAL,
+                                 static_cast<int64_t>(1)))}});
+    EXPECT_THROW(evaluator.select(batch), ParseException);
+  }
+
+  TEST(BatchEvaluator_Errors, ColumnAndTypeErrors) {
+    const Table t = MakeTable();
+    const ColumnBatch batch = t.batch();
+    std::vector<uint8_t> mask;
+    BatchEvaluator evaluator;
+
+    evaluator.initialize({{SE(UE(ComparisonOperations::EQUAL, "missing",
+                                 static_cast<int64_t>(1)))}});
+    EXPECT_THROW(evaluator.evaluate(batch, mask), ParseException);
+
+    evaluator.initialize({{SE(UE(ComparisonOperations::EQUAL, "qty", 1.0))}});
+    EXPECT_THROW(evaluator.evaluate(batch, mask), ParseException);
+
+    evaluator.initialize(
+        {{SE(UE(ComparisonOperations::LESS_THAN, "is_buy", true))}});
+    EXPECT_THROW(evaluator.evaluate(batch, mask), ParseException);
+
+    const std::vector<int64_t> shorter{1};
+    ColumnBatch mismatched = t.batch();
+    EXPECT_THROW(
+        mismatched.addColumn("short", ColumnView::ofInt64(shorter.data(), 1)),
+        ParseException);
+  }
+
+  TEST(BatchEvaluator_Arrow, ImportsStructArrayZeroCopy) {
+    // Two-row slice (offset 1) of a three-row record batch {id: int64, name: utf8}
+    const int64_t ids[] = {10, 20, 30};
+    const int32_t name_offsets[] = {0, 1, 3, 6};
+    const char name_data[] = "abbccc";
+    const void *id_buffers[] = {nullptr, ids};
+    const void *name_buffers[] = {nullptr, name_offsets, name_data};
+
+    ArrowArray id_array{3, 0, 0, 2, 0, id_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray name_array{3, 0, 0, 3, 0, name_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema id_schema{"l", "id", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema name_schema{"u", "name", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+
+    ArrowArray *children[] = {&id_array, &name_array};
+    ArrowSchema *child_schemas[] = {&id_schema, &name_schema};
+    const void *struct_buffers[] = {nullptr};
+    ArrowArray root{2, 0, 1, 1, 2, struct_buffers, children, nullptr, nullptr, nullptr};
+    ArrowSchema root_schema{"+s", "", nullptr, 0, 2, child_schemas, nullptr, nullptr, nullptr};
+
+    const ColumnBatch batch = ColumnBatch::fromArrow(root, root_schema);
+    ASSERT_EQ(batch.numRows(), 2);
+    EXPECT_EQ(batch.find("id")->int64At(0), 20);
+    EXPECT_EQ(batch.find("name")->stringAt(1), "ccc");
+
+    BatchEvaluator evaluator;
+    evaluator.initialize({{SE(UE(ComparisonOperations::EQUAL, "name",
+                                 std::string("ccc"))),
+                           SE(UE(ComparisonOperations::EQUAL, "id",
+                                 static_cast<int64_t>(20)),
+                              LogicalOperations::OR)}});
+    EXPECT_EQ(evaluator.select(batch), (std::vector<uint32_t>{0, 1}));
+
+    ArrowSchema bad_schema = id_schema;
+    bad_schema.format = "i"; // int32 is not supported
+    ColumnBatch b;
+    EXPECT_THROW(b.addArrowColumn("id", id_array, bad_schema), ParseException);
+  }
+
+  TEST(BatchEvaluator_Arrow, RejectsDictionaryEncodedColumn) {
+    // utf8 dictionary {"a", "bb"} with int64 indices: format "l" alone
+    // would pass for a plain int64 column
+    const int32_t dict_offsets[] = {0, 1, 3};
+    const char dict_data[] = "abb";
+    const void *dict_buffers[] = {nullptr, dict_offsets, dict_data};
+    ArrowArray dict_array{2, 0, 0, 3, 0, dict_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema dict_schema{"u", "", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+
+    const int64_t indices[] = {1, 0, 1};
+    const void *index_buffers[] = {nullptr, indices};
+    ArrowArray array{3, 0, 0, 2, 0, index_buffers, nullptr, &dict_array, nullptr, nullptr};
+    ArrowSchema schema{"l", "name", nullptr, 0, 0, nullptr, &dict_schema, nullptr, nullptr};
+
+    ColumnBatch batch;
+    EXPECT_THROW(batch.addArrowColumn("name", array, schema), ParseException);
+
+    ArrowArray *children[] = {&array};
+    ArrowSchema *child_schemas[] = {&schema};
+    const void *struct_buffers[] = {nullptr};
+    ArrowArray root{3, 0, 0, 1, 1, struct_buffers, children, nullptr, nullptr, nullptr};
+    ArrowSchema root_schema{"+s", "", nullptr, 0, 1, child_schemas, nullptr, nullptr, nullptr};
+    EXPECT_THROW(ColumnBatch::fromArrow(root, root_schema), ParseException);
+  }
+
+  TEST(BatchEvaluator_Arrow, ExportsBooleanArray) {
+    const Table t = MakeTable();
+    BatchEvaluator evaluator;
+    evaluator.initialize({{SE(UE(ComparisonOperations::EQUAL, "symbol",
+                                 std::string("ZETA")))}});
+
+    ArrowArray out;
+    ArrowSchema out_schema;
+    evaluator.exportArrow(t.batch(), &out, &out_schema);
+    ASSERT_NE(out.release, nullptr);
+    EXPECT_STREQ(out_schema.format, "b");
+    EXPECT_EQ(out.length, t.rows());
+    EXPECT_EQ(out.null_count, 0);
+
+    const auto *bits = static_cast<const uint8_t *>(out.buffers[1]);
+    const auto selection = evaluator.select(t.batch());
+    std::size_t next = 0;
+    for (int64_t i = 0; i < t.rows(); ++i) {
+      const bool expected = next < selection.size() && selection[next] == i;
+      EXPECT_EQ(ColumnView::bit(bits, i), expected) << "row " << i;
+      if (expected) ++next;
+    }
+    EXPECT_EQ(next, selection.size());
+
+    out.release(&out);
+    out_schema.release(&out_schema);
+    EXPECT_EQ(out.release, nullptr);
+    EXPECT_EQ(out_schema.release, nullptr);
+  }
+
+} // namespace
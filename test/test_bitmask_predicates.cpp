@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+#include "struct_binding.h"
+
+struct Flagged {
+  int64_t flags;
+  int32_t small_flags;
+  double score;
+};
+EXPR_EVAL_STRUCT(Flagged, EXPR_EVAL_FIELD(flags), EXPR_EVAL_FIELD(small_flags),
+                 EXPR_EVAL_FIELD(score));
+
+namespace {
+
+  SubExpression SE(BitmaskExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  FilterCondition Bits(BitTest test, int64_t mask, int shift = 0, int64_t value = 0,
+                       std::string key = "flags") {
+    return {{SE(BitmaskExpression{test, std::move(key), mask, shift, value})}};
+  }
+
+  bool Eval(const FilterCondition &cond, int64_t flags) {
+    return LanguageParser::parse(cond)({Key("flags", flags)});
+  }
+
+  // Reference semantics, written out with an explicit shift
+  bool Reference(BitTest test, int64_t mask, int shift, int64_t value, int64_t flags) {
+    const uint64_t bits = (static_cast<uint64_t>(flags) >> shift) & static_cast<uint64_t>(mask);
+    switch (test) {
+      case BitTest::ALL: return bits == static_cast<uint64_t>(mask);
+      case BitTest::ANY: return bits != 0;
+      case BitTest::NONE: return bits == 0;
+      case BitTest::FIELD_EQUAL: return bits == static_cast<uint64_t>(value);
+    }
+    return false;
+  }
+
+  // ---------- Tests ----------
+
+  TEST(BitmaskPredicates_Row, AllAnyNone) {
+    EXPECT_TRUE(Eval(Bits(BitTest::ALL, 0b1010), 0b1110));
+    EXPECT_FALSE(Eval(Bits(BitTest::ALL, 0b1010), 0b0110));
+    EXPECT_TRUE(Eval(Bits(BitTest::ANY, 0b1010), 0b0010));
+    EXPECT_FALSE(Eval(Bits(BitTest::ANY, 0b1010), 0b0101));
+    EXPECT_TRUE(Eval(Bits(BitTest::NONE, 0b1010), 0b0101));
+    EXPECT_FALSE(Eval(Bits(BitTest::NONE, 0b1010), 0b1000));
+
+    // The sign bit is an ordinary flag
+    EXPECT_TRUE(Eval(Bits(BitTest::ALL, INT64_MIN), -1));
+    EXPECT_FALSE(Eval(Bits(BitTest::ANY, INT64_MIN), INT64_MAX));
+  }
+
+  TEST(BitmaskPredicates_Row, ShiftedFieldEquality) {
+    // A 4-bit field at bit 8
+    const int64_t flags = (0x5 << 8) | 0xff;
+    EXPECT_TRUE(Eval(Bits(BitTest::FIELD_EQUAL, 0xf, 8, 0x5), flags));
+    EXPECT_FALSE(Eval(Bits(BitTest::FIELD_EQUAL, 0xf, 8, 0x4), flags));
+    EXPECT_TRUE(Eval(Bits(BitTest::FIELD_EQUAL, 0xf, 60, 0xf), -1));
+    EXPECT_TRUE(Eval(Bits(BitTest::ALL, 0b11, 8), 0b1100000000));
+  }
+
+  TEST(BitmaskPredicates_Row, MatchesShiftedReference) {
+    const std::vector<int64_t> samples{0, 1, -1, 0x0123456789abcdefLL, INT64_MIN, 0x00ff00ff00ff00ffLL};
+    for (const BitTest test : {BitTest::ALL, BitTest::ANY, BitTest::NONE, BitTest::FIELD_EQUAL}) {
+      for (const int shift : {0, 4, 17, 32}) {
+        const int64_t mask = 0x3f;
+        const int64_t value = 0x15;
+        const auto predicate = LanguageParser::parse(Bits(test, mask, shift, value));
+        for (const int64_t flags : samples) {
+          EXPECT_EQ(predicate({Key("flags", flags)}), Reference(test, mask, shift, value, flags))
+              << static_cast<int>(test) << " shift " << shift << " flags " << flags;
+        }
+      }
+    }
+  }
+
+  TEST(BitmaskPredicates_Row, KeyTypes) {
+    const auto any = Bits(BitTest::ANY, 0x4);
+    EXPECT_TRUE(LanguageParser::parse(any)({Key::text("flags", "6")}));
+    EXPECT_THROW(LanguageParser::parse(any)({Key("flags", 6.0)}), ParseException);
+    EXPECT_THROW(LanguageParser::parse(any)({Key("other", int64_t{6})}), ParseException);
+  }
+
+  TEST(BitmaskPredicates_Errors, InvalidMasks) {
+    EXPECT_THROW(LanguageParser::parse(Bits(BitTest::ANY, 0)), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Bits(BitTest::ANY, 1, 64)), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Bits(BitTest::ANY, 1, -1)), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Bits(BitTest::ANY, 0xff, 60)), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Bits(BitTest::FIELD_EQUAL, 0xf, 0, 0x10)), ParseException);
+  }
+
+  TEST(BitmaskPredicates_Batch, MatchesRowPath) {
+    std::vector<int64_t> flags;
+    uint64_t x = 88172645463325252ull;
+    for (int i = 0; i < 300; ++i) {
+      x ^= x << 13;
+      x ^= x >> 7;
+      x ^= x << 17;
+      flags.push_back(static_cast<int64_t>(x));
+    }
+    const uint8_t validity[] = {0xff, 0xff, 0x7f}; // row 23 is null
+    ColumnView column = ColumnView::ofInt64(flags.data(), static_cast<int64_t>(flags.size()));
+    ColumnBatch batch;
+    batch.addColumn("flags", column);
+    column.validity = validity;
+    column.length = 24;
+    ColumnBatch with_nulls;
+    with_nulls.addColumn("flags", column);
+
+    for (const BitTest test : {BitTest::ALL, BitTest::ANY, BitTest::NONE, BitTest::FIELD_EQUAL}) {
+      const auto cond = Bits(test, 0x3, 5, 0x2);
+      BatchEvaluator evaluator;
+      evaluator.initialize(cond);
+      std::vector<uint8_t> mask;
+      evaluator.evaluate(batch, mask);
+      const auto row = LanguageParser::parse(cond);
+      for (std::size_t i = 0; i < flags.size(); ++i) {
+        EXPECT_EQ(mask[i] != 0, row({Key("flags", flags[i])})) << static_cast<int>(test) << " row " << i;
+      }
+      evaluator.evaluate(with_nulls, mask);
+      EXPECT_EQ(mask[23], 0);
+    }
+
+    std::vector<double> scores(flags.size(), 1.0);
+    ColumnBatch doubles;
+    doubles.addColumn("flags", ColumnView::ofDouble(scores.data(), static_cast<int64_t>(scores.size())));
+    BatchEvaluator evaluator;
+    evaluator.initialize(Bits(BitTest::ANY, 1));
+    std::vector<uint8_t> mask;
+    EXPECT_THROW(evaluator.evaluate(doubles, mask), ParseException);
+  }
+
+  TEST(BitmaskPredicates_Struct, Int64AndInt32Fields) {
+    StructEvaluator<Flagged> evaluator;
+    evaluator.initialize(Bits(BitTest::FIELD_EQUAL, 0x7, 3, 0x5));
+    EXPECT_TRUE(evaluator.evaluate(Flagged{0x5 << 3, 0, 0.0}));
+    EXPECT_FALSE(evaluator.evaluate(Flagged{0x4 << 3, 0, 0.0}));
+
+    // int32_t fields are sign-extended
+    evaluator.initialize(Bits(BitTest::ALL, INT64_MIN, 0, 0, "small_flags"));
+    EXPECT_TRUE(evaluator.evaluate(Flagged{0, -1, 0.0}));
+    evaluator.initialize(Bits(BitTest::NONE, 0x1, 0, 0, "small_flags"));
+    EXPECT_TRUE(evaluator.evaluate(Flagged{0, 2, 0.0}));
+
+    EXPECT_THROW(evaluator.initialize(Bits(BitTest::ANY, 1, 0, 0, "score")), ParseException);
+  }
+
+  TEST(BitmaskPredicates_Stats, FingerprintCoversMask) {
+    EXPECT_NE(conditionFingerprint(Bits(BitTest::ANY, 0x1)), conditionFingerprint(Bits(BitTest::ANY, 0x2)));
+    EXPECT_NE(conditionFingerprint(Bits(BitTest::FIELD_EQUAL, 0x3, 1, 1)),
+              conditionFingerprint(Bits(BitTest::FIELD_EQUAL, 0x3, 2, 1)));
+  }
+
+} // namespace
@@ -24,14 +24,12 @@ namespace {
 
   SubExpression SE(UnaryExpression ue,
                    LogicalOperations prev = LogicalOperations::NONE) {
-    return SubExpression{
-        std::variant<UnaryExpression, BinaryExpression>{std::move(ue)}, prev};
+    return SubExpression{Expression{std::move(ue)}, prev};
   }
 
   SubExpression SE(BinaryExpression be,
                    LogicalOperations prev = LogicalOperations::NONE) {
-    return SubExpression{
-        std::variant<UnaryExpression, BinaryExpression>{std::move(be)}, prev};
+    return SubExpression{Expression{std::move(be)}, prev};
   }
 
   std::vector<Key> MakeKeys(std::initializer_list<Key> init) {
@@ -86,6 +84,27 @@ namespace {
     EXPECT_TRUE(eval(keys));
   }
 
+  TEST(LanguageParser_Logic, SkipsClausesThatCannotChangeResult) {
+    auto keys = MakeKeys({Key("a", static_cast<int64_t>(1))});
+    // (a==2) AND (missing==1): the AND clause is never looked up
+    FilterCondition condAnd{
+        {SE(UE(ComparisonOperations::EQUAL, "a", static_cast<int64_t>(2))),
+         SE(UE(ComparisonOperations::EQUAL, "missing", static_cast<int64_t>(1)),
+            LogicalOperations::AND)}};
+    EXPECT_FALSE(LanguageParser::parse(condAnd)(keys));
+
+    // (a==1) OR (missing==1)
+    FilterCondition condOr{
+        {SE(UE(ComparisonOperations::EQUAL, "a", static_cast<int64_t>(1))),
+         SE(UE(ComparisonOperations::EQUAL, "missing", static_cast<int64_t>(1)),
+            LogicalOperations::OR)}};
+    EXPECT_TRUE(LanguageParser::parse(condOr)(keys));
+
+    // Once the clause can matter it is evaluated (and throws)
+    keys[0].setValue(static_cast<int64_t>(2));
+    EXPECT_THROW(LanguageParser::parse(condAnd)(keys), ParseException);
+  }
+
   TEST(LanguageParser_Errors, DivisionByZeroInt) {
     auto keys = MakeKeys({Key("x", static_cast<int64_t>(10)),
                           Key("y", static_cast<int64_t>(0))});
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "clause_stats.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  ClauseStats Stats(uint64_t evaluations, uint64_t passes, uint64_t cost_ns) {
+    ClauseStats s;
+    s.evaluations = evaluations;
+    s.passes = passes;
+    s.cost_ns = cost_ns;
+    return s;
+  }
+
+  std::string TempPath(const char *name) {
+    return ::testing::TempDir() + name;
+  }
+
+  // (a < 99) AND (b < 1) OR (c == 0)
+  FilterCondition AndThenOr() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::LESS_THAN, "a", static_cast<int64_t>(99))),
+         SE(UE(ComparisonOperations::LESS_THAN, "b", static_cast<int64_t>(1)),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::EQUAL, "c", static_cast<int64_t>(0)),
+            LogicalOperations::OR)}};
+  }
+
+  // ---------- Tests ----------
+
+  TEST(ClauseStats_Fingerprint, StructuralEquality) {
+    EXPECT_EQ(conditionFingerprint(AndThenOr()),
+              conditionFingerprint(AndThenOr()));
+    auto changed = AndThenOr();
+    std::get<UnaryExpression>(changed.sub_expressions[1].expr).value =
+        static_cast<int64_t>(2);
+    EXPECT_NE(conditionFingerprint(changed), conditionFingerprint(AndThenOr()));
+    changed = AndThenOr();
+    changed.sub_expressions[2].prev_logical_op = LogicalOperations::AND;
+    EXPECT_NE(conditionFingerprint(changed), conditionFingerprint(AndThenOr()));
+  }
+
+  TEST(ClauseStats_Order, SelectiveAndClauseMovesFirst) {
+    // a passes 99%, b passes 1%: b should run first; c is its own group
+    std::vector<ClauseStats> stats{Stats(100, 99, 100), Stats(100, 1, 100),
+                                   Stats(100, 0, 1)};
+    auto order = planClauseOrder(AndThenOr(), stats);
+    EXPECT_EQ(order, (std::vector<std::size_t>{1, 0, 2}));
+  }
+
+  TEST(ClauseStats_Order, UnsampledGroupKeepsWrittenOrder) {
+    std::vector<ClauseStats> stats{Stats(100, 99, 100), Stats(3, 0, 100),
+                                   Stats(100, 0, 1)};
+    auto order = planClauseOrder(AndThenOr(), stats);
+    EXPECT_EQ(order, (std::vector<std::size_t>{0, 1, 2}));
+  }
+
+  TEST(ClauseStats_Order, OrGroupPrefersCheapPassingClause) {
+    FilterCondition cond{
+        {SE(UE(ComparisonOperations::EQUAL, "a", static_cast<int64_t>(1))),
+         SE(UE(ComparisonOperations::EQUAL, "b", static_cast<int64_t>(1)),
+            LogicalOperations::OR),
+         SE(UE(ComparisonOperations::EQUAL, "c", static_cast<int64_t>(1)),
+            LogicalOperations::OR)}};
+    std::vector<ClauseStats> stats{Stats(100, 5, 100), Stats(100, 50, 100),
+                                   Stats(100, 90, 100)};
+    auto order = planClauseOrder(cond, stats);
+    EXPECT_EQ(order, (std::vector<std::size_t>{2, 1, 0}));
+  }
+
+  TEST(ClauseStats_Order, ReorderPreservesResults) {
+    const auto cond = AndThenOr();
+    const auto reordered = reorderClauses(cond, {1, 0, 2});
+    auto original = LanguageParser::parse(cond);
+    auto moved = LanguageParser::parse(reordered);
+    for (int64_t a : {0, 100}) {
+      for (int64_t b : {0, 5}) {
+        for (int64_t c : {0, 1}) {
+          std::vector<Key> keys{Key("a", a), Key("b", b), Key("c", c)};
+          EXPECT_EQ(original(keys), moved(keys)) << a << " " << b << " " << c;
+        }
+      }
+    }
+  }
+
+  TEST(ClauseStats_Store, SaveLoadRoundTrip) {
+    ClauseStatsStore store;
+    store.merge(42, {Stats(10, 3, 500), Stats(10, 9, 70)});
+    store.merge(7, {Stats(1, 1, 1)});
+    const auto path = TempPath("clause_stats_roundtrip.bin");
+    ASSERT_TRUE(store.save(path));
+
+    ClauseStatsStore loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 2u);
+    auto entry = loaded.lookup(42);
+    ASSERT_EQ(entry.size(), 2u);
+    EXPECT_EQ(entry[0].passes, 3u);
+    EXPECT_EQ(entry[1].cost_ns, 70u);
+    std::remove(path.c_str());
+  }
+
+  TEST(ClauseStats_Store, RejectsGarbage) {
+    const auto path = TempPath("clause_stats_garbage.bin");
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "not a stats file";
+    }
+    ClauseStatsStore store;
+    EXPECT_FALSE(store.load(path));
+    EXPECT_FALSE(store.load(TempPath("clause_stats_missing.bin")));
+    EXPECT_EQ(store.size(), 0u);
+    std::remove(path.c_str());
+  }
+
+  TEST(ClauseStats_Store, RejectsClauseCountBeyondFile) {
+    const auto path = TempPath("clause_stats_truncated.bin");
+    {
+      // Valid header and one entry claiming 2^32 - 1 clauses, with one present
+      std::ofstream out(path, std::ios::binary);
+      const uint32_t version = 1;
+      const uint64_t count = 1;
+      const uint64_t fingerprint = 42;
+      const uint32_t clauses = 0xffffffffu;
+      const uint64_t stats[3] = {10, 3, 500};
+      out.write("EXST", 4);
+      out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+      out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+      out.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+      out.write(reinterpret_cast<const char *>(&clauses), sizeof(clauses));
+      out.write(reinterpret_cast<const char *>(stats), sizeof(stats));
+    }
+    ClauseStatsStore store;
+    EXPECT_FALSE(store.load(path));
+    EXPECT_EQ(store.size(), 0u);
+    std::remove(path.c_str());
+  }
+
+  TEST(ClauseStats_Evaluator, WarmStartReordersAfterRestart) {
+    const auto cond = AndThenOr();
+    const auto path = TempPath("clause_stats_warm.bin");
+    {
+      ClauseStatsStore store;
+      Evaluator evaluator;
+      evaluator.initialize(cond, store);
+      EXPECT_EQ(evaluator.getClauseOrder(),
+                (std::vector<std::size_t>{0, 1, 2}));
+      // a always passes, b always fails
+      std::vector<Key> keys{Key("a", static_cast<int64_t>(0)),
+                            Key("b", static_cast<int64_t>(5)),
+                            Key("c", static_cast<int64_t>(1))};
+      for (int i = 0; i < 64 * 16; ++i) {
+        EXPECT_FALSE(evaluator.evaluate(keys));
+      }
+      evaluator.flushStats();
+      ASSERT_TRUE(store.save(path));
+    }
+
+    ClauseStatsStore store;
+    ASSERT_TRUE(store.load(path));
+    Evaluator evaluator;
+    evaluator.initialize(cond, store);
+    EXPECT_EQ(evaluator.getClauseOrder(), (std::vector<std::size_t>{1, 0, 2}));
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(0)),
+                          Key("b", static_cast<int64_t>(0)),
+                          Key("c", static_cast<int64_t>(1))};
+    EXPECT_TRUE(evaluator.evaluate(keys));
+    std::remove(path.c_str());
+  }
+
+} // namespace
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "cost_profiler.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition Chain(int clauses) {
+    FilterCondition cond;
+    for (int i = 0; i < clauses; ++i) {
+      cond.sub_expressions.push_back(
+          SE(UE(ComparisonOperations::LESS_THAN, "a", static_cast<int64_t>(100)),
+             i == 0 ? LogicalOperations::NONE : LogicalOperations::AND));
+    }
+    return cond;
+  }
+
+  const ConditionCost *Find(const std::vector<ConditionCost> &report,
+                            uint64_t plan_id) {
+    for (const auto &c : report) {
+      if (c.plan_id == plan_id) {
+        return &c;
+      }
+    }
+    return nullptr;
+  }
+
+  class CostProfilerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+      CostProfiler::reset();
+      CostProfiler::setSamplePeriod(1);
+      CostProfiler::setEnabled(true);
+    }
+    void TearDown() override { CostProfiler::setEnabled(false); }
+  };
+
+  // ---------- Tests ----------
+
+  TEST_F(CostProfilerTest, TopNOrdersByCallsAndCost) {
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator cheap;
+    cheap.initialize(Chain(1));
+    Evaluator expensive;
+    expensive.initialize(Chain(64));
+
+    for (int i = 0; i < 50; ++i) {
+      cheap.evaluate(keys);
+    }
+    for (int i = 0; i < 5; ++i) {
+      expensive.evaluate(keys);
+    }
+
+    auto by_calls = CostProfiler::report(2, CostOrder::CALLS);
+    ASSERT_EQ(by_calls.size(), 2u);
+    EXPECT_EQ(by_calls[0].plan_id, cheap.getPlanId());
+    EXPECT_EQ(by_calls[0].calls, 50u);
+    EXPECT_EQ(by_calls[1].plan_id, expensive.getPlanId());
+    EXPECT_EQ(by_calls[1].calls, 5u);
+
+    auto per_call = CostProfiler::report(1, CostOrder::PER_CALL);
+    ASSERT_EQ(per_call.size(), 1u);
+    EXPECT_EQ(per_call[0].plan_id, expensive.getPlanId());
+  }
+
+  TEST_F(CostProfilerTest, MergesAcrossThreads) {
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator evaluator;
+    evaluator.initialize(Chain(2));
+
+    auto work = [&evaluator, &keys] {
+      for (int i = 0; i < 1000; ++i) {
+        evaluator.evaluate(keys);
+      }
+    };
+    std::thread t1(work);
+    std::thread t2(work);
+    t1.join();
+    t2.join();
+    work();
+
+    const auto report = CostProfiler::report(16, CostOrder::TOTAL);
+    const auto *cost = Find(report, evaluator.getPlanId());
+    ASSERT_NE(cost, nullptr);
+    EXPECT_EQ(cost->calls, 3000u);
+    EXPECT_EQ(cost->sampled_calls, 3000u);
+  }
+
+  TEST_F(CostProfilerTest, SamplePeriodLimitsTimedCalls) {
+    CostProfiler::setSamplePeriod(10);
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator evaluator;
+    evaluator.initialize(Chain(1));
+    for (int i = 0; i < 100; ++i) {
+      evaluator.evaluate(keys);
+    }
+    const auto report = CostProfiler::report(16, CostOrder::CALLS);
+    const auto *cost = Find(report, evaluator.getPlanId());
+    ASSERT_NE(cost, nullptr);
+    EXPECT_EQ(cost->calls, 100u);
+    EXPECT_GE(cost->sampled_calls, 9u);
+    EXPECT_LE(cost->sampled_calls, 11u);
+  }
+
+  TEST_F(CostProfilerTest, NewPlansEvictInsteadOfOverflowing) {
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator evaluator;
+    // Far more plans than a thread's table holds
+    for (int i = 0; i < 20000; ++i) {
+      evaluator.initialize(Chain(1));
+      evaluator.evaluate(keys);
+    }
+    for (int i = 0; i < 5; ++i) {
+      evaluator.evaluate(keys);
+    }
+    auto report = CostProfiler::report(2, CostOrder::CALLS);
+    ASSERT_EQ(report.size(), 2u);
+    // Evicted plans are folded into plan 0, nothing is lost
+    EXPECT_EQ(report[0].plan_id, 0u);
+    EXPECT_EQ(report[1].plan_id, evaluator.getPlanId());
+    EXPECT_EQ(report[1].calls, 6u);
+    uint64_t calls = 0;
+    for (const auto &cost : CostProfiler::report(20000, CostOrder::CALLS)) calls += cost.calls;
+    EXPECT_EQ(calls, 20005u);
+
+    // reset() frees the slots
+    CostProfiler::reset();
+    EXPECT_TRUE(CostProfiler::report(16, CostOrder::CALLS).empty());
+    evaluator.initialize(Chain(1));
+    evaluator.evaluate(keys);
+    report = CostProfiler::report(16, CostOrder::CALLS);
+    ASSERT_EQ(report.size(), 1u);
+    EXPECT_EQ(report[0].plan_id, evaluator.getPlanId());
+  }
+
+  TEST_F(CostProfilerTest, ResetDropsCountsOfOtherThreads) {
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator evaluator;
+    evaluator.initialize(Chain(1));
+    auto work = [&evaluator, &keys] {
+      for (int i = 0; i < 10; ++i) {
+        evaluator.evaluate(keys);
+      }
+    };
+    std::thread(work).join();
+    ASSERT_NE(Find(CostProfiler::report(16, CostOrder::CALLS),
+                   evaluator.getPlanId()),
+              nullptr);
+
+    // The exited thread's table is only cleared when a thread next uses it
+    CostProfiler::reset();
+    EXPECT_TRUE(CostProfiler::report(16, CostOrder::CALLS).empty());
+    std::thread(work).join();
+    const auto report = CostProfiler::report(16, CostOrder::CALLS);
+    const auto *cost = Find(report, evaluator.getPlanId());
+    ASSERT_NE(cost, nullptr);
+    EXPECT_EQ(cost->calls, 10u);
+  }
+
+  TEST_F(CostProfilerTest, DisabledRecordsNothing) {
+    CostProfiler::setEnabled(false);
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator evaluator;
+    evaluator.initialize(Chain(1));
+    evaluator.evaluate(keys);
+    const auto report = CostProfiler::report(16, CostOrder::CALLS);
+    EXPECT_EQ(Find(report, evaluator.getPlanId()), nullptr);
+  }
+
+} // namespace
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  // ---------- Tests ----------
+
+  TEST(Evaluator_PlanId, EachInitializeProducesNewId) {
+    Evaluator evaluator;
+    EXPECT_EQ(evaluator.getPlanId(), 0u);
+
+    FilterCondition cond{
+        {SE(UE(ComparisonOperations::EQUAL, "a", static_cast<int64_t>(1)))}};
+    evaluator.initialize(cond);
+    const auto first = evaluator.getPlanId();
+    EXPECT_NE(first, 0u);
+
+    // Re-initializing swaps the plan and gets a fresh ID
+    evaluator.initialize(cond);
+    EXPECT_NE(evaluator.getPlanId(), first);
+
+    Evaluator other;
+    other.initialize(cond);
+    EXPECT_NE(other.getPlanId(), evaluator.getPlanId());
+  }
+
+  TEST(Evaluator_PlanId, EvaluateUsesSwappedPlan) {
+    std::vector<Key> keys{Key("a", static_cast<int64_t>(1))};
+    Evaluator evaluator;
+    evaluator.initialize(FilterCondition{
+        {SE(UE(ComparisonOperations::EQUAL, "a", static_cast<int64_t>(1)))}});
+    EXPECT_TRUE(evaluator.evaluate(keys));
+    evaluator.initialize(FilterCondition{
+        {SE(UE(ComparisonOperations::EQUAL, "a", static_cast<int64_t>(2)))}});
+    EXPECT_FALSE(evaluator.evaluate(keys));
+  }
+
+} // namespace
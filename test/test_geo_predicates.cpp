@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "geo.h"
+#include "key.h"
+#include "parser.h"
+
+namespace {
+
+  SubExpression SE(GeoExpression ge,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ge)}, prev};
+  }
+
+  FilterCondition Within(GeoRegionSpec region) {
+    return {{SE(GeoExpression{"lat", "lon", std::move(region)})}};
+  }
+
+  std::vector<Key> At(double lat, double lon) {
+    return {Key("lat", lat), Key("lon", lon)};
+  }
+
+  bool Eval(const FilterCondition &cond, const std::vector<Key> &keys) {
+    return LanguageParser::parse(cond)(keys);
+  }
+
+  GeoBox Box(double south, double west, double north, double east) {
+    return GeoBox{{south, west}, {north, east}};
+  }
+
+  std::vector<GeoPoint> Square(double lat, double lon, double size) {
+    return {{lat, lon}, {lat, lon + size}, {lat + size, lon + size}, {lat + size, lon}};
+  }
+
+  // ---------- Tests ----------
+
+  TEST(GeoPredicates_Box, InclusiveEdgesAndAntimeridian) {
+    const auto france = Within(Box(41.0, -5.0, 51.0, 9.5));
+    EXPECT_TRUE(Eval(france, At(48.85, 2.35)));
+    EXPECT_TRUE(Eval(france, At(41.0, 9.5)));
+    EXPECT_FALSE(Eval(france, At(51.5, -0.12)));
+
+    const auto fiji = Within(Box(-20.0, 175.0, -15.0, -178.0)); // crosses 180
+    EXPECT_TRUE(Eval(fiji, At(-18.0, 178.4)));
+    EXPECT_TRUE(Eval(fiji, At(-18.0, -179.0)));
+    EXPECT_FALSE(Eval(fiji, At(-18.0, 0.0)));
+  }
+
+  TEST(GeoPredicates_Circle, HaversineDistance) {
+    // Paris - London is about 343.5 km
+    const GeoPoint paris{48.8566, 2.3522};
+    EXPECT_TRUE(Eval(Within(GeoCircle{paris, 350000.0}), At(51.5074, -0.1278)));
+    EXPECT_FALSE(Eval(Within(GeoCircle{paris, 340000.0}), At(51.5074, -0.1278)));
+    EXPECT_TRUE(Eval(Within(GeoCircle{paris, 0.0}), At(paris.lat, paris.lon)));
+
+    // Across the antimeridian (about 22 km) and over the pole
+    EXPECT_TRUE(Eval(Within(GeoCircle{{0.0, 179.9}, 50000.0}), At(0.0, -179.9)));
+    EXPECT_TRUE(Eval(Within(GeoCircle{{89.5, 0.0}, 100000.0}), At(89.9, 180.0)));
+    EXPECT_FALSE(Eval(Within(GeoCircle{{89.5, 0.0}, 100000.0}), At(88.0, 180.0)));
+  }
+
+  TEST(GeoPredicates_Polygon, ConcaveRing) {
+    // An L shape: the notch at (1.5, 1.5) is outside
+    const GeoPolygons l_shape{{{{0, 0}, {0, 2}, {1, 2}, {1, 1}, {2, 1}, {2, 0}}}};
+    EXPECT_TRUE(Eval(Within(l_shape), At(0.5, 1.5)));
+    EXPECT_TRUE(Eval(Within(l_shape), At(1.5, 0.5)));
+    EXPECT_FALSE(Eval(Within(l_shape), At(1.5, 1.5)));
+    EXPECT_FALSE(Eval(Within(l_shape), At(-0.5, 0.5)));
+  }
+
+  TEST(GeoPredicates_Polygon, GridIndexAgreesWithRingByRing) {
+    GeoPolygons many;
+    for (int i = 0; i < 40; ++i) {
+      many.rings.push_back(Square(-30.0 + (i * 7) % 60, -60.0 + (i * 13) % 120, 3.0 + i % 4));
+    }
+    const auto grid = LanguageParser::parse(Within(many));
+    std::vector<KeyPredicate> singles;
+    for (const auto &ring : many.rings) singles.push_back(LanguageParser::parse(Within(GeoPolygons{{ring}})));
+
+    for (int i = 0; i < 2000; ++i) {
+      const double lat = -40.0 + (i * 37 % 800) / 10.0;
+      const double lon = -70.0 + (i * 91 % 1400) / 10.0;
+      bool expected = false;
+      for (const auto &single : singles) expected |= single(At(lat, lon));
+      EXPECT_EQ(grid(At(lat, lon)), expected) << lat << ", " << lon;
+    }
+  }
+
+  TEST(GeoPredicates_Keys, CoordinateTypes) {
+    const auto box = Within(Box(10.0, 10.0, 20.0, 20.0));
+    EXPECT_TRUE(Eval(box, {Key("lat", static_cast<int64_t>(15)), Key("lon", 15.5)}));
+    EXPECT_TRUE(Eval(box, {Key::text("lat", "12.5"), Key::text("lon", "19")}));
+    EXPECT_THROW(Eval(box, {Key("lat", std::string("x")), Key("lon", 15.0)}), ParseException);
+    EXPECT_THROW(Eval(box, {Key("lat", 15.0)}), ParseException);
+
+    // Nested paths work like any other key
+    const FilterCondition nested{{SE(GeoExpression{"pos.lat", "pos.lon", Box(10.0, 10.0, 20.0, 20.0)})}};
+    EXPECT_TRUE(Eval(nested, {Key::object("pos", {Key("lat", 11.0), Key("lon", 12.0)})}));
+  }
+
+  TEST(GeoPredicates_Errors, InvalidRegions) {
+    EXPECT_THROW(LanguageParser::parse(Within(Box(20.0, 0.0, 10.0, 5.0))), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Within(Box(0.0, 0.0, 95.0, 5.0))), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Within(GeoCircle{{0.0, 0.0}, -1.0})), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Within(GeoCircle{{0.0, 200.0}, 1.0})), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Within(GeoPolygons{})), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Within(GeoPolygons{{{{0, 0}, {1, 1}}}})), ParseException);
+
+    // The batch path builds regions in initialize, including threshold children
+    BatchEvaluator evaluator;
+    EXPECT_THROW(evaluator.initialize(Within(GeoPolygons{})), ParseException);
+    const FilterCondition nested{
+        {SubExpression{ThresholdExpression{1, {Within(GeoCircle{{0.0, 0.0}, -1.0})}}, LogicalOperations::NONE}}};
+    EXPECT_THROW(evaluator.initialize(nested), ParseException);
+  }
+
+  TEST(GeoPredicates_Batch, MatchesRowPath) {
+    std::vector<double> lat, lon;
+    std::vector<int64_t> lat_int;
+    for (int i = 0; i < 500; ++i) {
+      lat.push_back(-80.0 + (i * 37 % 1600) / 10.0);
+      lon.push_back(-180.0 + (i * 91 % 3600) / 10.0);
+      lat_int.push_back(static_cast<int64_t>(lat.back()));
+    }
+    const uint8_t validity[] = {0xff, 0xfe}; // row 8 is null
+    ColumnView lat_column = ColumnView::ofDouble(lat.data(), 16);
+    lat_column.validity = validity;
+    const auto n = static_cast<int64_t>(lat.size());
+
+    GeoPolygons polygons;
+    for (int i = 0; i < 12; ++i) polygons.rings.push_back(Square(-60.0 + i * 10, -150.0 + i * 25, 8.0));
+    const std::vector<GeoRegionSpec> regions{Box(-10.0, -20.0, 30.0, 40.0), Box(-50.0, 150.0, 50.0, -150.0),
+                                             GeoCircle{{10.0, 170.0}, 3000000.0}, polygons};
+    for (std::size_t r = 0; r < regions.size(); ++r) {
+      ColumnBatch batch;
+      batch.addColumn("lat", ColumnView::ofDouble(lat.data(), n));
+      batch.addColumn("lon", ColumnView::ofDouble(lon.data(), n));
+      batch.addColumn("lat_int", ColumnView::ofInt64(lat_int.data(), n));
+
+      BatchEvaluator evaluator;
+      evaluator.initialize(Within(regions[r]));
+      std::vector<uint8_t> mask;
+      evaluator.evaluate(batch, mask);
+      evaluator.initialize({{SE(GeoExpression{"lat_int", "lon", regions[r]})}});
+      std::vector<uint8_t> int_mask;
+      evaluator.evaluate(batch, int_mask);
+
+      const auto reference = LanguageParser::parse(Within(regions[r]));
+      for (int64_t i = 0; i < n; ++i) {
+        EXPECT_EQ(mask[i] != 0, reference(At(lat[i], lon[i]))) << "region " << r << " row " << i;
+        EXPECT_EQ(int_mask[i] != 0, reference(At(static_cast<double>(lat_int[i]), lon[i])))
+            << "region " << r << " row " << i;
+      }
+    }
+
+    ColumnBatch with_nulls;
+    with_nulls.addColumn("lat", lat_column);
+    with_nulls.addColumn("lon", ColumnView::ofDouble(lon.data(), 16));
+    BatchEvaluator evaluator;
+    evaluator.initialize(Within(Box(-90.0, -180.0, 90.0, 180.0)));
+    const auto selected = evaluator.select(with_nulls);
+    EXPECT_EQ(selected.size(), 15u);
+    EXPECT_EQ(std::count(selected.begin(), selected.end(), 8u), 0);
+  }
+
+  TEST(GeoPredicates_Stats, FingerprintCoversRegion) {
+    EXPECT_NE(conditionFingerprint(Within(GeoCircle{{1.0, 2.0}, 10.0})),
+              conditionFingerprint(Within(GeoCircle{{1.0, 2.0}, 11.0})));
+    EXPECT_NE(conditionFingerprint(Within(Box(0, 0, 1, 1))),
+              conditionFingerprint(Within(Box(0, 0, 1, 2))));
+  }
+
+} // namespace
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "ip_address.h"
+#include "key.h"
+#include "parser.h"
+#include "struct_binding.h"
+
+struct Connection {
+  IpAddress peer;
+  int64_t port;
+};
+EXPR_EVAL_STRUCT(Connection, EXPR_EVAL_FIELD(peer), EXPR_EVAL_FIELD(port));
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  CidrExpression CE(ComparisonOperations op, std::string key,
+                    const std::vector<std::string> &networks) {
+    CidrExpression expr{std::move(key), op, {}};
+    for (const auto &n : networks) expr.networks.push_back(Cidr::fromString(n));
+    return expr;
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(CidrExpression ce,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ce)}, prev};
+  }
+
+  IpAddress IP(const std::string &text) { return IpAddress::fromString(text); }
+
+  bool Eval(const FilterCondition &cond, const std::vector<Key> &keys) {
+    return LanguageParser::parse(cond)(keys);
+  }
+
+  // ---------- Tests ----------
+
+  TEST(IpAddress_Parse, V4AndV6) {
+    EXPECT_EQ(IP("10.1.2.3"), IpAddress::v4(0x0A010203));
+    EXPECT_EQ(IP("::1"), IpAddress::v6(0, 1));
+    EXPECT_EQ(IP("2001:db8::8:800:200c:417a"),
+              IpAddress::v6(0x20010db800000000ull, 0x00080800200c417aull));
+    EXPECT_EQ(IP("::ffff:192.0.2.1"), IpAddress::v6(0, 0x0000ffffc0000201ull));
+    EXPECT_EQ(IP("1:2:3:4:5:6:7:8"), IpAddress::v6(0x0001000200030004ull, 0x0005000600070008ull));
+
+    IpAddress out;
+    for (const char *bad : {"", "1.2.3", "1.2.3.4.5", "256.1.1.1", "01.2.3.4", "1.2.3.4 ",
+                            ":::", "1::2::3", "1:2:3:4:5:6:7:8:9", "12345::", "g::1",
+                            "1:2:3:4:5:6:7", "::1.2.3"}) {
+      EXPECT_FALSE(IpAddress::parse(bad, out)) << bad;
+    }
+    EXPECT_THROW(IpAddress::fromString("nope"), ParseException);
+  }
+
+  TEST(IpAddress_Format, RoundTrips) {
+    for (const char *text : {"0.0.0.0", "192.168.0.255", "::", "::1", "1::",
+                             "2001:db8::1", "1:0:0:2::3", "fe80::1:0:0:1"}) {
+      EXPECT_EQ(IP(text).str(), text);
+    }
+    EXPECT_EQ(IP("1:0:0:0:0:0:0:8").str(), "1::8");
+  }
+
+  TEST(IpAddress_Order, FamilyThenValue) {
+    EXPECT_LT(IP("255.255.255.255"), IP("::"));
+    EXPECT_LT(IP("10.0.0.1"), IP("10.0.0.2"));
+    EXPECT_NE(IP("192.0.2.1"), IP("::ffff:192.0.2.1"));
+  }
+
+  TEST(Cidr_Parse, NormalizesAndBounds) {
+    const Cidr c = Cidr::fromString("10.1.2.3/8");
+    EXPECT_EQ(c.str(), "10.0.0.0/8");
+    EXPECT_EQ(c.last(), IP("10.255.255.255"));
+    EXPECT_TRUE(c.contains(IP("10.200.0.1")));
+    EXPECT_FALSE(c.contains(IP("11.0.0.0")));
+    EXPECT_FALSE(c.contains(IP("::a00:1")));
+
+    EXPECT_EQ(Cidr::fromString("2001:db8::1/32").last(), IP("2001:db8:ffff:ffff:ffff:ffff:ffff:ffff"));
+    EXPECT_EQ(Cidr::fromString("1.2.3.4").prefix(), 32u);
+    EXPECT_TRUE(Cidr::fromString("0.0.0.0/0").contains(IP("8.8.8.8")));
+    EXPECT_TRUE(Cidr::fromString("::/0").contains(IP("ffff::")));
+
+    Cidr out;
+    EXPECT_FALSE(Cidr::parse("10.0.0.0/33", out));
+    EXPECT_FALSE(Cidr::parse("::/129", out));
+    EXPECT_FALSE(Cidr::parse("10.0.0.0/", out));
+    EXPECT_THROW(Cidr(IP("10.0.0.0"), 40), ParseException);
+  }
+
+  TEST(IpAddress_Predicates, UnaryComparisonsAndText) {
+    const std::vector<Key> keys{Key("src", IP("10.0.0.5")), Key::text("dst", "2001:db8::7")};
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::EQUAL, "src", IP("10.0.0.5")))}}, keys));
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::GREATER_THAN, "dst", IP("2001:db8::1")))}}, keys));
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "src", std::string("10.0.0.5")))}}, keys),
+                 ParseException);
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "dst", IP("::1")))}},
+                      {Key::text("dst", "not-an-ip")}),
+                 ParseException);
+  }
+
+  TEST(IpAddress_Predicates, CidrMembership) {
+    const FilterCondition internal{{SE(CE(ComparisonOperations::EQUAL, "ip",
+                                          {"10.0.0.0/8", "192.168.0.0/16", "fd00::/8"}))}};
+    EXPECT_TRUE(Eval(internal, {Key("ip", IP("10.9.8.7"))}));
+    EXPECT_TRUE(Eval(internal, {Key("ip", IP("fd12::1"))}));
+    EXPECT_TRUE(Eval(internal, {Key::text("ip", "192.168.4.4")}));
+    EXPECT_FALSE(Eval(internal, {Key("ip", IP("8.8.8.8"))}));
+
+    const FilterCondition external{{SE(CE(ComparisonOperations::NOT_EQUAL, "ip", {"10.0.0.0/8"}))}};
+    EXPECT_TRUE(Eval(external, {Key("ip", IP("8.8.8.8"))}));
+    EXPECT_FALSE(Eval(external, {Key("ip", IP("10.0.0.1"))}));
+
+    EXPECT_THROW(Eval(internal, {Key("ip", static_cast<int64_t>(1))}), ParseException);
+    EXPECT_THROW(LanguageParser::parse({{SE(CE(ComparisonOperations::LESS_THAN, "ip", {"10.0.0.0/8"}))}}),
+                 ParseException);
+    EXPECT_THROW(LanguageParser::parse({{SE(CE(ComparisonOperations::EQUAL, "ip", {}))}}), ParseException);
+
+    // The batch path builds its network set in initialize
+    BatchEvaluator evaluator;
+    EXPECT_THROW(evaluator.initialize({{SE(CE(ComparisonOperations::LESS_THAN, "ip", {"10.0.0.0/8"}))}}),
+                 ParseException);
+    EXPECT_THROW(evaluator.initialize({{SE(CE(ComparisonOperations::EQUAL, "ip", {}))}}), ParseException);
+  }
+
+  TEST(IpAddress_Predicates, RangeTableAgreesWithLinearScan) {
+    // Overlapping, adjacent and nested networks of both families, enough to
+    // switch to the range table
+    std::vector<std::string> networks{"10.0.0.0/8", "10.1.0.0/16", "11.0.0.0/8", "0.0.0.0/32",
+                                      "255.255.255.255/32", "172.16.0.0/12", "192.168.1.0/24",
+                                      "192.168.2.0/24", "100.64.0.0/10", "2001:db8::/32",
+                                      "2001:db9::/32", "fe80::/10", "::/128",
+                                      "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff/128", "fc00::/7",
+                                      "2002::/16", "64:ff9b::/96", "100::/64", "2001::/32"};
+    CidrExpression expr = CE(ComparisonOperations::EQUAL, "ip", networks);
+    const auto predicate = LanguageParser::parse({{SE(expr)}});
+
+    std::vector<IpAddress> probes{IP("0.0.0.0"), IP("0.0.0.1"), IP("9.255.255.255"),
+                                  IP("10.0.0.0"), IP("11.255.255.255"), IP("12.0.0.0"),
+                                  IP("172.31.255.255"), IP("172.32.0.0"), IP("192.168.0.255"),
+                                  IP("192.168.2.9"), IP("192.168.3.0"), IP("255.255.255.254"),
+                                  IP("255.255.255.255"), IP("::"), IP("::1"), IP("2001:db8::1"),
+                                  IP("2001:dba::"), IP("fe80::1"), IP("fec0::"), IP("fdff::"),
+                                  IP("ffff:ffff:ffff:ffff:ffff:ffff:ffff:fffe"),
+                                  IP("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff"), IP("64:ff9b::1.2.3.4"),
+                                  IP("100::ffff:ffff:ffff:ffff"), IP("100:0:0:1::")};
+    for (const auto &address : probes) {
+      bool expected = false;
+      for (const auto &cidr : expr.networks) expected |= cidr.contains(address);
+      EXPECT_EQ(predicate({Key("ip", address)}), expected) << address.str();
+    }
+  }
+
+  TEST(IpAddress_Struct, AddressFields) {
+    StructEvaluator<Connection> evaluator;
+    evaluator.initialize({{SE(UE(ComparisonOperations::GREATER_EQUAL, "peer", IP("10.0.0.0"))),
+                           SE(UE(ComparisonOperations::EQUAL, "port", static_cast<int64_t>(22)),
+                              LogicalOperations::AND)}});
+    EXPECT_TRUE(evaluator.evaluate(Connection{IP("10.0.0.9"), 22}));
+    EXPECT_FALSE(evaluator.evaluate(Connection{IP("9.0.0.9"), 22}));
+    EXPECT_THROW(evaluator.initialize({{SE(CE(ComparisonOperations::EQUAL, "peer", {"10.0.0.0/8"}))}}),
+                 ParseException);
+  }
+
+  TEST(IpAddress_Batch, AddressColumnsMatchRowPath) {
+    const std::vector<IpAddress> v4{IP("10.0.0.1"), IP("8.8.8.8"), IP("192.168.1.7"), IP("10.255.0.0")};
+    const std::vector<IpAddress> v6{IP("2001:db8::1"), IP("::1"), IP("fd00::9"), IP("2001:db9::")};
+    std::vector<uint8_t> v4_bytes, v6_bytes;
+    for (const auto &a : v4) {
+      for (int s = 24; s >= 0; s -= 8) v4_bytes.push_back(static_cast<uint8_t>(a.v4Bits() >> s));
+    }
+    for (const auto &a : v6) {
+      for (int s = 56; s >= 0; s -= 8) v6_bytes.push_back(static_cast<uint8_t>(a.high() >> s));
+      for (int s = 56; s >= 0; s -= 8) v6_bytes.push_back(static_cast<uint8_t>(a.low() >> s));
+    }
+    ColumnBatch batch;
+    batch.addColumn("a4", ColumnView::ofIpv4(v4_bytes.data(), 4));
+    batch.addColumn("a6", ColumnView::ofIpv6(v6_bytes.data(), 4));
+    ASSERT_EQ(batch.find("a6")->ipAt(0), v6[0]);
+
+    std::vector<std::string> many; // range table for IPv4
+    for (int i = 0; i < 12; ++i) many.push_back("10." + std::to_string(i * 20) + ".0.0/14");
+    const std::vector<FilterCondition> conditions{
+        {{SE(CE(ComparisonOperations::EQUAL, "a4", {"10.0.0.0/8", "192.168.0.0/16"}))}},
+        {{SE(CE(ComparisonOperations::NOT_EQUAL, "a4", many))}},
+        {{SE(CE(ComparisonOperations::EQUAL, "a6", {"2001:db8::/32", "fc00::/7"}))}},
+        {{SE(UE(ComparisonOperations::LESS_THAN, "a4", IP("10.128.0.0")))}},
+        {{SE(UE(ComparisonOperations::NOT_EQUAL, "a6", IP("::1")))}},
+        {{SE(UE(ComparisonOperations::EQUAL, "a6", IP("10.0.0.1")))}}};
+    for (std::size_t c = 0; c < conditions.size(); ++c) {
+      BatchEvaluator evaluator;
+      evaluator.initialize(conditions[c]);
+      std::vector<uint8_t> mask;
+      evaluator.evaluate(batch, mask);
+      const auto reference = LanguageParser::parse(conditions[c]);
+      for (int64_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(mask[i] != 0, reference({Key("a4", v4[i]), Key("a6", v6[i])}))
+            << "condition " << c << " row " << i;
+      }
+    }
+
+    // Arrow fixed-size binary import
+    const void *buffers[] = {nullptr, v6_bytes.data()};
+    ArrowArray array{4, 0, 0, 2, 0, buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema schema{"w:16", "a6", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    ColumnBatch imported;
+    imported.addArrowColumn("a6", array, schema);
+    EXPECT_EQ(imported.find("a6")->ipAt(2), v6[2]);
+  }
+
+  TEST(IpAddress_Stats, FingerprintCoversNetworks) {
+    const FilterCondition a{{SE(CE(ComparisonOperations::EQUAL, "ip", {"10.0.0.0/8"}))}};
+    const FilterCondition b{{SE(CE(ComparisonOperations::EQUAL, "ip", {"10.0.0.0/9"}))}};
+    EXPECT_NE(conditionFingerprint(a), conditionFingerprint(b));
+  }
+
+} // namespace
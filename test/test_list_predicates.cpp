@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  ListExpression LE(ListQuantifier q, std::string key, ComparisonOperations op,
+                    std::vector<ValueType> values) {
+    return ListExpression{q, std::move(key), op, std::move(values)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(ListExpression le,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(le)}, prev};
+  }
+
+  bool Eval(const FilterCondition &cond, const std::vector<Key> &keys) {
+    return LanguageParser::parse(cond)(keys);
+  }
+
+  std::vector<ValueType> Ints(std::initializer_list<int64_t> values) {
+    return {values.begin(), values.end()};
+  }
+
+  std::vector<ValueType> Range(int64_t begin, int64_t end) {
+    std::vector<ValueType> values;
+    for (int64_t v = begin; v < end; ++v) values.emplace_back(v);
+    return values;
+  }
+
+  // The same values as a packed array and as a generic Key::list
+  std::vector<std::vector<Key>> BothForms(const std::vector<int64_t> &values) {
+    std::vector<ValueType> generic(values.begin(), values.end());
+    return {{Key::array("ids", values)}, {Key::list("ids", generic)}};
+  }
+
+  // ---------- Tests ----------
+
+  TEST(ListPredicates_Key, ArrayKey) {
+    const Key key = Key::array("tags", std::vector<std::string>{"a", "b"});
+    EXPECT_TRUE(key.isArray());
+    EXPECT_FALSE(key.isScalar());
+    EXPECT_TRUE(key.children().empty());
+    ASSERT_NE(key.array(), nullptr);
+    EXPECT_EQ(std::get<std::vector<std::string>>(*key.array()).size(), 2u);
+    EXPECT_EQ(Key("x", static_cast<int64_t>(1)).array(), nullptr);
+
+    // Array elements are not addressable by path
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "tags.0",
+                               std::string("a")))}},
+                      {key}),
+                 ParseException);
+  }
+
+  TEST(ListPredicates_Quantifiers, AnyAllContains) {
+    for (const auto &keys : BothForms({4, 8, 15, 16, 23, 42})) {
+      EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ANY, "ids",
+                               ComparisonOperations::EQUAL, Ints({1, 15})))}},
+                       keys));
+      EXPECT_FALSE(Eval({{SE(LE(ListQuantifier::ANY, "ids",
+                                ComparisonOperations::EQUAL, Ints({1, 2})))}},
+                        keys));
+      EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ALL, "ids",
+                               ComparisonOperations::GREATER_THAN, Ints({3})))}},
+                       keys));
+      EXPECT_FALSE(Eval({{SE(LE(ListQuantifier::ALL, "ids",
+                                ComparisonOperations::LESS_THAN, Ints({42})))}},
+                        keys));
+      EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ALL, "ids",
+                               ComparisonOperations::NOT_EQUAL, Ints({5, 7})))}},
+                       keys));
+      EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::CONTAINS, "ids",
+                               ComparisonOperations::EQUAL, Ints({42, 4})))}},
+                       keys));
+      EXPECT_FALSE(Eval({{SE(LE(ListQuantifier::CONTAINS, "ids",
+                                ComparisonOperations::EQUAL, Ints({42, 5})))}},
+                        keys));
+    }
+  }
+
+  TEST(ListPredicates_Quantifiers, EmptyList) {
+    for (const auto &keys : BothForms({})) {
+      EXPECT_FALSE(Eval({{SE(LE(ListQuantifier::ANY, "ids",
+                                ComparisonOperations::EQUAL, Ints({1})))}},
+                        keys));
+      EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ALL, "ids",
+                               ComparisonOperations::EQUAL, Ints({1})))}},
+                       keys));
+      EXPECT_FALSE(Eval({{SE(LE(ListQuantifier::CONTAINS, "ids",
+                                ComparisonOperations::EQUAL, Ints({1})))}},
+                        keys));
+    }
+  }
+
+  TEST(ListPredicates_Strategies, ScanAndHashAgreeWithGenericLists) {
+    // Arrays and constant sets on both sides of the scan / hash limits
+    const std::vector<std::size_t> array_sizes{0, 5, 31, 33, 100};
+    const std::vector<std::vector<ValueType>> sets{
+        Ints({3}), Range(0, 4), Range(0, 6), Range(10, 27), Range(0, 40)};
+    for (std::size_t n : array_sizes) {
+      std::vector<int64_t> values;
+      for (std::size_t i = 0; i < n; ++i) values.push_back(static_cast<int64_t>(i * 7 % 53));
+      const auto forms = BothForms(values);
+      for (const auto &set : sets) {
+        for (auto q : {ListQuantifier::ANY, ListQuantifier::ALL, ListQuantifier::CONTAINS}) {
+          for (auto op : {ComparisonOperations::EQUAL, ComparisonOperations::NOT_EQUAL}) {
+            const FilterCondition cond{{SE(LE(q, "ids", op, set))}};
+            EXPECT_EQ(Eval(cond, forms[0]), Eval(cond, forms[1]))
+                << "n=" << n << " set=" << set.size() << " q=" << static_cast<int>(q)
+                << " op=" << static_cast<int>(op);
+          }
+        }
+      }
+    }
+  }
+
+  TEST(ListPredicates_Strategies, StringsAndDoubles) {
+    const std::vector<Key> keys{
+        Key::array("tags", std::vector<std::string>{"red", "green", "blue"}),
+        Key::array("scores", std::vector<double>{0.5, 1.5, 2.5})};
+    std::vector<ValueType> many; // above the string scan limit: hashed
+    for (const char *s : {"a", "b", "c", "d", "e", "f", "blue"}) many.emplace_back(std::string(s));
+
+    EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ANY, "tags",
+                             ComparisonOperations::EQUAL, many))}},
+                     keys));
+    EXPECT_FALSE(Eval({{SE(LE(ListQuantifier::ALL, "tags",
+                              ComparisonOperations::EQUAL, many))}},
+                      keys));
+    EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::CONTAINS, "tags",
+                             ComparisonOperations::EQUAL,
+                             {std::string("blue"), std::string("red")}))}},
+                     keys));
+    EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ALL, "scores",
+                             ComparisonOperations::LESS_EQUAL, {2.5}))}},
+                     keys));
+    EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ANY, "tags",
+                             ComparisonOperations::GREATER_THAN,
+                             {std::string("orange")}))}},
+                     keys));
+  }
+
+  TEST(ListPredicates_Combine, ReplacesOrChains) {
+    const FilterCondition cond{
+        {SE(UE(ComparisonOperations::EQUAL, "kind", std::string("alert"))),
+         SE(LE(ListQuantifier::ANY, "labels", ComparisonOperations::EQUAL,
+               {std::string("sev1"), std::string("sev2")}),
+            LogicalOperations::AND)}};
+    EXPECT_TRUE(Eval(cond, {Key("kind", std::string("alert")),
+                            Key::array("labels", std::vector<std::string>{"db", "sev2"})}));
+    EXPECT_FALSE(Eval(cond, {Key("kind", std::string("alert")),
+                             Key::array("labels", std::vector<std::string>{"db"})}));
+    // Short-circuited: the list is never looked up
+    EXPECT_FALSE(Eval(cond, {Key("kind", std::string("info"))}));
+  }
+
+  TEST(ListPredicates_Generic, TextAndBoolElements) {
+    const std::vector<Key> keys{
+        Key::list("ports", {Key::text("", "80"), Key::text("", "443")}),
+        Key::list("flags", std::vector<ValueType>{true, true})};
+    EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ANY, "ports",
+                             ComparisonOperations::EQUAL, Ints({443})))}},
+                     keys));
+    EXPECT_TRUE(Eval({{SE(LE(ListQuantifier::ALL, "flags",
+                             ComparisonOperations::EQUAL, {true}))}},
+                     keys));
+  }
+
+  TEST(ListPredicates_Errors, CompileAndRuntimeErrors) {
+    auto compile = [](ListExpression le) {
+      return LanguageParser::parse({{SE(std::move(le))}});
+    };
+    EXPECT_THROW(compile(LE(ListQuantifier::ANY, "ids", ComparisonOperations::EQUAL, {})),
+                 ParseException);
+    EXPECT_THROW(compile(LE(ListQuantifier::ANY, "ids", ComparisonOperations::LESS_THAN,
+                            Ints({1, 2}))),
+                 ParseException);
+    EXPECT_THROW(compile(LE(ListQuantifier::ANY, "ids", ComparisonOperations::EQUAL,
+                            {static_cast<int64_t>(1), 2.0})),
+                 ParseException);
+    EXPECT_THROW(compile(LE(ListQuantifier::ALL, "ids", ComparisonOperations::LESS_THAN,
+                            {true})),
+                 ParseException);
+
+    const auto any_one = compile(LE(ListQuantifier::ANY, "ids", ComparisonOperations::EQUAL,
+                                    Ints({1})));
+    EXPECT_THROW(any_one({Key::array("ids", std::vector<double>{1.0})}), ParseException);
+    EXPECT_THROW(any_one({Key("ids", static_cast<int64_t>(1))}), ParseException);
+    EXPECT_THROW(any_one({Key("other", static_cast<int64_t>(1))}), ParseException);
+    EXPECT_THROW(any_one({Key::list("ids", {Key::object("", {})})}), ParseException);
+  }
+
+  TEST(ListPredicates_OtherPaths, FingerprintAndUnsupportedPaths) {
+    const FilterCondition any{{SE(LE(ListQuantifier::ANY, "ids",
+                                     ComparisonOperations::EQUAL, Ints({1})))}};
+    const FilterCondition all{{SE(LE(ListQuantifier::ALL, "ids",
+                                     ComparisonOperations::EQUAL, Ints({1})))}};
+    EXPECT_NE(conditionFingerprint(any), conditionFingerprint(all));
+    EXPECT_EQ(conditionFingerprint(any), conditionFingerprint(any));
+
+    BatchEvaluator evaluator;
+    evaluator.initialize(any);
+    std::vector<uint8_t> mask;
+    EXPECT_THROW(evaluator.evaluate(ColumnBatch(), mask), ParseException);
+  }
+
+} // namespace
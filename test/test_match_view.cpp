@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "match_view.h"
+#include "parser.h"
+#include "scan.h"
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  SubExpression Gt(std::string key, int64_t v, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::GREATER_THAN, std::move(key), v}, prev);
+  }
+
+  // Record i: {"id": i, "user": {"name": "u<i>"}}, plus "extra" on even ids
+  std::vector<std::vector<Key>> MakeRecords(int64_t n) {
+    std::vector<std::vector<Key>> records;
+    for (int64_t i = 0; i < n; ++i) {
+      std::vector<Key> keys{Key("id", i), Key::object("user", {Key("name", "u" + std::to_string(i))})};
+      if (i % 2 == 0) keys.emplace_back("extra", i * 10);
+      records.push_back(std::move(keys));
+    }
+    return records;
+  }
+
+  int64_t Id(const std::vector<Key> &keys) { return std::get<int64_t>(keys[0].getValue()); }
+
+  // ---------- Tests ----------
+
+  TEST(MatchView_Records, ViewsPointIntoSource) {
+    const auto records = MakeRecords(10);
+    const RecordMatches matches = matchRecords(LanguageParser::parse({{Gt("id", 5)}}), records);
+    ASSERT_EQ(matches.size(), 4u);
+    EXPECT_EQ(matches.indices(), (std::vector<std::size_t>{6, 7, 8, 9}));
+    EXPECT_EQ(&matches[0], &records[6]); // no copy
+
+    const std::vector<const Key *> extra = matches.project("extra");
+    ASSERT_EQ(extra.size(), 4u);
+    EXPECT_EQ(extra[0], &records[6][2]);
+    EXPECT_EQ(extra[1], nullptr); // odd ids have no "extra"
+    EXPECT_EQ(std::get<int64_t>(extra[2]->getValue()), 80);
+
+    const std::vector<const Key *> names = matches.project("user.name");
+    EXPECT_EQ(std::get<std::string>(names[3]->getValue()), "u9");
+
+    const auto copies = matches.materialize();
+    ASSERT_EQ(copies.size(), 4u);
+    EXPECT_EQ(Id(copies[1]), 7);
+  }
+
+  TEST(MatchView_Records, LimitAndThreads) {
+    const auto records = MakeRecords(5000);
+    ScanOptions options;
+    options.limit = 3;
+    options.threads = 4;
+    const RecordMatches matches = matchRecords(LanguageParser::parse({{Gt("id", 100)}}), records, options);
+    EXPECT_EQ(matches.indices(), (std::vector<std::size_t>{101, 102, 103}));
+    EXPECT_TRUE(matchRecords(LanguageParser::parse({{Gt("id", 5000)}}), records).empty());
+  }
+
+  TEST(MatchView_Partition, MatchesFrontInOrder) {
+    auto records = MakeRecords(20);
+    const FilterCondition ends{{Gt("id", 14),
+                                SE(UnaryExpression{ComparisonOperations::LESS_THAN, "id", int64_t{3}},
+                                   LogicalOperations::OR)}};
+    const auto predicate = LanguageParser::parse(ends);
+    const std::size_t kept = partitionMatches(predicate, records);
+    std::vector<int64_t> front, back;
+    for (std::size_t i = 0; i < records.size(); ++i) (i < kept ? front : back).push_back(Id(records[i]));
+    EXPECT_EQ(front, (std::vector<int64_t>{0, 1, 2, 15, 16, 17, 18, 19}));
+    std::sort(back.begin(), back.end());
+    EXPECT_EQ(back, (std::vector<int64_t>{3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14}));
+
+    std::vector<std::vector<Key>> empty;
+    EXPECT_EQ(partitionMatches(predicate, empty), 0u);
+  }
+
+  TEST(MatchView_Partition, ErrorKeepsEveryRecord) {
+    auto records = MakeRecords(6);
+    records[4] = {Key("other", int64_t{1})};
+    EXPECT_THROW(partitionMatches(LanguageParser::parse({{Gt("id", 0)}}), records), ParseException);
+    ASSERT_EQ(records.size(), 6u);
+    std::vector<std::string> first;
+    for (const auto &keys : records) first.push_back(keys[0].getName());
+    std::sort(first.begin(), first.end());
+    EXPECT_EQ(first, (std::vector<std::string>{"id", "id", "id", "id", "id", "other"}));
+  }
+
+  TEST(MatchView_Batch, ColumnsAndGather) {
+    std::vector<int64_t> id{0, 1, 2, 3, 4, 5};
+    std::vector<double> price{0.5, 1.5, 2.5, 3.5, 4.5, 5.5};
+    const uint8_t validity[] = {0b110111}; // price of row 3 is null
+    ColumnView price_column = ColumnView::ofDouble(price.data(), 6);
+    price_column.validity = validity;
+    ColumnBatch batch;
+    batch.addColumn("id", ColumnView::ofInt64(id.data(), 6));
+    batch.addColumn("price", price_column);
+
+    BatchEvaluator evaluator;
+    evaluator.initialize({{Gt("id", 1)}});
+    const BatchMatches matches = matchRows(evaluator, batch);
+    ASSERT_EQ(matches.size(), 4u);
+    EXPECT_EQ(matches.column("id").int64At(matches.row(0)), 2);
+    EXPECT_THROW(matches.column("missing"), ParseException);
+
+    ProjectedColumn prices;
+    matches.gather("price", prices);
+    EXPECT_EQ(prices.type, DataTypes::DOUBLE);
+    EXPECT_EQ(prices.doubles, (std::vector<double>{2.5, 3.5, 4.5, 5.5}));
+    ASSERT_EQ(prices.validity.size(), 1u);
+    EXPECT_EQ(prices.validity[0], 0b1101);
+
+    ProjectedColumn ids;
+    matches.gather("id", ids);
+    EXPECT_EQ(ids.ints, (std::vector<int64_t>{2, 3, 4, 5}));
+    EXPECT_TRUE(ids.validity.empty());
+  }
+
+  TEST(MatchView_Batch, GatherRejectsOtherTypes) {
+    const std::vector<int32_t> offsets{0, 1, 2};
+    const std::string data = "ab";
+    ColumnBatch batch;
+    batch.addColumn("s", ColumnView::ofStrings(offsets.data(), data.data(), 2));
+    const BatchMatches matches(batch, {0, 1});
+    ProjectedColumn out;
+    EXPECT_THROW(matches.gather("s", out), ParseException);
+    EXPECT_EQ(matches.column("s").stringAt(matches.row(1)), "b");
+  }
+
+} // namespace
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "micro_batcher.h"
+#include "parser.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "A",
+               static_cast<int64_t>(10))),
+         SE(UE(ComparisonOperations::EQUAL, "B", std::string("x")),
+            LogicalOperations::AND)}};
+  }
+
+  std::vector<Key> Record(int64_t a, const char *b) {
+    return {Key("A", a), Key("B", std::string(b))};
+  }
+
+  // ---------- Tests ----------
+
+  TEST(MicroBatch_Evaluate, MatchesParserResults) {
+    MicroBatchEvaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    auto reference = LanguageParser::parse(MakeCondition());
+    for (int64_t a : {5, 10, 11, 100}) {
+      for (const char *b : {"x", "y"}) {
+        const auto keys = Record(a, b);
+        EXPECT_EQ(evaluator.evaluate(keys), reference(keys)) << a << " " << b;
+      }
+    }
+  }
+
+  TEST(MicroBatch_Evaluate, CoalescesQueuedCalls) {
+    MicroBatchOptions options;
+    options.max_wait = std::chrono::milliseconds(200);
+    options.max_batch = 4;
+    MicroBatchEvaluator evaluator(options);
+    evaluator.initialize(MakeCondition());
+
+    std::vector<std::vector<Key>> records;
+    for (int i = 0; i < 8; ++i) records.push_back(Record(i * 3, "x"));
+    std::vector<std::future<bool>> futures;
+    for (const auto &keys : records) futures.push_back(evaluator.submit(keys));
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(futures[i].get(), i * 3 > 10);
+
+    const auto stats = evaluator.stats();
+    EXPECT_EQ(stats.records, 8u);
+    EXPECT_LE(stats.batches, 4u); // full batches close before max_wait
+    EXPECT_GE(stats.batches, 2u); // never more than max_batch per batch
+  }
+
+  TEST(MicroBatch_Evaluate, ConcurrentCallersAllComplete) {
+    MicroBatchEvaluator evaluator;
+    evaluator.initialize(MakeCondition());
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&evaluator, &mismatches, t] {
+        for (int64_t i = 0; i < 200; ++i) {
+          const auto keys = Record(i % 20, t % 2 ? "x" : "y");
+          if (evaluator.evaluate(keys) != (i % 20 > 10 && t % 2)) ++mismatches[t];
+        }
+      });
+    }
+    for (auto &th : threads) th.join();
+    for (int m : mismatches) EXPECT_EQ(m, 0);
+    EXPECT_EQ(evaluator.stats().records, 800u);
+  }
+
+  TEST(MicroBatch_Errors, ExceptionsGoToTheirOwnCaller) {
+    MicroBatchOptions options;
+    options.max_wait = std::chrono::milliseconds(100);
+    MicroBatchEvaluator evaluator(options);
+    evaluator.initialize(MakeCondition());
+    const auto good = Record(50, "x");
+    const std::vector<Key> missing{Key("A", static_cast<int64_t>(50))};
+    auto ok = evaluator.submit(good);
+    auto bad = evaluator.submit(missing);
+    EXPECT_TRUE(ok.get());
+    EXPECT_THROW(bad.get(), ParseException);
+  }
+
+  TEST(MicroBatch_Errors, UninitializedThrows) {
+    MicroBatchEvaluator evaluator;
+    const auto keys = Record(1, "x");
+    EXPECT_THROW(evaluator.evaluate(keys), std::bad_function_call);
+  }
+
+  TEST(MicroBatch_Errors, ZeroMaxBatchThrows) {
+    MicroBatchOptions options;
+    options.max_batch = 0;
+    EXPECT_THROW(MicroBatchEvaluator evaluator(options), ParseException);
+  }
+
+  TEST(MicroBatch_Lifecycle, DestructorCompletesQueuedCalls) {
+    const auto keys = Record(50, "x");
+    std::future<bool> pending;
+    {
+      MicroBatchOptions options;
+      options.max_wait = std::chrono::seconds(10);
+      MicroBatchEvaluator evaluator(options);
+      evaluator.initialize(MakeCondition());
+      pending = evaluator.submit(keys);
+    }
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_TRUE(pending.get());
+  }
+
+} // namespace
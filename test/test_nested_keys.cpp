@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "key_path.h"
+#include "parser.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  std::vector<Key> MakeEvent(const std::string &country, int64_t age) {
+    return {
+        Key("id", static_cast<int64_t>(1)),
+        Key::object("user",
+                    {Key("age", age),
+                     Key::object("geo", {Key("city", std::string("Lyon")),
+                                         Key("country", country)})}),
+        Key::list("items",
+                  {Key::object("", {Key("price", 9.5),
+                                    Key("qty", static_cast<int64_t>(2))}),
+                   Key::object("", {Key("price", 20.0),
+                                    Key("qty", static_cast<int64_t>(1))})}),
+        Key::list("scores", std::vector<ValueType>{static_cast<int64_t>(7),
+                                                   static_cast<int64_t>(3)}),
+    };
+  }
+
+  bool Eval(const FilterCondition &cond, const std::vector<Key> &keys) {
+    return LanguageParser::parse(cond)(keys);
+  }
+
+  // ---------- Tests ----------
+
+  TEST(NestedKeys_Key, ObjectsAndLists) {
+    const auto event = MakeEvent("FR", 30);
+    EXPECT_TRUE(event[1].isObject());
+    EXPECT_TRUE(event[2].isList());
+    EXPECT_TRUE(event[0].isScalar());
+    EXPECT_EQ(event[1].children().size(), 2u);
+    EXPECT_TRUE(event[0].children().empty());
+
+    Key copy = event[1]; // children are shared, not deep-copied
+    EXPECT_EQ(&copy.children(), &event[1].children());
+    copy.setValue(static_cast<int64_t>(5));
+    EXPECT_TRUE(copy.isScalar());
+  }
+
+  TEST(NestedKeys_Path, ResolvesFieldsAndPositions) {
+    const auto event = MakeEvent("FR", 30);
+    const Key *country = KeyPath("user.geo.country").find(event);
+    ASSERT_NE(country, nullptr);
+    EXPECT_EQ(std::get<std::string>(country->getValue()), "FR");
+
+    const Key *price = KeyPath("items.1.price").find(event);
+    ASSERT_NE(price, nullptr);
+    EXPECT_DOUBLE_EQ(std::get<double>(price->getValue()), 20.0);
+
+    EXPECT_EQ(KeyPath("items.2.price").find(event), nullptr); // out of range
+    EXPECT_EQ(KeyPath("user.0").find(event), nullptr); // user is not a list
+    EXPECT_EQ(KeyPath("user.geo.zip").find(event), nullptr);
+    EXPECT_EQ(KeyPath("id.x").find(event), nullptr); // id is a scalar
+  }
+
+  TEST(NestedKeys_Path, HintSurvivesReorderedRecords) {
+    const KeyPath path("user.geo.country");
+    const auto a = MakeEvent("FR", 30);
+    std::vector<Key> b{Key::object("user", {Key::object(
+                                               "geo", {Key("country", std::string("DE"))})}),
+                       Key("id", static_cast<int64_t>(2))};
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(std::get<std::string>(path.find(a)->getValue()), "FR");
+      EXPECT_EQ(std::get<std::string>(path.find(b)->getValue()), "DE");
+    }
+  }
+
+  TEST(NestedKeys_Path, FallsBackToFlattenedName) {
+    const KeyPath path("user.geo.country");
+    const std::vector<Key> flat{Key("user.geo.country", std::string("IT"))};
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_NE(path.find(flat), nullptr);
+      EXPECT_EQ(std::get<std::string>(path.find(flat)->getValue()), "IT");
+      EXPECT_EQ(std::get<std::string>(path.find(MakeEvent("FR", 1))->getValue()),
+                "FR");
+    }
+  }
+
+  TEST(NestedKeys_Path, NestedWinsOverFlattenedName) {
+    const KeyPath path("user.geo.country");
+    std::vector<Key> both = MakeEvent("FR", 1);
+    both.push_back(Key("user.geo.country", std::string("IT")));
+    const std::vector<Key> flat{Key("user.geo.country", std::string("IT"))};
+    // Same answer for the mixed record whatever was resolved before it
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_EQ(std::get<std::string>(path.find(both)->getValue()), "FR");
+      EXPECT_EQ(std::get<std::string>(path.find(flat)->getValue()), "IT");
+    }
+  }
+
+  TEST(NestedKeys_Evaluate, ConditionsOnPaths) {
+    FilterCondition cond{
+        {SE(UE(ComparisonOperations::EQUAL, "user.geo.country",
+               std::string("FR"))),
+         SE(UE(ComparisonOperations::GREATER_EQUAL, "user.age",
+               static_cast<int64_t>(18)),
+            LogicalOperations::AND),
+         SE(BE("items.0.price", ArithmeticOperations::MULTIPLY, "items.0.qty",
+               ComparisonOperations::GREATER_THAN, 15.0),
+            LogicalOperations::AND)}};
+    auto fn = LanguageParser::parse(cond);
+    EXPECT_TRUE(fn(MakeEvent("FR", 30)));
+    EXPECT_FALSE(fn(MakeEvent("FR", 12)));
+    EXPECT_FALSE(fn(MakeEvent("DE", 30)));
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::LESS_THAN, "scores.1",
+                             static_cast<int64_t>(5)))}},
+                     MakeEvent("FR", 30)));
+  }
+
+  TEST(NestedKeys_Errors, MissingAndNonScalar) {
+    const auto event = MakeEvent("FR", 30);
+    try {
+      Eval({{SE(UE(ComparisonOperations::EQUAL, "user.geo.zip",
+                   std::string("x")))}},
+           event);
+      FAIL() << "expected ParseException";
+    } catch (const ParseException &e) {
+      EXPECT_STREQ(e.what(), "Key not found: user.geo.zip");
+    }
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "user.geo",
+                              std::string("x")))}},
+                      event),
+                 ParseException);
+  }
+
+} // namespace
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+#include "predicate_registry.h"
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  SubExpression Eq(std::string key, ValueType v, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::EQUAL, std::move(key), std::move(v)}, prev);
+  }
+
+  SubExpression Gt(std::string key, int64_t v, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::GREATER_THAN, std::move(key), v}, prev);
+  }
+
+  constexpr auto AND = LogicalOperations::AND;
+  constexpr auto OR = LogicalOperations::OR;
+
+  // ---------- Tests ----------
+
+  TEST(PredicateRegistry_Interning, EqualClausesShared) {
+    PredicateRegistry registry;
+    EXPECT_EQ(registry.add({{Eq("region", std::string("eu")), Gt("age", 18, AND)}}), 0u);
+    EXPECT_EQ(registry.add({{Eq("region", std::string("eu")), Gt("age", 21, AND)}}), 1u);
+    EXPECT_EQ(registry.add({{Gt("age", 18), Eq("region", std::string("eu"), OR)}}), 2u);
+    EXPECT_EQ(registry.size(), 3u);
+    EXPECT_EQ(registry.clauses(), 6u);
+    EXPECT_EQ(registry.predicates(), 3u); // region == eu, age > 18, age > 21
+
+    // Same key and operator with a different type or operator are distinct
+    registry.add({{Eq("age", 18.0), SE(ExistsExpression{"age"}, AND), SE(ExistsExpression{"age", false}, OR)}});
+    EXPECT_EQ(registry.predicates(), 6u);
+    registry.add({{SE(BinaryExpression{"a", ArithmeticOperations::ADD, "b", ComparisonOperations::EQUAL, int64_t{3}}),
+                   SE(BinaryExpression{"a", ArithmeticOperations::ADD, "b", ComparisonOperations::EQUAL, int64_t{3}},
+                      AND),
+                   SE(ExistsExpression{"age"}, AND)}});
+    EXPECT_EQ(registry.predicates(), 7u);
+    // Other clause kinds are compiled per condition
+    const ListExpression list{ListQuantifier::ANY, "tags", ComparisonOperations::EQUAL, {std::string("x")}};
+    registry.add({{SE(list)}});
+    registry.add({{SE(list)}});
+    EXPECT_EQ(registry.predicates(), 9u);
+
+    EXPECT_THROW(registry.add({{Gt("age", 1), Gt("age", 2, LogicalOperations::NOT)}}), ParseException);
+    EXPECT_EQ(registry.size(), 7u);
+  }
+
+  TEST(PredicateRegistry_Evaluate, MatchesRowPath) {
+    const std::vector<FilterCondition> conditions{
+        {{Eq("region", std::string("eu")), Gt("age", 18, AND)}},
+        {{Eq("region", std::string("us")), Gt("age", 18, OR)}},
+        {{Gt("age", 30), Eq("region", std::string("eu"), AND), Gt("score", 5, OR)}},
+        {{Gt("score", 5), Gt("age", 18, AND), Eq("region", std::string("eu"), AND)}},
+        {},
+    };
+    PredicateRegistry registry;
+    std::vector<KeyPredicate> predicates;
+    for (const auto &condition : conditions) {
+      registry.add(condition);
+      predicates.push_back(LanguageParser::parse(condition));
+    }
+    std::vector<uint8_t> matches;
+    for (const char *region : {"eu", "us", "apac"}) {
+      for (int64_t age : {10, 25, 40}) {
+        for (int64_t score : {0, 9}) {
+          const std::vector<Key> keys{Key("region", std::string(region)), Key("age", age), Key("score", score)};
+          registry.evaluate(keys, matches);
+          ASSERT_EQ(matches.size(), conditions.size());
+          for (std::size_t c = 0; c < conditions.size(); ++c) {
+            EXPECT_EQ(matches[c] != 0, predicates[c](keys)) << c << " " << region << " " << age << " " << score;
+          }
+        }
+      }
+    }
+  }
+
+  TEST(PredicateRegistry_Evaluate, FailuresStayPerCondition) {
+    PredicateRegistry registry;
+    registry.add({{Gt("missing", 0)}});                           // needs the missing key
+    registry.add({{Gt("age", 50), Gt("missing", 0, AND)}});       // short-circuits before it
+    registry.add({{Gt("age", 18), Gt("missing", 0, OR)}});        // short-circuits before it
+    registry.add({{Gt("age", 18), Gt("missing", 0, AND)}});       // needs it
+    registry.add({{Eq("age", std::string("x")), Gt("age", 0, OR)}}); // type mismatch
+    const std::vector<Key> keys{Key("age", int64_t{30})};
+
+    std::vector<uint8_t> matches;
+    std::vector<std::size_t> failed;
+    registry.evaluate(keys, matches, failed);
+    EXPECT_EQ(matches, (std::vector<uint8_t>{0, 0, 1, 0, 0}));
+    EXPECT_EQ(failed, (std::vector<std::size_t>{0, 3, 4}));
+
+    // Without the failure list the results are the same
+    registry.evaluate(keys, matches);
+    EXPECT_EQ(matches, (std::vector<uint8_t>{0, 0, 1, 0, 0}));
+
+    // Results do not leak between records
+    registry.evaluate({Key("age", int64_t{60}), Key("missing", int64_t{1})}, matches, failed);
+    EXPECT_EQ(matches, (std::vector<uint8_t>{1, 1, 1, 1, 0}));
+    EXPECT_EQ(failed, (std::vector<std::size_t>{4}));
+  }
+
+  TEST(PredicateRegistry_Evaluate, ManyConditionsFewPredicates) {
+    PredicateRegistry registry;
+    for (int i = 0; i < 100; ++i) registry.add({{Gt("n", 5), Gt("n", i % 3, AND)}});
+    EXPECT_EQ(registry.predicates(), 4u);
+    std::vector<uint8_t> matches;
+    registry.evaluate({Key::text("n", "7")}, matches);
+    EXPECT_EQ(std::count(matches.begin(), matches.end(), 1), 100);
+    registry.evaluate({Key::text("n", "1")}, matches);
+    EXPECT_EQ(std::count(matches.begin(), matches.end(), 1), 0);
+  }
+
+} // namespace
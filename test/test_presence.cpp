@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "key_schema.h"
+#include "parser.h"
+#include "struct_binding.h"
+
+struct Profile {
+  int64_t age;
+  double score;
+};
+EXPR_EVAL_STRUCT(Profile, EXPR_EVAL_FIELD(age), EXPR_EVAL_FIELD(score));
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  SubExpression Exists(std::string key, bool exists = true,
+                       LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(ExistsExpression{std::move(key), exists}, prev);
+  }
+
+  SubExpression Gt(std::string key, int64_t v, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::GREATER_THAN, std::move(key), v}, prev);
+  }
+
+  constexpr auto AND = LogicalOperations::AND;
+  constexpr auto OR = LogicalOperations::OR;
+
+  // ---------- Tests ----------
+
+  TEST(Presence_Exists, RowPath) {
+    const std::vector<Key> keys{Key("a", int64_t{1}), Key::object("user", {Key("id", int64_t{7})})};
+    EXPECT_TRUE(LanguageParser::parse({{Exists("a")}})(keys));
+    EXPECT_FALSE(LanguageParser::parse({{Exists("b")}})(keys));
+    EXPECT_TRUE(LanguageParser::parse({{Exists("b", false)}})(keys));
+    EXPECT_TRUE(LanguageParser::parse({{Exists("user.id")}})(keys));
+    EXPECT_TRUE(LanguageParser::parse({{Exists("user")}})(keys)); // objects are present too
+
+    // Guarding a comparison: the missing key is never looked up
+    const FilterCondition guarded{{Exists("b"), Gt("b", 0, AND)}};
+    EXPECT_NO_THROW(EXPECT_FALSE(LanguageParser::parse(guarded)(keys)));
+  }
+
+  TEST(Presence_Schema, PresenceMask) {
+    const KeySchema schema({"a", "b", "user.id"});
+    EXPECT_EQ(schema.size(), 3u);
+    EXPECT_EQ(schema.bit("b"), 2u);
+    EXPECT_EQ(schema.bit("zzz"), 0u);
+    EXPECT_EQ(schema.presence({Key("a", int64_t{1})}), 1u);
+    EXPECT_EQ(schema.presence({Key("b", int64_t{1}), Key::object("user", {Key("id", int64_t{7})})}), 6u);
+    EXPECT_EQ(schema.presence({Key("user.id", int64_t{7})}), 4u); // flattened form
+    EXPECT_EQ(schema.presence({}), 0u);
+
+    std::vector<std::string> many;
+    for (int i = 0; i < 65; ++i) many.push_back("k" + std::to_string(i));
+    EXPECT_THROW(KeySchema{many}, ParseException);
+    many.pop_back();
+    const KeySchema full(many);
+    EXPECT_EQ(full.bit("k63"), uint64_t{1} << 63);
+    EXPECT_THROW(KeySchema({"a", "a"}), ParseException);
+  }
+
+  TEST(Presence_Rule, TrailingAndRun) {
+    const KeySchema schema({"a", "b", "c", "d"});
+    // Plain AND chain: everything is required; NOT EXISTS forbids
+    PresenceRule rule = schema.rule({{Gt("a", 0), Gt("b", 0, AND), Exists("c", false, AND)}});
+    EXPECT_EQ(rule.required, 0b0011u);
+    EXPECT_EQ(rule.forbidden, 0b0100u);
+
+    // (a OR b) AND c: only c is required
+    rule = schema.rule({{Gt("a", 0), Gt("b", 0, OR), Gt("c", 0, AND)}});
+    EXPECT_EQ(rule.required, 0b0100u);
+    // Trailing OR: nothing is required
+    rule = schema.rule({{Gt("a", 0), Gt("b", 0, OR)}});
+    EXPECT_EQ(rule.required, 0u);
+    // A NONE clause restarts the fold and joins the run
+    rule = schema.rule({{Gt("a", 0), Gt("b", 0, OR), Gt("c", 0), Gt("d", 0, AND)}});
+    EXPECT_EQ(rule.required, 0b1100u);
+    // Keys outside the schema and threshold children are not required
+    rule = schema.rule({{Gt("zzz", 0),
+                         SE(ThresholdExpression{1, {FilterCondition{{Gt("a", 0)}}}}, AND)}});
+    EXPECT_EQ(rule.required, 0u);
+
+    const PresenceRule mixed{0b11, 0b100};
+    EXPECT_TRUE(mixed.admits(0b1011));
+    EXPECT_FALSE(mixed.admits(0b1001));
+    EXPECT_FALSE(mixed.admits(0b0111));
+  }
+
+  TEST(Presence_Rule, AgreesWithEvaluation) {
+    const KeySchema schema({"a", "b", "c", "d"});
+    const std::vector<FilterCondition> conditions{
+        {{Gt("a", 0), Gt("b", 1, AND), Exists("d", false, AND)}},
+        {{Gt("a", 0), Gt("b", 1, OR), Gt("c", 0, AND), Exists("d", true, AND)}},
+        {{Exists("a"), Gt("c", 0, AND)}},
+    };
+    for (const auto &condition : conditions) {
+      const auto predicate = LanguageParser::parse(condition);
+      const PresenceRule rule = schema.rule(condition);
+      for (uint32_t present = 0; present < 16; ++present) {
+        for (int64_t value : {0, 1, 2}) {
+          std::vector<Key> keys;
+          for (int i = 0; i < 4; ++i) {
+            if (present >> i & 1) keys.emplace_back(std::string(1, static_cast<char>('a' + i)), value);
+          }
+          bool evaluated = false;
+          try {
+            evaluated = predicate(keys);
+          } catch (const ParseException &) {
+            evaluated = false; // a missing key
+          }
+          if (!rule.admits(schema.presence(keys))) {
+            EXPECT_FALSE(evaluated) << present << " " << value; // rejection never loses a match
+          }
+        }
+      }
+    }
+  }
+
+  TEST(Presence_Batch, ExistsOnColumns) {
+    std::vector<int64_t> a{1, 2, 3, 4};
+    const uint8_t validity[] = {0b1011}; // row 2 is null
+    ColumnView column = ColumnView::ofInt64(a.data(), 4);
+    column.validity = validity;
+    ColumnBatch batch;
+    batch.addColumn("a", column);
+
+    BatchEvaluator evaluator;
+    std::vector<uint8_t> mask;
+    evaluator.initialize({{Exists("a")}});
+    evaluator.evaluate(batch, mask);
+    EXPECT_EQ(mask, (std::vector<uint8_t>{1, 1, 0, 1}));
+    evaluator.initialize({{Exists("a", false)}});
+    evaluator.evaluate(batch, mask);
+    EXPECT_EQ(mask, (std::vector<uint8_t>{0, 0, 1, 0}));
+    evaluator.initialize({{Exists("missing")}});
+    evaluator.evaluate(batch, mask);
+    EXPECT_EQ(mask, (std::vector<uint8_t>{0, 0, 0, 0}));
+    evaluator.initialize({{Exists("missing", false), Gt("a", 2, AND)}});
+    evaluator.evaluate(batch, mask);
+    EXPECT_EQ(mask, (std::vector<uint8_t>{0, 0, 0, 1}));
+  }
+
+  TEST(Presence_Struct, FieldsAlwaysExist) {
+    StructEvaluator<Profile> evaluator;
+    evaluator.initialize({{Exists("age"), Exists("nickname", false, AND)}});
+    EXPECT_TRUE(evaluator.evaluate(Profile{30, 1.0}));
+    evaluator.initialize({{Exists("nickname"), Gt("age", 0, OR)}});
+    EXPECT_TRUE(evaluator.evaluate(Profile{30, 1.0}));
+    EXPECT_FALSE(evaluator.evaluate(Profile{0, 1.0}));
+  }
+
+  TEST(Presence_Stats, FingerprintCoversExists) {
+    EXPECT_NE(conditionFingerprint({{Exists("a")}}), conditionFingerprint({{Exists("a", false)}}));
+    EXPECT_NE(conditionFingerprint({{Exists("a")}}), conditionFingerprint({{Exists("b")}}));
+  }
+
+} // namespace
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr auto ADD = ArithmeticOperations::ADD;
+  constexpr auto MULTIPLY = ArithmeticOperations::MULTIPLY;
+  constexpr auto DIVIDE = ArithmeticOperations::DIVIDE;
+
+  SubExpression Arith(std::string l, ArithmeticOperations op, std::string r, ComparisonOperations cmp, ValueType v,
+                      LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(BinaryExpression{std::move(l), op, std::move(r), cmp, std::move(v)}, prev);
+  }
+
+  // ---------- Tests ----------
+
+  TEST(Projection_Row, ValuesAndTypes) {
+    const std::vector<Key> keys{Key("a", int64_t{6}), Key("b", int64_t{4}), Key("x", 0.5),
+                                Key::text("t", "2.5")};
+    EXPECT_EQ(std::get<int64_t>(LanguageParser::project({"a", MULTIPLY, "b"})(keys)), 24);
+    EXPECT_EQ(std::get<int64_t>(LanguageParser::project({"a", DIVIDE, "b"})(keys)), 1);
+    EXPECT_DOUBLE_EQ(std::get<double>(LanguageParser::project({"a", ADD, "x"})(keys)), 6.5);
+    EXPECT_DOUBLE_EQ(std::get<double>(LanguageParser::project({"t", MULTIPLY, "b"})(keys)), 10.0);
+  }
+
+  TEST(Projection_Row, Errors) {
+    const std::vector<Key> keys{Key("a", int64_t{6}), Key("zero", int64_t{0}), Key("s", std::string("x"))};
+    EXPECT_THROW(LanguageParser::project({"a", DIVIDE, "zero"})(keys), ParseException);
+    EXPECT_THROW(LanguageParser::project({"a", ADD, "missing"})(keys), ParseException);
+    EXPECT_THROW(LanguageParser::project({"a", ADD, "s"})(keys), ParseException);
+  }
+
+  TEST(Projection_Batch, MatchesRowPath) {
+    std::vector<int64_t> a, b;
+    std::vector<double> x;
+    for (int64_t i = 0; i < 100; ++i) {
+      a.push_back(i * 7 % 13 - 6);
+      b.push_back(i % 5 + 1);
+      x.push_back(0.25 * static_cast<double>(i));
+    }
+    ColumnBatch batch;
+    batch.addColumn("a", ColumnView::ofInt64(a.data(), 100));
+    batch.addColumn("b", ColumnView::ofInt64(b.data(), 100));
+    batch.addColumn("x", ColumnView::ofDouble(x.data(), 100));
+
+    const std::vector<ArithmeticExpression> projections{{"a", MULTIPLY, "b"}, {"a", DIVIDE, "b"}, {"x", ADD, "a"}};
+    std::vector<ProjectedColumn> out;
+    BatchEvaluator::project(batch, projections, out);
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0].type, DataTypes::INTEGER);
+    EXPECT_EQ(out[2].type, DataTypes::DOUBLE);
+    EXPECT_TRUE(out[0].validity.empty());
+    for (std::size_t i = 0; i < 100; ++i) {
+      const std::vector<Key> keys{Key("a", a[i]), Key("b", b[i]), Key("x", x[i])};
+      EXPECT_EQ(out[0].ints[i], std::get<int64_t>(LanguageParser::project(projections[0])(keys)));
+      EXPECT_EQ(out[1].ints[i], std::get<int64_t>(LanguageParser::project(projections[1])(keys)));
+      EXPECT_DOUBLE_EQ(out[2].doubles[i], std::get<double>(LanguageParser::project(projections[2])(keys)));
+    }
+  }
+
+  TEST(Projection_Batch, FilterAndProjectOnePass) {
+    std::vector<int64_t> price{10, 20, 30, 40}, qty{1, 0, 5, 3};
+    const uint8_t validity[] = {0b0111}; // qty of row 3 is null
+    ColumnView qty_column = ColumnView::ofInt64(qty.data(), 4);
+    qty_column.validity = validity;
+    ColumnBatch batch;
+    batch.addColumn("price", ColumnView::ofInt64(price.data(), 4));
+    batch.addColumn("qty", qty_column);
+
+    BatchEvaluator evaluator;
+    evaluator.initialize({{Arith("price", MULTIPLY, "qty", ComparisonOperations::GREATER_THAN, int64_t{5})}});
+    std::vector<uint8_t> matches;
+    std::vector<ProjectedColumn> totals;
+    evaluator.evaluate(batch, matches, {{"price", MULTIPLY, "qty"}, {"price", ADD, "price"}}, totals);
+    EXPECT_EQ(matches, (std::vector<uint8_t>{1, 0, 1, 0}));
+    ASSERT_EQ(totals.size(), 2u);
+    const ColumnView view = totals[0].view();
+    EXPECT_TRUE(view.isValid(0));
+    EXPECT_FALSE(view.isValid(1)); // not a match
+    EXPECT_TRUE(view.isValid(2));
+    EXPECT_FALSE(view.isValid(3)); // null operand
+    EXPECT_EQ(view.int64At(0), 10);
+    EXPECT_EQ(view.int64At(2), 150);
+    EXPECT_EQ(totals[1].ints[2], 60);
+
+    // Projected values can feed another batch
+    ColumnBatch derived;
+    derived.addColumn("total", view);
+    BatchEvaluator over;
+    over.initialize({{SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "total", int64_t{100}})}});
+    std::vector<uint8_t> large;
+    over.evaluate(derived, large);
+    EXPECT_EQ(large, (std::vector<uint8_t>{0, 0, 1, 0}));
+  }
+
+  TEST(Projection_Batch, DivisionByZeroOnlyInMatchingRows) {
+    std::vector<int64_t> a{8, 9, 10}, b{2, 0, 5}, flag{0, 0, 1};
+    ColumnBatch batch;
+    batch.addColumn("a", ColumnView::ofInt64(a.data(), 3));
+    batch.addColumn("b", ColumnView::ofInt64(b.data(), 3));
+    batch.addColumn("flag", ColumnView::ofInt64(flag.data(), 3));
+    const std::vector<ArithmeticExpression> ratio{{"a", DIVIDE, "b"}};
+
+    BatchEvaluator evaluator;
+    std::vector<uint8_t> matches;
+    std::vector<ProjectedColumn> out;
+    evaluator.initialize({{SE(UnaryExpression{ComparisonOperations::EQUAL, "flag", int64_t{1}})}});
+    ASSERT_NO_THROW(evaluator.evaluate(batch, matches, ratio, out));
+    EXPECT_EQ(out[0].ints[2], 2);
+    EXPECT_THROW(BatchEvaluator::project(batch, ratio, out), ParseException);
+
+    // The filter computes a / b only where the OR still needs it and shares
+    // the values; row 1 matches through the first clause and is projected
+    flag = {1, 1, 0};
+    evaluator.initialize({{SE(UnaryExpression{ComparisonOperations::EQUAL, "flag", int64_t{1}}),
+                           Arith("a", DIVIDE, "b", ComparisonOperations::GREATER_THAN, int64_t{0},
+                                 LogicalOperations::OR)}});
+    ASSERT_NO_THROW(evaluator.evaluate(batch, matches));
+    EXPECT_THROW(evaluator.evaluate(batch, matches, ratio, out), ParseException);
+    b[1] = 3;
+    ASSERT_NO_THROW(evaluator.evaluate(batch, matches, ratio, out));
+    EXPECT_EQ(out[0].ints, (std::vector<int64_t>{4, 3, 2}));
+  }
+
+  TEST(Projection_Batch, Errors) {
+    std::vector<int64_t> a{1};
+    const int32_t offsets[] = {0, 1};
+    ColumnBatch batch;
+    batch.addColumn("a", ColumnView::ofInt64(a.data(), 1));
+    batch.addColumn("s", ColumnView::ofStrings(offsets, "x", 1));
+    std::vector<ProjectedColumn> out;
+    EXPECT_THROW(BatchEvaluator::project(batch, {{"a", ADD, "s"}}, out), ParseException);
+    EXPECT_THROW(BatchEvaluator::project(batch, {{"a", ADD, "missing"}}, out), ParseException);
+  }
+
+} // namespace
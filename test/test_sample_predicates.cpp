@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "evaluator.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+#include "struct_binding.h"
+
+struct Visit {
+  int64_t user_id;
+  int32_t region;
+  char session[16];
+};
+EXPR_EVAL_STRUCT(Visit, EXPR_EVAL_FIELD(user_id), EXPR_EVAL_FIELD(region),
+                 EXPR_EVAL_FIELD(session));
+
+namespace {
+
+  SubExpression SE(SampleExpression se,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(se)}, prev};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  FilterCondition Sample(double rate, uint64_t seed = 0, std::string key = "user_id") {
+    return {{SE(SampleExpression{std::move(key), rate, seed})}};
+  }
+
+  // Which of users [0, n) a sampling predicate keeps
+  std::vector<bool> Kept(const FilterCondition &cond, int64_t n) {
+    const auto predicate = LanguageParser::parse(cond);
+    std::vector<bool> kept;
+    for (int64_t id = 0; id < n; ++id) kept.push_back(predicate({Key("user_id", id)}));
+    return kept;
+  }
+
+  std::size_t Count(const std::vector<bool> &kept) {
+    return static_cast<std::size_t>(std::count(kept.begin(), kept.end(), true));
+  }
+
+  // ---------- Tests ----------
+
+  TEST(SamplePredicates_Row, KeepsAboutRateOfValues) {
+    for (const double rate : {0.01, 0.1, 0.5}) {
+      const std::size_t kept = Count(Kept(Sample(rate), 100000));
+      EXPECT_NEAR(static_cast<double>(kept), rate * 100000, 5 * std::sqrt(rate * 100000)) << rate;
+    }
+    EXPECT_EQ(Count(Kept(Sample(0.0), 10000)), 0u);
+    EXPECT_EQ(Count(Kept(Sample(1.0), 10000)), 10000u);
+  }
+
+  TEST(SamplePredicates_Row, DeterministicAndSeeded) {
+    EXPECT_EQ(Kept(Sample(0.1, 7), 5000), Kept(Sample(0.1, 7), 5000));
+    EXPECT_NE(Kept(Sample(0.1, 7), 5000), Kept(Sample(0.1, 8), 5000));
+
+    // Nested rates: everything kept at 1% is kept at 10%
+    const auto low = Kept(Sample(0.01, 3), 20000);
+    const auto high = Kept(Sample(0.1, 3), 20000);
+    for (std::size_t i = 0; i < low.size(); ++i) {
+      if (low[i]) {
+        EXPECT_TRUE(high[i]) << i;
+      }
+    }
+  }
+
+  TEST(SamplePredicates_Row, StableAcrossProcesses) {
+    // Pinned outputs: changing the hash would resample every deployment
+    std::string kept;
+    const auto predicate = LanguageParser::parse(Sample(0.5, 42));
+    for (int64_t id = 0; id < 16; ++id) kept += predicate({Key("user_id", id)}) ? '1' : '0';
+    for (const char *name : {"", "a", "alice", "user-0000000001", "user-0000000002"}) {
+      kept += predicate({Key("user_id", std::string(name))}) ? '1' : '0';
+    }
+    EXPECT_EQ(kept, "001110001100000101111");
+  }
+
+  TEST(SamplePredicates_Row, KeyTypes) {
+    const auto sample = LanguageParser::parse(Sample(1.0));
+    EXPECT_TRUE(sample({Key("user_id", std::string("u1"))}));
+    // Text keys hash their bytes, like strings
+    const auto half = LanguageParser::parse(Sample(0.5, 1));
+    for (const char *id : {"1", "22", "333", "4444", "55555"}) {
+      EXPECT_EQ(half({Key::text("user_id", id)}), half({Key("user_id", std::string(id))})) << id;
+    }
+    EXPECT_THROW(sample({Key("user_id", 1.5)}), ParseException);
+    EXPECT_THROW(sample({Key("other", int64_t{1})}), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Sample(1.5)), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Sample(-0.1)), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Sample(std::nan(""))), ParseException);
+  }
+
+  TEST(SamplePredicates_Planner, HoistedToFrontOfAndGroups) {
+    const FilterCondition cond{{
+        SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "score", 0.5}),
+        SE(SampleExpression{"user_id", 0.1, 0}, LogicalOperations::AND),
+        SE(SampleExpression{"user_id", 0.01, 1}, LogicalOperations::AND),
+        SE(UnaryExpression{ComparisonOperations::EQUAL, "flag", true}, LogicalOperations::OR),
+        SE(SampleExpression{"user_id", 0.01, 2}, LogicalOperations::OR),
+    }};
+    EXPECT_EQ(planClauseOrder(cond, {}), (std::vector<std::size_t>{2, 1, 0, 3, 4}));
+
+    Evaluator evaluator;
+    evaluator.initialize(cond);
+    EXPECT_EQ(evaluator.getClauseOrder(), (std::vector<std::size_t>{2, 1, 0, 3, 4}));
+    // The sample rejects before the missing "score" key is looked up
+    std::size_t evaluated = 0;
+    for (int64_t id = 0; id < 1000; ++id) {
+      try {
+        evaluator.evaluate({Key("user_id", id), Key("flag", false)});
+      } catch (const ParseException &) {
+        ++evaluated;
+      }
+    }
+    EXPECT_LT(evaluated, 50u);
+  }
+
+  TEST(SamplePredicates_Batch, MatchesRowPath) {
+    std::vector<int64_t> ids;
+    std::vector<std::string> names;
+    for (int64_t i = 0; i < 2000; ++i) {
+      ids.push_back(i * 7919);
+      names.push_back("user-" + std::to_string(i));
+    }
+    std::vector<int32_t> offsets{0};
+    std::string chars;
+    for (const auto &name : names) {
+      chars += name;
+      offsets.push_back(static_cast<int32_t>(chars.size()));
+    }
+    ColumnBatch batch;
+    batch.addColumn("id", ColumnView::ofInt64(ids.data(), static_cast<int64_t>(ids.size())));
+    batch.addColumn("name", ColumnView::ofStrings(offsets.data(), chars.data(), static_cast<int64_t>(names.size())));
+
+    for (const char *key : {"id", "name"}) {
+      const auto cond = Sample(0.2, 99, key);
+      BatchEvaluator evaluator;
+      evaluator.initialize(cond);
+      std::vector<uint8_t> mask;
+      evaluator.evaluate(batch, mask);
+      const auto row = LanguageParser::parse(cond);
+      for (std::size_t i = 0; i < ids.size(); ++i) {
+        const Key k = std::string(key) == "id" ? Key(key, ids[i]) : Key(key, names[i]);
+        EXPECT_EQ(mask[i] != 0, row({k})) << key << " row " << i;
+      }
+    }
+  }
+
+  TEST(SamplePredicates_Struct, MatchesRowPath) {
+    StructEvaluator<Visit> by_id;
+    by_id.initialize(Sample(0.3, 5));
+    StructEvaluator<Visit> by_region;
+    by_region.initialize(Sample(0.3, 5, "region"));
+    StructEvaluator<Visit> by_session;
+    by_session.initialize(Sample(0.3, 5, "session"));
+    const auto row = LanguageParser::parse(Sample(0.3, 5, "k"));
+    for (int32_t i = -50; i < 200; ++i) {
+      Visit visit{i * 31LL, i, {}};
+      const std::string session = "s" + std::to_string(i);
+      std::snprintf(visit.session, sizeof(visit.session), "%s", session.c_str());
+      EXPECT_EQ(by_id.evaluate(visit), row({Key("k", visit.user_id)}));
+      EXPECT_EQ(by_region.evaluate(visit), row({Key("k", int64_t{i})}));
+      EXPECT_EQ(by_session.evaluate(visit), row({Key("k", session)}));
+    }
+  }
+
+  TEST(SamplePredicates_Stats, FingerprintCoversRateAndSeed) {
+    EXPECT_NE(conditionFingerprint(Sample(0.1, 1)), conditionFingerprint(Sample(0.2, 1)));
+    EXPECT_NE(conditionFingerprint(Sample(0.1, 1)), conditionFingerprint(Sample(0.1, 2)));
+  }
+
+} // namespace
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+#include "scan.h"
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  FilterCondition Equals(std::string key, int64_t v) {
+    return {{SE(UnaryExpression{ComparisonOperations::EQUAL, std::move(key), v})}};
+  }
+
+  // Record i has v = i % 7
+  std::vector<std::vector<Key>> MakeRecords(std::size_t n) {
+    std::vector<std::vector<Key>> records(n);
+    for (std::size_t i = 0; i < n; ++i) records[i] = {Key("v", static_cast<int64_t>(i % 7))};
+    return records;
+  }
+
+  std::vector<std::size_t> Expected(std::size_t n, std::size_t limit) {
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 3; i < n && expected.size() < limit; i += 7) expected.push_back(i);
+    return expected;
+  }
+
+  // ---------- Tests ----------
+
+  TEST(Scan_Records, OrderedMatchesSequential) {
+    const auto records = MakeRecords(10000);
+    const auto predicate = LanguageParser::parse(Equals("v", 3));
+    for (unsigned threads : {1u, 2u, 4u}) {
+      for (std::size_t limit : {std::size_t{0}, std::size_t{1}, std::size_t{5}, std::size_t{200},
+                                ScanOptions::kNoLimit}) {
+        ScanOptions options;
+        options.limit = limit;
+        options.threads = threads;
+        options.block_size = 64;
+        EXPECT_EQ(scanMatches(predicate, records, options), Expected(records.size(), limit))
+            << threads << " threads, limit " << limit;
+      }
+    }
+  }
+
+  TEST(Scan_Records, UnorderedReturnsLimitMatches) {
+    const auto records = MakeRecords(10000);
+    const auto predicate = LanguageParser::parse(Equals("v", 3));
+    ScanOptions options;
+    options.threads = 4;
+    options.ordered = false;
+    options.block_size = 64;
+    options.limit = 50;
+    const auto matches = scanMatches(predicate, records, options);
+    ASSERT_EQ(matches.size(), 50u);
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+      EXPECT_EQ(matches[i] % 7, 3u);
+      if (i > 0) {
+        EXPECT_LT(matches[i - 1], matches[i]);
+      }
+    }
+    options.limit = ScanOptions::kNoLimit;
+    EXPECT_EQ(scanMatches(predicate, records, options), Expected(records.size(), ScanOptions::kNoLimit));
+  }
+
+  TEST(Scan_Records, StopsEarly) {
+    const auto records = MakeRecords(100000);
+    std::atomic<std::size_t> calls{0};
+    const auto inner = LanguageParser::parse(Equals("v", 3));
+    const KeyPredicate counted = [&](const std::vector<Key> &keys) {
+      calls.fetch_add(1, std::memory_order_relaxed);
+      return inner(keys);
+    };
+    EXPECT_TRUE(anyMatch(counted, records));
+    EXPECT_EQ(calls.load(), 4u);
+
+    calls = 0;
+    ScanOptions options;
+    options.limit = 10;
+    options.threads = 4;
+    options.block_size = 256;
+    EXPECT_EQ(scanMatches(counted, records, options), Expected(records.size(), 10));
+    EXPECT_LT(calls.load(), 20000u); // a few blocks per worker at most
+
+    EXPECT_FALSE(anyMatch(LanguageParser::parse(Equals("v", 9)), records, 4));
+  }
+
+  TEST(Scan_Records, ErrorsLikeSequentialScan) {
+    auto records = MakeRecords(5000);
+    records[2000] = {Key("other", int64_t{3})}; // "Key not found"
+    const auto predicate = LanguageParser::parse(Equals("v", 3));
+    for (unsigned threads : {1u, 4u}) {
+      ScanOptions options;
+      options.threads = threads;
+      options.block_size = 64;
+      options.limit = 10; // reached before record 2000
+      EXPECT_EQ(scanMatches(predicate, records, options), Expected(records.size(), 10));
+      options.limit = 500; // needs records past it
+      EXPECT_THROW(scanMatches(predicate, records, options), ParseException) << threads;
+    }
+  }
+
+  TEST(Scan_Batch, SelectWithLimit) {
+    const int64_t n = 100000;
+    std::vector<int64_t> v(static_cast<std::size_t>(n));
+    for (int64_t i = 0; i < n; ++i) v[i] = i % 7;
+    ColumnBatch batch;
+    batch.addColumn("v", ColumnView::ofInt64(v.data(), n));
+
+    BatchEvaluator evaluator;
+    evaluator.initialize(Equals("v", 3));
+    const auto all = evaluator.select(batch);
+    for (std::size_t limit : {std::size_t{0}, std::size_t{1}, std::size_t{146}, std::size_t{147},
+                              std::size_t{5000}, all.size(), all.size() + 1}) {
+      const auto limited = evaluator.select(batch, limit);
+      ASSERT_EQ(limited.size(), std::min(limit, all.size()));
+      EXPECT_TRUE(std::equal(limited.begin(), limited.end(), all.begin())) << limit;
+    }
+    EXPECT_TRUE(evaluator.any(batch));
+    evaluator.initialize(Equals("v", 9));
+    EXPECT_FALSE(evaluator.any(batch));
+  }
+
+  TEST(Scan_Batch, LaterSlicesAreNotEvaluated) {
+    // Division by zero past the first slice is never reached with limit 1
+    std::vector<int64_t> a(5000, 1), b(5000, 1);
+    b[4000] = 0;
+    ColumnBatch batch;
+    batch.addColumn("a", ColumnView::ofInt64(a.data(), 5000));
+    batch.addColumn("b", ColumnView::ofInt64(b.data(), 5000));
+    BatchEvaluator evaluator;
+    evaluator.initialize({{SE(BinaryExpression{"a", ArithmeticOperations::DIVIDE, "b",
+                                               ComparisonOperations::EQUAL, int64_t{1}})}});
+    EXPECT_EQ(evaluator.select(batch, 1), (std::vector<uint32_t>{0}));
+    EXPECT_THROW(evaluator.select(batch), ParseException);
+  }
+
+  TEST(Scan_Batch, Slice) {
+    std::vector<int64_t> v{0, 1, 2, 3, 4};
+    const uint8_t validity[] = {0b10111}; // row 3 is null
+    ColumnView column = ColumnView::ofInt64(v.data(), 5);
+    column.validity = validity;
+    ColumnBatch batch;
+    batch.addColumn("v", column);
+    const ColumnBatch sliced = batch.slice(2, 3);
+    ASSERT_EQ(sliced.numRows(), 3);
+    EXPECT_EQ(sliced.find("v")->int64At(0), 2);
+    EXPECT_FALSE(sliced.find("v")->isValid(1));
+    EXPECT_THROW(batch.slice(3, 3), ParseException);
+  }
+
+} // namespace
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "ip_address.h"
+#include "parser.h"
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  constexpr auto AND = LogicalOperations::AND;
+  constexpr auto OR = LogicalOperations::OR;
+  constexpr int64_t kRows = 2003; // not a multiple of 8: covers the word loops' tails
+
+  // Columns of every kind, with nulls in "v"; "one" is never 0
+  struct Columns {
+    std::vector<int64_t> v, w, one;
+    std::vector<double> lat, lon;
+    std::vector<uint8_t> ips;
+    std::vector<int32_t> offsets{0};
+    std::string data;
+    std::vector<uint8_t> validity;
+    ColumnBatch batch;
+
+    Columns() {
+      uint32_t x = 12345;
+      auto next = [&x] { return (x = x * 1103515245u + 12345u) >> 16; };
+      validity.assign((kRows + 7) / 8, 0);
+      for (int64_t i = 0; i < kRows; ++i) {
+        v.push_back(next() % 100);
+        w.push_back(next() % 7);
+        one.push_back(next() % 3 + 1);
+        lat.push_back((next() % 180) - 90.0);
+        lon.push_back((next() % 360) - 180.0);
+        const uint32_t ip = 0x0a000000u | (next() % 512);
+        for (int b = 3; b >= 0; --b) ips.push_back(static_cast<uint8_t>(ip >> (8 * b)));
+        data += "k" + std::to_string(next() % 30);
+        offsets.push_back(static_cast<int32_t>(data.size()));
+        if (next() % 10) validity[i >> 3] |= static_cast<uint8_t>(1 << (i & 7));
+      }
+      ColumnView vc = ColumnView::ofInt64(v.data(), kRows);
+      vc.validity = validity.data();
+      batch.addColumn("v", vc);
+      batch.addColumn("w", ColumnView::ofInt64(w.data(), kRows));
+      batch.addColumn("one", ColumnView::ofInt64(one.data(), kRows));
+      batch.addColumn("lat", ColumnView::ofDouble(lat.data(), kRows));
+      batch.addColumn("lon", ColumnView::ofDouble(lon.data(), kRows));
+      batch.addColumn("ip", ColumnView::ofIpv4(ips.data(), kRows));
+      batch.addColumn("s", ColumnView::ofStrings(offsets.data(), data.data(), kRows));
+    }
+  };
+
+  SubExpression Lt(const std::string &key, int64_t c, LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{ComparisonOperations::LESS_THAN, key, c}, prev);
+  }
+
+  // One clause of each kind, to follow a selective first clause
+  std::vector<Expression> Clauses() {
+    Cidr net;
+    Cidr::parse("10.0.1.0/24", net);
+    return {
+        UnaryExpression{ComparisonOperations::GREATER_EQUAL, "w", int64_t{3}},
+        UnaryExpression{ComparisonOperations::EQUAL, "s", std::string("k7")},
+        BinaryExpression{"v", ArithmeticOperations::MULTIPLY, "w", ComparisonOperations::GREATER_THAN, int64_t{100}},
+        BinaryExpression{"w", ArithmeticOperations::DIVIDE, "one", ComparisonOperations::LESS_EQUAL, int64_t{3}},
+        CidrExpression{"ip", ComparisonOperations::EQUAL, {net}},
+        GeoExpression{"lat", "lon", GeoBox{{-30.0, -60.0}, {45.0, 90.0}}},
+        BitmaskExpression{BitTest::ANY, "v", 0x5},
+        SampleExpression{"v", 0.5, 7},
+        ExistsExpression{"v"},
+        ThresholdExpression{2, {FilterCondition{{Lt("w", 2)}}, FilterCondition{{Lt("v", 50)}},
+                                FilterCondition{{Lt("v", 30)}}}},
+    };
+  }
+
+  std::vector<uint8_t> Evaluate(const FilterCondition &condition, const ColumnBatch &batch, int64_t density) {
+    BatchEvaluator evaluator;
+    evaluator.initialize(condition);
+    evaluator.setSelectionDensity(density);
+    std::vector<uint8_t> mask;
+    evaluator.evaluate(batch, mask);
+    return mask;
+  }
+
+  // ---------- Tests ----------
+
+  TEST(SelectionVectors_Batch, SameResultAsWholeColumns) {
+    Columns columns;
+    const auto clauses = Clauses();
+    for (std::size_t j = 0; j < clauses.size(); ++j) {
+      for (int64_t first : {1, 10, 60}) {
+        for (auto op : {AND, OR}) {
+          // v < first: survivors are sparse for AND, dense for OR
+          const FilterCondition condition{{Lt("v", first), SE(clauses[j], op), Lt("w", 5, AND)}};
+          const auto whole = Evaluate(condition, columns.batch, 0);
+          EXPECT_EQ(Evaluate(condition, columns.batch, 1), whole) << j << " " << first;
+          EXPECT_EQ(Evaluate(condition, columns.batch, BatchEvaluator::kSelectionDensity), whole) << j;
+        }
+      }
+    }
+  }
+
+  TEST(SelectionVectors_Batch, ThresholdChildrenOnSurvivors) {
+    Columns columns;
+    const FilterCondition inner{{Lt("w", 2)}};
+    const FilterCondition mostly{{Lt("v", 90)}};
+    for (int64_t first : {1, 10, 60}) {
+      const FilterCondition condition{
+          {Lt("v", first), SE(ThresholdExpression{2, {inner, mostly, FilterCondition{{Lt("w", 6)}}}}, AND)}};
+      EXPECT_EQ(Evaluate(condition, columns.batch, 1), Evaluate(condition, columns.batch, 0)) << first;
+    }
+  }
+
+  TEST(SelectionVectors_Batch, DivisionByZeroOnlyOnSurvivors) {
+    std::vector<int64_t> a(100, 1), b(100, 1), key(100, 50);
+    b[10] = 0;
+    key[20] = 0;
+    ColumnBatch batch;
+    batch.addColumn("a", ColumnView::ofInt64(a.data(), 100));
+    batch.addColumn("b", ColumnView::ofInt64(b.data(), 100));
+    batch.addColumn("key", ColumnView::ofInt64(key.data(), 100));
+    const FilterCondition condition{
+        {Lt("key", 10),
+         SE(BinaryExpression{"a", ArithmeticOperations::DIVIDE, "b", ComparisonOperations::EQUAL, int64_t{1}}, AND)}};
+    for (int64_t density : {0, 1, 8}) {
+      EXPECT_EQ(Evaluate(condition, batch, density)[20], 1) << density;
+    }
+    key[10] = 0; // the zero divisor now survives
+    for (int64_t density : {0, 1, 8}) {
+      EXPECT_THROW(Evaluate(condition, batch, density), ParseException) << density;
+    }
+  }
+
+} // namespace
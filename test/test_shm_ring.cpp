@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "shm_ring.h"
+#include "struct_binding.h"
+
+struct Packet {
+  int64_t bytes;
+  double rtt_ms;
+  bool tcp;
+  char host[16];
+};
+EXPR_EVAL_STRUCT(Packet, EXPR_EVAL_FIELD(bytes), EXPR_EVAL_FIELD(rtt_ms),
+                 EXPR_EVAL_FIELD(tcp), EXPR_EVAL_FIELD(host));
+
+namespace {
+
+  using Channel = RingChannel<Packet, 8>;
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  Packet MakePacket(int64_t bytes, const char *host) {
+    Packet p{bytes, 1.5, true, {}};
+    std::strncpy(p.host, host, sizeof(p.host));
+    return p;
+  }
+
+  FilterCondition MakeCondition() {
+    return FilterCondition{
+        {SE(UE(ComparisonOperations::GREATER_THAN, "bytes",
+               static_cast<int64_t>(100))),
+         SE(UE(ComparisonOperations::EQUAL, "host", std::string("db-1")),
+            LogicalOperations::AND)}};
+  }
+
+  std::string UniqueName(const char *tag) {
+    return std::string("/expr_eval_test_") + tag + "_" +
+           std::to_string(getpid());
+  }
+
+  // ---------- Tests ----------
+
+  TEST(SpscRing_Basic, FillsDrainsAndWraps) {
+    SpscRing<int64_t, 4> ring;
+    int64_t v = 0;
+    EXPECT_FALSE(ring.tryPop(v));
+    for (int round = 0; round < 3; ++round) {
+      for (int64_t i = 0; i < 4; ++i) EXPECT_TRUE(ring.tryPush(round * 10 + i));
+      EXPECT_FALSE(ring.tryPush(99)); // full
+      EXPECT_EQ(ring.readable(), 4u);
+      for (int64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.tryPop(v));
+        EXPECT_EQ(v, round * 10 + i);
+      }
+    }
+    EXPECT_EQ(ring.readSequence(), 12u);
+  }
+
+  TEST(SpscRing_Basic, BatchedPublishAndRelease) {
+    SpscRing<int64_t, 8> ring;
+    ASSERT_EQ(ring.writable(), 8u);
+    for (std::size_t i = 0; i < 5; ++i) ring.writeSlot(i) = static_cast<int64_t>(i);
+    EXPECT_EQ(ring.readable(), 0u); // nothing published yet
+    ring.publish(5);
+    ASSERT_EQ(ring.readable(), 5u);
+    EXPECT_EQ(ring.readSlot(4), 4);
+    ring.release(3);
+    EXPECT_EQ(ring.readSlot(0), 3);
+    EXPECT_EQ(ring.writable(6), 6u);
+  }
+
+  TEST(SpscRing_Basic, IndicesOnSeparateCacheLines) {
+    EXPECT_EQ(alignof(SpscRing<int64_t, 8>), kCacheLineSize);
+    EXPECT_GE(sizeof(SpscRing<char, 1>), 3 * kCacheLineSize);
+  }
+
+  TEST(RingFilterConsumer_Poll, EvaluatesInPlaceAndPublishesResults) {
+    Channel channel;
+    RingFilterConsumer<Packet, 8> consumer;
+    consumer.initialize(MakeCondition());
+
+    EXPECT_EQ(consumer.poll(channel), 0u);
+    ASSERT_TRUE(channel.records.tryPush(MakePacket(500, "db-1")));
+    ASSERT_TRUE(channel.records.tryPush(MakePacket(50, "db-1")));
+    ASSERT_TRUE(channel.records.tryPush(MakePacket(500, "db-10")));
+    EXPECT_EQ(consumer.poll(channel), 3u);
+
+    MatchResult r{};
+    const uint8_t expected[] = {1, 0, 0};
+    for (uint64_t i = 0; i < 3; ++i) {
+      ASSERT_TRUE(channel.results.tryPop(r));
+      EXPECT_EQ(r.sequence, i);
+      EXPECT_EQ(r.matched, expected[i]);
+    }
+    EXPECT_EQ(channel.records.writable(8), 8u);
+  }
+
+  TEST(RingFilterConsumer_Poll, StopsWhenResultRingIsFull) {
+    Channel channel;
+    RingFilterConsumer<Packet, 8> consumer;
+    consumer.initialize(MakeCondition());
+    for (int i = 0; i < 8; ++i) channel.records.tryPush(MakePacket(i, "x"));
+    EXPECT_EQ(consumer.poll(channel, 5), 5u);
+    for (int i = 0; i < 3; ++i) channel.records.tryPush(MakePacket(i, "x"));
+    EXPECT_EQ(consumer.poll(channel), 3u); // 3 slots left in the result ring
+    EXPECT_EQ(consumer.poll(channel), 0u);
+    EXPECT_EQ(channel.records.readable(), 3u);
+  }
+
+  TEST(SharedMemory_Mapping, SecondMappingSeesSameRing) {
+    const std::string name = UniqueName("map");
+    SharedMemory owner =
+        SharedMemory::create(name, SharedMemory::bytesFor<Channel>());
+    Channel *channel = owner.construct<Channel>();
+    ASSERT_TRUE(channel->records.tryPush(MakePacket(7, "a")));
+
+    SharedMemory other =
+        SharedMemory::open(name, SharedMemory::bytesFor<Channel>());
+    Channel *attached = other.attach<Channel>();
+    ASSERT_NE(attached, nullptr);
+    Packet p{};
+    ASSERT_TRUE(attached->records.tryPop(p));
+    EXPECT_EQ(p.bytes, 7);
+    EXPECT_STREQ(p.host, "a");
+
+    EXPECT_THROW(SharedMemory::create(name, SharedMemory::bytesFor<Channel>()),
+                 std::system_error);
+  }
+
+  TEST(SharedMemory_Mapping, UnlinkedWhenOwnerIsDestroyed) {
+    const std::string name = UniqueName("unlink");
+    { SharedMemory owner = SharedMemory::create(name, 4096); }
+    EXPECT_THROW(SharedMemory::open(name, 4096), std::system_error);
+  }
+
+  TEST(SharedMemory_Mapping, AttachWaitsForConstruct) {
+    const std::string name = UniqueName("ready");
+    SharedMemory owner =
+        SharedMemory::create(name, SharedMemory::bytesFor<Channel>());
+    SharedMemory other =
+        SharedMemory::open(name, SharedMemory::bytesFor<Channel>());
+    EXPECT_EQ(other.attach<Channel>(), nullptr);
+    ASSERT_TRUE(owner.construct<Channel>()->records.tryPush(MakePacket(1, "a")));
+    Channel *channel = other.attach<Channel>();
+    ASSERT_NE(channel, nullptr);
+    EXPECT_EQ(channel->records.readable(), 1u);
+    // Built for another layout
+    using Ring = SpscRing<Packet, 8>;
+    EXPECT_THROW(other.attach<Ring>(), std::system_error);
+  }
+
+  TEST(SharedMemory_Mapping, OpenRejectsObjectSmallerThanMapping) {
+    const std::string name = UniqueName("small");
+    SharedMemory owner = SharedMemory::create(name, 64);
+    EXPECT_THROW(
+        SharedMemory::open(name, SharedMemory::bytesFor<Channel>()),
+        std::system_error);
+  }
+
+  TEST(SharedMemory_Mapping, ConsumerInAnotherProcess) {
+    const std::string name = UniqueName("fork");
+    SharedMemory shm =
+        SharedMemory::create(name, SharedMemory::bytesFor<Channel>());
+    Channel *channel = shm.construct<Channel>();
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      SharedMemory mine =
+          SharedMemory::open(name, SharedMemory::bytesFor<Channel>());
+      Channel *ch = mine.attach<Channel>();
+      RingFilterConsumer<Packet, 8> consumer;
+      consumer.initialize(MakeCondition());
+      std::size_t done = 0;
+      while (done < 20) {
+        const std::size_t n = consumer.poll(*ch);
+        if (n == 0) std::this_thread::yield();
+        done += n;
+      }
+      _exit(0);
+    }
+
+    std::size_t sent = 0, received = 0, matched = 0;
+    while (received < 20) {
+      if (sent < 20 &&
+          channel->records.tryPush(MakePacket(sent % 2 ? 500 : 5, "db-1"))) {
+        ++sent;
+      }
+      MatchResult r{};
+      while (channel->results.tryPop(r)) {
+        EXPECT_EQ(r.sequence, received);
+        matched += r.matched;
+        ++received;
+      }
+      std::this_thread::yield();
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(matched, 10u);
+  }
+
+} // namespace
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "parser.h"
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  SubExpression Cmp(std::string key, ComparisonOperations op, ValueType v,
+                    LogicalOperations prev = LogicalOperations::NONE) {
+    return SE(UnaryExpression{op, std::move(key), std::move(v)}, prev);
+  }
+
+  constexpr auto AND = LogicalOperations::AND;
+  constexpr auto OR = LogicalOperations::OR;
+  const ComparisonOperations kOps[] = {ComparisonOperations::EQUAL,        ComparisonOperations::NOT_EQUAL,
+                                       ComparisonOperations::GREATER_THAN, ComparisonOperations::LESS_THAN,
+                                       ComparisonOperations::GREATER_EQUAL, ComparisonOperations::LESS_EQUAL};
+
+  // Same condition over the batch with `key` marked sorted and unmarked
+  void ExpectSameAsUnsorted(ColumnBatch batch, const std::string &key, const FilterCondition &condition) {
+    BatchEvaluator evaluator;
+    evaluator.initialize(condition);
+    std::vector<uint8_t> plain, sorted;
+    evaluator.evaluate(batch, plain);
+    batch.setSorted(key);
+    evaluator.evaluate(batch, sorted);
+    EXPECT_EQ(sorted, plain);
+  }
+
+  // ---------- Tests ----------
+
+  TEST(SortedColumns_Batch, IntegerRanges) {
+    // Ascending with runs of duplicates
+    std::vector<int64_t> ts, v;
+    for (int64_t i = 0; i < 300; ++i) {
+      ts.push_back(i / 3 * 2);
+      v.push_back(i % 5);
+    }
+    ColumnBatch batch;
+    batch.addColumn("ts", ColumnView::ofInt64(ts.data(), 300));
+    batch.addColumn("v", ColumnView::ofInt64(v.data(), 300));
+    for (auto op : kOps) {
+      for (int64_t c : {-5, 0, 1, 2, 77, 198, 199, 500}) {
+        ExpectSameAsUnsorted(batch, "ts", {{Cmp("ts", op, c)}});
+        ExpectSameAsUnsorted(batch, "ts", {{Cmp("v", ComparisonOperations::GREATER_THAN, int64_t{1}),
+                                            Cmp("ts", op, c, AND)}});
+        // Not required by every match: evaluated normally
+        ExpectSameAsUnsorted(batch, "ts", {{Cmp("v", ComparisonOperations::EQUAL, int64_t{1}), Cmp("ts", op, c, OR)}});
+      }
+    }
+    // Time window: both bounds narrow the interval
+    ExpectSameAsUnsorted(batch, "ts", {{Cmp("ts", ComparisonOperations::GREATER_EQUAL, int64_t{40}),
+                                        Cmp("ts", ComparisonOperations::LESS_THAN, int64_t{60}, AND),
+                                        Cmp("v", ComparisonOperations::NOT_EQUAL, int64_t{2}, AND)}});
+    ExpectSameAsUnsorted(batch, "ts", {{Cmp("ts", ComparisonOperations::GREATER_EQUAL, int64_t{60}),
+                                        Cmp("ts", ComparisonOperations::LESS_THAN, int64_t{40}, AND)}});
+  }
+
+  TEST(SortedColumns_Batch, DoubleAndStringRanges) {
+    std::vector<double> d;
+    std::string data;
+    std::vector<int32_t> offsets{0};
+    for (int i = 0; i < 100; ++i) {
+      d.push_back(0.5 * i - 10.0);
+      data += std::string(1, static_cast<char>('a' + i / 10)) + std::to_string(i % 10);
+      offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+    ColumnBatch batch;
+    batch.addColumn("d", ColumnView::ofDouble(d.data(), 100));
+    batch.addColumn("s", ColumnView::ofStrings(offsets.data(), data.data(), 100));
+    for (auto op : kOps) {
+      for (double c : {-11.0, -10.0, 0.25, 3.0, 39.5, 40.0}) ExpectSameAsUnsorted(batch, "d", {{Cmp("d", op, c)}});
+      for (const char *c : {"", "a0", "c", "c5", "j9", "z"}) {
+        ExpectSameAsUnsorted(batch, "s", {{Cmp("s", op, std::string(c))}});
+      }
+    }
+  }
+
+  TEST(SortedColumns_Batch, OnlyTheIntervalIsEvaluated) {
+    // Division by zero outside the window is never reached
+    std::vector<int64_t> ts{1, 2, 3, 4, 5}, a{1, 1, 1, 1, 1}, b{0, 1, 1, 1, 0};
+    ColumnBatch batch;
+    batch.addColumn("ts", ColumnView::ofInt64(ts.data(), 5));
+    batch.addColumn("a", ColumnView::ofInt64(a.data(), 5));
+    batch.addColumn("b", ColumnView::ofInt64(b.data(), 5));
+    BatchEvaluator evaluator;
+    evaluator.initialize({{SE(BinaryExpression{"a", ArithmeticOperations::DIVIDE, "b", ComparisonOperations::EQUAL,
+                                               int64_t{1}}),
+                           Cmp("ts", ComparisonOperations::GREATER_THAN, int64_t{1}, AND),
+                           Cmp("ts", ComparisonOperations::LESS_EQUAL, int64_t{4}, AND)}});
+    std::vector<uint8_t> mask;
+    EXPECT_THROW(evaluator.evaluate(batch, mask), ParseException);
+    batch.setSorted("ts");
+    ASSERT_NO_THROW(evaluator.evaluate(batch, mask));
+    EXPECT_EQ(mask, (std::vector<uint8_t>{0, 1, 1, 1, 0}));
+    EXPECT_EQ(evaluator.select(batch, 2), (std::vector<uint32_t>{1, 2}));
+
+    // Projections are widened back to the whole batch
+    std::vector<ProjectedColumn> out;
+    evaluator.evaluate(batch, mask, {{"ts", ArithmeticOperations::MULTIPLY, "a"}}, out);
+    ASSERT_EQ(out[0].ints.size(), 5u);
+    const ColumnView view = out[0].view();
+    EXPECT_FALSE(view.isValid(0));
+    EXPECT_TRUE(view.isValid(1));
+    EXPECT_EQ(view.int64At(3), 4);
+    EXPECT_FALSE(view.isValid(4));
+  }
+
+  TEST(SortedColumns_Batch, IgnoredWithNullsOrTypeMismatch) {
+    std::vector<int64_t> ts{1, 2, 3, 4};
+    const uint8_t validity[] = {0b1101};
+    ColumnView column = ColumnView::ofInt64(ts.data(), 4);
+    column.validity = validity;
+    column.sorted = true;
+    ColumnBatch batch;
+    batch.addColumn("ts", column);
+    BatchEvaluator evaluator;
+    std::vector<uint8_t> mask;
+    evaluator.initialize({{Cmp("ts", ComparisonOperations::GREATER_THAN, int64_t{1})}});
+    evaluator.evaluate(batch, mask);
+    EXPECT_EQ(mask, (std::vector<uint8_t>{0, 0, 1, 1}));
+    evaluator.initialize({{Cmp("ts", ComparisonOperations::GREATER_THAN, 1.0)}});
+    EXPECT_THROW(evaluator.evaluate(batch, mask), ParseException);
+    EXPECT_THROW(batch.setSorted("missing"), ParseException);
+  }
+
+  TEST(SortedColumns_Parser, RequiredClauses) {
+    const auto gt = [](LogicalOperations prev) { return Cmp("a", ComparisonOperations::GREATER_THAN, int64_t{0}, prev); };
+    const auto NONE = LogicalOperations::NONE;
+    EXPECT_EQ(LanguageParser::requiredClauses({{gt(NONE), gt(AND), gt(AND)}}), 0u);
+    EXPECT_EQ(LanguageParser::requiredClauses({{gt(NONE), gt(OR), gt(AND)}}), 2u);
+    EXPECT_EQ(LanguageParser::requiredClauses({{gt(NONE), gt(AND), gt(OR)}}), 3u);
+    EXPECT_EQ(LanguageParser::requiredClauses({{gt(NONE), gt(OR), gt(NONE), gt(AND)}}), 2u);
+    EXPECT_EQ(LanguageParser::requiredClauses({}), 0u);
+  }
+
+} // namespace
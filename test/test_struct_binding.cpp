@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "parser.h"
+#include "struct_binding.h"
+
+struct Trade {
+  int64_t qty;
+  int32_t venue;
+  double price;
+  bool is_buy;
+  std::string symbol;
+};
+EXPR_EVAL_STRUCT(Trade, EXPR_EVAL_FIELD(qty), EXPR_EVAL_FIELD(venue),
+                 EXPR_EVAL_FIELD(price), EXPR_EVAL_FIELD(is_buy),
+                 EXPR_EVAL_FIELD(symbol));
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  Trade MakeTrade() { return Trade{100, 7, 2.5, true, "ACME"}; }
+
+  std::vector<Key> ToKeys(const Trade &t) {
+    return {Key("qty", t.qty), Key("venue", static_cast<int64_t>(t.venue)),
+            Key("price", t.price), Key("is_buy", t.is_buy),
+            Key("symbol", t.symbol)};
+  }
+
+  // ---------- Tests ----------
+
+  TEST(StructBinding_Schema, DescribesFields) {
+    const auto &fields = StructSchema<Trade>::fields();
+    ASSERT_EQ(fields.size(), 5u);
+    EXPECT_EQ(fields[0].name, "qty");
+    EXPECT_EQ(fields[1].type, DataTypes::INTEGER);
+    EXPECT_EQ(fields[1].size, sizeof(int32_t));
+    EXPECT_EQ(fields[2].offset, offsetof(Trade, price));
+    EXPECT_EQ(fields[4].type, DataTypes::STRING);
+  }
+
+  TEST(StructBinding_Evaluate, MatchesKeyVectorPath) {
+    FilterCondition cond{
+        {SE(UE(ComparisonOperations::EQUAL, "symbol", std::string("ACME"))),
+         SE(UE(ComparisonOperations::EQUAL, "is_buy", true),
+            LogicalOperations::AND),
+         SE(BE("qty", ArithmeticOperations::MULTIPLY, "price",
+               ComparisonOperations::GREATER_EQUAL, 250.0),
+            LogicalOperations::AND),
+         SE(UE(ComparisonOperations::LESS_THAN, "venue",
+               static_cast<int64_t>(3)),
+            LogicalOperations::OR)}};
+    StructEvaluator<Trade> evaluator;
+    evaluator.initialize(cond);
+    auto reference = LanguageParser::parse(cond);
+
+    Trade t = MakeTrade();
+    for (int64_t qty : {50, 100}) {
+      for (int32_t venue : {1, 7}) {
+        for (const char *symbol : {"ACME", "INIT"}) {
+          t.qty = qty;
+          t.venue = venue;
+          t.symbol = symbol;
+          EXPECT_EQ(evaluator.evaluate(t), reference(ToKeys(t)))
+              << qty << " " << venue << " " << symbol;
+        }
+      }
+    }
+  }
+
+  TEST(StructBinding_Evaluate, IntegerArithmeticAcrossWidths) {
+    FilterCondition cond{{SE(BE("qty", ArithmeticOperations::ADD, "venue",
+                                ComparisonOperations::EQUAL,
+                                static_cast<int64_t>(107)))}};
+    StructEvaluator<Trade> evaluator;
+    evaluator.initialize(cond);
+    Trade t = MakeTrade();
+    EXPECT_TRUE(evaluator.evaluate(t));
+    t.venue = -7;
+    EXPECT_FALSE(evaluator.evaluate(t));
+  }
+
+  struct Tick {
+    int64_t seq;
+    char venue[8];
+  };
+
+} // namespace
+
+EXPR_EVAL_STRUCT(Tick, EXPR_EVAL_FIELD(seq), EXPR_EVAL_FIELD(venue));
+
+namespace {
+
+  TEST(StructBinding_Evaluate, InlineCharArrayStrings) {
+    const auto &fields = StructSchema<Tick>::fields();
+    EXPECT_EQ(fields[1].type, DataTypes::STRING);
+    EXPECT_TRUE(fields[1].inline_chars);
+    EXPECT_FALSE(fields[0].inline_chars);
+
+    StructEvaluator<Tick> evaluator;
+    evaluator.initialize(FilterCondition{{SE(UE(
+        ComparisonOperations::EQUAL, "venue", std::string("XNAS")))}});
+    Tick t{1, "XNAS"};
+    EXPECT_TRUE(evaluator.evaluate(t));
+    std::memcpy(t.venue, "XNASDAQ1", 8); // full width, no terminator
+    EXPECT_FALSE(evaluator.evaluate(t));
+    evaluator.initialize(FilterCondition{{SE(UE(
+        ComparisonOperations::EQUAL, "venue", std::string("XNASDAQ1")))}});
+    EXPECT_TRUE(evaluator.evaluate(t));
+  }
+
+  TEST(StructBinding_Errors, DivisionByZeroAtEvaluate) {
+    FilterCondition cond{{SE(BE("qty", ArithmeticOperations::DIVIDE, "venue",
+                                ComparisonOperations::EQUAL,
+                                static_cast<int64_t>(0)))}};
+    StructEvaluator<Trade> evaluator;
+    evaluator.initialize(cond);
+    Trade t = MakeTrade();
+    t.venue = 0;
+    EXPECT_THROW(evaluator.evaluate(t), ParseException);
+  }
+
+  TEST(StructBinding_Errors, RejectedAtInitialize) {
+    StructEvaluator<Trade> evaluator;
+    // unknown field
+    EXPECT_THROW(evaluator.initialize(FilterCondition{{SE(UE(
+                     ComparisonOperations::EQUAL, "missing", true))}}),
+                 ParseException);
+    // type mismatch
+    EXPECT_THROW(evaluator.initialize(FilterCondition{{SE(UE(
+                     ComparisonOperations::EQUAL, "qty", std::string("1")))}}),
+                 ParseException);
+    // ordering on bool
+    EXPECT_THROW(evaluator.initialize(FilterCondition{{SE(UE(
+                     ComparisonOperations::GREATER_THAN, "is_buy", false))}}),
+                 ParseException);
+    // arithmetic on strings
+    EXPECT_THROW(evaluator.initialize(FilterCondition{{SE(
+                     BE("symbol", ArithmeticOperations::ADD, "qty",
+                        ComparisonOperations::EQUAL, static_cast<int64_t>(0)))}}),
+                 ParseException);
+  }
+
+} // namespace
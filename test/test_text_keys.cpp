@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+
+namespace {
+
+  UnaryExpression UE(ComparisonOperations op, std::string key, ValueType val) {
+    return UnaryExpression{op, std::move(key), std::move(val)};
+  }
+
+  BinaryExpression BE(std::string left_key, ArithmeticOperations aop,
+                      std::string right_key, ComparisonOperations cop,
+                      ValueType val) {
+    return BinaryExpression{std::move(left_key), aop, std::move(right_key), cop,
+                            std::move(val)};
+  }
+
+  SubExpression SE(UnaryExpression ue,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(ue)}, prev};
+  }
+
+  SubExpression SE(BinaryExpression be,
+                   LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{Expression{std::move(be)}, prev};
+  }
+
+  bool Eval(const FilterCondition &cond, const std::vector<Key> &keys) {
+    return LanguageParser::parse(cond)(keys);
+  }
+
+  // ---------- Tests ----------
+
+  TEST(TextKeys_Key, ParsesWholeTextOnly) {
+    ValueType v;
+    EXPECT_TRUE(Key::text("a", "42").parseNumber(DataTypes::INTEGER, v));
+    EXPECT_EQ(std::get<int64_t>(v), 42);
+    EXPECT_TRUE(Key::text("a", "-2.5e1").parseNumber(DataTypes::DOUBLE, v));
+    EXPECT_DOUBLE_EQ(std::get<double>(v), -25.0);
+    EXPECT_FALSE(Key::text("a", "2.5").parseNumber(DataTypes::INTEGER, v));
+    EXPECT_FALSE(Key::text("a", "12ab").parseNumber(DataTypes::DOUBLE, v));
+    EXPECT_FALSE(Key::text("a", "").parseNumber(DataTypes::INTEGER, v));
+    EXPECT_FALSE(Key::text("a", " 1").parseNumber(DataTypes::INTEGER, v));
+    EXPECT_FALSE(Key::text("a", "99999999999999999999")
+                     .parseNumber(DataTypes::INTEGER, v)); // out of range
+  }
+
+  TEST(TextKeys_Key, CachesParsedNumber) {
+    const Key key = Key::text("a", "7");
+    EXPECT_TRUE(key.isText());
+    ValueType v;
+    ASSERT_TRUE(key.parseNumber(DataTypes::INTEGER, v));
+    ASSERT_TRUE(key.parseNumber(DataTypes::DOUBLE, v)); // parsed for double
+    EXPECT_DOUBLE_EQ(std::get<double>(v), 7.0);
+    ASSERT_TRUE(key.parseAnyNumber(v)); // integral text stays an integer
+    EXPECT_EQ(std::get<int64_t>(v), 7);
+    // Both results stay cached when clauses alternate
+    ASSERT_TRUE(key.parseNumber(DataTypes::DOUBLE, v));
+    EXPECT_DOUBLE_EQ(std::get<double>(v), 7.0);
+    ASSERT_TRUE(key.parseNumber(DataTypes::INTEGER, v));
+    EXPECT_EQ(std::get<int64_t>(v), 7);
+    EXPECT_EQ(std::get<std::string>(key.getValue()), "7");
+
+    const Key real = Key::text("r", "2.5");
+    EXPECT_FALSE(real.parseNumber(DataTypes::INTEGER, v));
+    ASSERT_TRUE(real.parseAnyNumber(v));
+    EXPECT_DOUBLE_EQ(std::get<double>(v), 2.5);
+    EXPECT_FALSE(real.parseNumber(DataTypes::INTEGER, v));
+
+    Key plain("b", static_cast<int64_t>(1));
+    EXPECT_FALSE(plain.isText());
+    EXPECT_FALSE(plain.parseNumber(DataTypes::INTEGER, v));
+    Key reset = Key::text("c", "1");
+    reset.setValue(std::string("1"));
+    EXPECT_FALSE(reset.isText());
+  }
+
+  TEST(TextKeys_Evaluate, NumericClausesConvertOnDemand) {
+    const std::vector<Key> keys{Key::text("qty", "150"),
+                                Key::text("price", "2.5"),
+                                Key::text("sym", "ACME")};
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::GREATER_THAN, "qty",
+                             static_cast<int64_t>(100)))}},
+                     keys));
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::LESS_EQUAL, "qty", 150.0))}},
+                     keys));
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::EQUAL, "sym",
+                             std::string("ACME")))}},
+                     keys));
+    // compared as a string against a string constant
+    EXPECT_TRUE(Eval({{SE(UE(ComparisonOperations::EQUAL, "qty",
+                             std::string("150")))}},
+                     keys));
+    // int text * double text -> double arithmetic
+    EXPECT_TRUE(Eval({{SE(BE("qty", ArithmeticOperations::MULTIPLY, "price",
+                             ComparisonOperations::EQUAL, 375.0))}},
+                     keys));
+    // int text + int text -> integer arithmetic
+    EXPECT_TRUE(Eval({{SE(BE("qty", ArithmeticOperations::ADD, "qty",
+                             ComparisonOperations::EQUAL,
+                             static_cast<int64_t>(300)))}},
+                     keys));
+  }
+
+  TEST(TextKeys_Evaluate, MatchesTypedKeys) {
+    FilterCondition cond{
+        {SE(UE(ComparisonOperations::GREATER_EQUAL, "a",
+               static_cast<int64_t>(10))),
+         SE(UE(ComparisonOperations::LESS_THAN, "b", 3.0),
+            LogicalOperations::AND),
+         SE(BE("a", ArithmeticOperations::DIVIDE, "b",
+               ComparisonOperations::GREATER_THAN, 5.0),
+            LogicalOperations::OR)}};
+    auto fn = LanguageParser::parse(cond);
+    for (int64_t a : {5, 10, 40}) {
+      for (double b : {1.5, 4.0}) {
+        std::vector<Key> typed{Key("a", a), Key("b", b)};
+        std::vector<Key> text{Key::text("a", std::to_string(a)),
+                              Key::text("b", std::to_string(b))};
+        EXPECT_EQ(fn(text), fn(typed)) << a << " " << b;
+      }
+    }
+  }
+
+  TEST(TextKeys_Errors, NonNumericTextThrows) {
+    const std::vector<Key> keys{Key::text("a", "abc"), Key::text("f", "2.5")};
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "a",
+                              static_cast<int64_t>(1)))}},
+                      keys),
+                 ParseException);
+    // 2.5 is not an integer
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "f",
+                              static_cast<int64_t>(2)))}},
+                      keys),
+                 ParseException);
+    EXPECT_THROW(Eval({{SE(BE("a", ArithmeticOperations::ADD, "f",
+                              ComparisonOperations::EQUAL, 0.0))}},
+                      keys),
+                 ParseException);
+    // bool constants never convert
+    EXPECT_THROW(Eval({{SE(UE(ComparisonOperations::EQUAL, "a", true))}}, keys),
+                 ParseException);
+  }
+
+} // namespace
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "batch_evaluator.h"
+#include "clause_stats.h"
+#include "column_batch.h"
+#include "enums.h"
+#include "filter_structs.h"
+#include "key.h"
+#include "parser.h"
+#include "struct_binding.h"
+
+struct Signals {
+  int64_t s0, s1, s2, s3, s4, s5, s6, s7;
+};
+EXPR_EVAL_STRUCT(Signals, EXPR_EVAL_FIELD(s0), EXPR_EVAL_FIELD(s1), EXPR_EVAL_FIELD(s2),
+                 EXPR_EVAL_FIELD(s3), EXPR_EVAL_FIELD(s4), EXPR_EVAL_FIELD(s5),
+                 EXPR_EVAL_FIELD(s6), EXPR_EVAL_FIELD(s7));
+
+namespace {
+
+  SubExpression SE(Expression e, LogicalOperations prev = LogicalOperations::NONE) {
+    return SubExpression{std::move(e), prev};
+  }
+
+  // Signal i fires when key "s<i>" is positive
+  FilterCondition Fires(int i) {
+    return {{SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "s" + std::to_string(i), int64_t{0}})}};
+  }
+
+  ThresholdExpression AtLeast(std::size_t k, int n) {
+    ThresholdExpression t{k, {}};
+    for (int i = 0; i < n; ++i) t.children.push_back(Fires(i));
+    return t;
+  }
+
+  FilterCondition Cond(ThresholdExpression t) { return {{SE(std::move(t))}}; }
+
+  std::vector<Key> Record(uint32_t bits, int n = 8) {
+    std::vector<Key> keys;
+    for (int i = 0; i < n; ++i) keys.emplace_back("s" + std::to_string(i), static_cast<int64_t>((bits >> i) & 1));
+    return keys;
+  }
+
+  int PopCount(uint32_t bits) {
+    int count = 0;
+    for (; bits; bits &= bits - 1) ++count;
+    return count;
+  }
+
+  // ---------- Tests ----------
+
+  TEST(ThresholdPredicates_Row, EveryCombinationOfEightSignals) {
+    for (std::size_t k = 1; k <= 8; ++k) {
+      const auto predicate = LanguageParser::parse(Cond(AtLeast(k, 8)));
+      for (uint32_t bits = 0; bits < 256; ++bits) {
+        EXPECT_EQ(predicate(Record(bits)), PopCount(bits) >= static_cast<int>(k)) << k << " of " << bits;
+      }
+    }
+  }
+
+  TEST(ThresholdPredicates_Row, StopsOnceDecided) {
+    // Children after the decision are not evaluated: s2 is missing
+    std::vector<Key> two_fire{Key("s0", int64_t{1}), Key("s1", int64_t{1})};
+    EXPECT_TRUE(LanguageParser::parse(Cond(AtLeast(2, 3)))(two_fire));
+    std::vector<Key> two_fail{Key("s0", int64_t{0}), Key("s1", int64_t{0})};
+    EXPECT_FALSE(LanguageParser::parse(Cond(AtLeast(2, 3)))(two_fail));
+    std::vector<Key> undecided{Key("s0", int64_t{1}), Key("s1", int64_t{0})};
+    EXPECT_THROW(LanguageParser::parse(Cond(AtLeast(2, 3)))(undecided), ParseException);
+  }
+
+  TEST(ThresholdPredicates_Row, NestedAndCombined) {
+    // (2 of {s0, s1, (1 of {s2, s3})}) AND s4 > 0
+    ThresholdExpression inner{1, {Fires(2), Fires(3)}};
+    ThresholdExpression outer{2, {Fires(0), Fires(1), Cond(inner)}};
+    FilterCondition cond{{SE(outer),
+                          SE(UnaryExpression{ComparisonOperations::GREATER_THAN, "s4", int64_t{0}},
+                             LogicalOperations::AND)}};
+    const auto predicate = LanguageParser::parse(cond);
+    for (uint32_t bits = 0; bits < 32; ++bits) {
+      const int votes = (bits & 1) + ((bits >> 1) & 1) + (((bits >> 2) & 3) != 0);
+      EXPECT_EQ(predicate(Record(bits, 5)), votes >= 2 && (bits & 16)) << bits;
+    }
+  }
+
+  TEST(ThresholdPredicates_Errors, MinCountOutOfRange) {
+    EXPECT_THROW(LanguageParser::parse(Cond(AtLeast(0, 3))), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Cond(AtLeast(4, 3))), ParseException);
+    EXPECT_THROW(LanguageParser::parse(Cond(ThresholdExpression{1, {}})), ParseException);
+
+    BatchEvaluator batch; // rejected by initialize, before any batch is seen
+    EXPECT_THROW(batch.initialize(Cond(AtLeast(4, 3))), ParseException);
+  }
+
+  TEST(ThresholdPredicates_Batch, MatchesRowPath) {
+    std::vector<std::vector<int64_t>> columns(8, std::vector<int64_t>(256));
+    for (uint32_t bits = 0; bits < 256; ++bits) {
+      for (int i = 0; i < 8; ++i) columns[i][bits] = (bits >> i) & 1;
+    }
+    const uint8_t validity[32] = {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                                  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f};
+    ColumnBatch batch;
+    for (int i = 0; i < 8; ++i) {
+      ColumnView column = ColumnView::ofInt64(columns[i].data(), 256);
+      if (i == 7) column.validity = validity; // rows 0 and 255 null in s7
+      batch.addColumn("s" + std::to_string(i), column);
+    }
+    for (std::size_t k = 1; k <= 8; ++k) {
+      BatchEvaluator evaluator;
+      evaluator.initialize(Cond(AtLeast(k, 8)));
+      std::vector<uint8_t> mask;
+      evaluator.evaluate(batch, mask);
+      for (uint32_t bits = 0; bits < 256; ++bits) {
+        const int fired = PopCount(bits) - (bits == 255 ? 1 : 0); // a null never fires
+        EXPECT_EQ(mask[bits] != 0, fired >= static_cast<int>(k)) << k << " of " << bits;
+      }
+    }
+  }
+
+  TEST(ThresholdPredicates_Batch, DecidedRowsSkipChildErrors) {
+    // Child 2 divides by zero only on rows the first two children decide
+    std::vector<int64_t> a{1, 1, 0}, b{1, 0, 0}, zero{0, 5, 5};
+    ColumnBatch batch;
+    batch.addColumn("s0", ColumnView::ofInt64(a.data(), 3));
+    batch.addColumn("s1", ColumnView::ofInt64(b.data(), 3));
+    batch.addColumn("z", ColumnView::ofInt64(zero.data(), 3));
+    const FilterCondition divide{{SE(BinaryExpression{"s0", ArithmeticOperations::DIVIDE, "z",
+                                                      ComparisonOperations::EQUAL, int64_t{0}})}};
+    BatchEvaluator evaluator;
+    evaluator.initialize(Cond(ThresholdExpression{2, {Fires(0), Fires(1), divide}}));
+    std::vector<uint8_t> mask;
+    ASSERT_NO_THROW(evaluator.evaluate(batch, mask));
+    EXPECT_EQ(mask, (std::vector<uint8_t>{1, 1, 0}));
+
+    zero[1] = 0; // row 1 is still open when the division runs
+    EXPECT_THROW(evaluator.evaluate(batch, mask), ParseException);
+  }
+
+  TEST(ThresholdPredicates_Struct, MatchesRowPath) {
+    for (std::size_t k : {1u, 3u, 8u}) {
+      StructEvaluator<Signals> evaluator;
+      evaluator.initialize(Cond(AtLeast(k, 8)));
+      for (uint32_t bits = 0; bits < 256; ++bits) {
+        Signals s{};
+        int64_t *fields[] = {&s.s0, &s.s1, &s.s2, &s.s3, &s.s4, &s.s5, &s.s6, &s.s7};
+        for (int i = 0; i < 8; ++i) *fields[i] = (bits >> i) & 1;
+        EXPECT_EQ(evaluator.evaluate(s), PopCount(bits) >= static_cast<int>(k)) << k << " of " << bits;
+      }
+    }
+  }
+
+  TEST(ThresholdPredicates_Stats, FingerprintCoversChildren) {
+    EXPECT_NE(conditionFingerprint(Cond(AtLeast(2, 3))), conditionFingerprint(Cond(AtLeast(3, 3))));
+    EXPECT_NE(conditionFingerprint(Cond(AtLeast(2, 3))), conditionFingerprint(Cond(AtLeast(2, 4))));
+    ThresholdExpression swapped{2, {Fires(1), Fires(0), Fires(2)}};
+    EXPECT_NE(conditionFingerprint(Cond(AtLeast(2, 3))), conditionFingerprint(Cond(swapped)));
+  }
+
+} // namespace